@@ -1,613 +1,1923 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "BoneControllers/AnimNode_CCDIK.h"
-#include "Animation/AnimTypes.h"
-#include "AnimationRuntime.h"
-#include "DrawDebugHelpers.h"
-#include "Animation/AnimInstanceProxy.h"
-
-/////////////////////////////////////////////////////
-// AnimNode_CCDIK
-// Implementation of the CCDIK IK Algorithm
-
-FAnimNode_CCDIK::FAnimNode_CCDIK()
-	: EffectorLocation(FVector::ZeroVector)
-	, EffectorLocationSpace(BCS_ComponentSpace)
-	, Precision(1.f)
-	, MaxIterations(10)
-	, bStartFromTail(true)
-	, bEnableRotationLimit(false)
-{
-}
-
-//FAnimNode_CCDIK::FAnimNode_CCDIK(FVector _EffectorLocation, FBoneIndexType _TipBone, FBoneIndexType _RootBone)
-//{
-//	EffectorLocation = _EffectorLocation;
-//	TipBone = _TipBone;
-//	RootBone = _RootBone;
-//	TArray<FCCDIKChainLink> IKChain = CreateIKChain(TipBone, RootBone);
-//}
-
-FVector FAnimNode_CCDIK::GetCurrentLocation(FCSPose<FCompactPose>& MeshBases, const FCompactPoseBoneIndex& BoneIndex)
-{
-	return MeshBases.GetComponentSpaceTransform(BoneIndex).GetLocation();
-}
-
-FTransform FAnimNode_CCDIK::GetTargetTransform(const FTransform& InComponentTransform, FCSPose<FCompactPose>& MeshBases, FBoneSocketTarget& InTarget, EBoneControlSpace Space, const FVector& InOffset)
-{
-	FTransform OutTransform;
-	if (Space == BCS_BoneSpace)
-	{
-		OutTransform = InTarget.GetTargetTransform(InOffset, MeshBases, InComponentTransform);
-	}
-	else
-	{
-		// parent bone space still goes through this way
-		// if your target is socket, it will try find parents of joint that socket belongs to
-		OutTransform.SetLocation(InOffset);
-		FAnimationRuntime::ConvertBoneSpaceTransformToCS(InComponentTransform, MeshBases, OutTransform, InTarget.GetCompactPoseBoneIndex(), Space);
-	}
-
-	return OutTransform;
-}
-
-//FUNCTION CREATED BY ME
-void FAnimNode_CCDIK::PreUpdate(const UAnimInstance* InAnimInstance)
-{
-	m_MyWorld = InAnimInstance->GetSkelMeshComponent()->GetWorld();
-	m_SkelComp = InAnimInstance->GetSkelMeshComponent();
-
-	if (!m_SkelComp || !m_SkelComp->GetWorld())
-	{
-		return;
-	}
-
-	// Determine the bones that need to be updated (only do this once)
-	if (!m_UpdateBoneMapCrated)
-	{
-		// Then for example, here’s one way to get references to all bones in the PhysicsAsset (ragdoll structure) by name.  You don’t necessarily need to grab from the PhysicsAsset, but it could be one way to get a grasp of the whole body.  
-		//Then you could essentially use the PhsicsAsset to define all the bones in the body that your full body IK algorithm might be interested in.
-		for (int32 iBone = 0; iBone < InAnimInstance->GetSkelMeshComponent()->GetPhysicsAsset()->SkeletalBodySetups.Num(); iBone++)
-		{
-			int32 PhysBoneIndex = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(InAnimInstance->GetSkelMeshComponent()->GetPhysicsAsset()->SkeletalBodySetups[iBone]->BoneName);
-			if (PhysBoneIndex != INDEX_NONE)
-			{
-				m_InRagdollBones.Add(PhysBoneIndex);
-			}
-		}
-		m_InRagdollBones.Sort();
-
-		// Additionally, you could also note specific bones of interest for whatever reason
-		FName spine_02("spine_02");
-		FName hand_r("hand_r");
-		FName clavicle_r("clavicle_r");
-		FName thigh_l("thigh_l");
-		FName foot_l("foot_l");
-
-		{
-			TArray<FName> BoneNames;
-			m_SkelComp->GetBoneNames(BoneNames);
-			
-
-			m_RightClavicleBone = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(clavicle_r);
-			m_Spine02Bone = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(spine_02);
-			m_RightHandBone = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(hand_r);
-			m_LeftThighBone = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(thigh_l);
-			m_LeftFootBone = m_SkelComp->SkeletalMesh->RefSkeleton.FindBoneIndex(foot_l);
-		}
-		m_UpdateBoneMapCrated = true;
-	}
-
-}
-
-////FUNCTION CREATED BY ME
-//void FAnimNode_CCDIK::GetWorldSpaceTransforms(TArray<FBoneTransform>& OutBoneTransforms)
-//{
-//	const FTransform CompWorldSpaceTM = m_ComponentSpacePoseContext->AnimInstanceProxy->GetComponentTransform();
-//
-//	OutBoneTransforms.AddUninitialized(m_SkelComp->Bodies.Num());
-//
-//	for (int32 iJoint = 0; iJoint < m_SkelComp->Bodies.Num(); iJoint++)
-//	{
-//		// Get the UE part transforms from skeleton here as in USkeletalMeshComponent::UpdateKinematicBonesToAnim (just locally)
-//		FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(m_CachedBoneIndicesForCurrentLOD[iJoint]);
-//		const FTransform& ComponentSpaceTM = m_ComponentSpacePoseContext->Pose.GetComponentSpaceTransform(BoneIndex);
-//		const FTransform WorldSpaceBoneTM = ComponentSpaceTM * CompWorldSpaceTM;
-//
-//		m_WorldSpaceBoneTM[iJoint] = WorldSpaceBoneTM;
-//		OutBoneTransforms[iJoint] = FBoneTransform(BoneIndex, WorldSpaceBoneTM);
-//	}
-//}
-
-//FUNCTION CREATED BY ME
-void FAnimNode_CCDIK::GetComponentSpaceTransforms()
-{
-	m_OutBoneTransforms->AddUninitialized(m_SkelComp->Bodies.Num());
-
-	for (int32 iJoint = 0; iJoint < m_SkelComp->Bodies.Num(); iJoint++)
-	{
-		// Get the UE part transforms from skeleton here as in USkeletalMeshComponent::UpdateKinematicBonesToAnim (just locally)
-
-		FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(m_CachedBoneIndicesForCurrentLOD[iJoint]);
-		//FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(iJoint);
-		const FTransform& ComponentSpaceTM = m_ComponentSpacePoseContext->Pose.GetComponentSpaceTransform(BoneIndex);
-		ComponentSpaceTM.DiagnosticCheck_IsValid();
-
-		(*m_OutBoneTransforms)[iJoint] = FBoneTransform(BoneIndex, ComponentSpaceTM);
-	}
-}
-
-//FUNCTION CREATED BY ME
-TArray<FCCDIKChainLink> FAnimNode_CCDIK::CreateIKChain(FBoneIndexType TipLink, FBoneIndexType RootLink)
-{
-	const FBoneContainer& BoneContainer = m_ComponentSpacePoseContext->Pose.GetPose().GetBoneContainer();
-
-	// Gather all bone indices between root and tip.
-	TArray<FCompactPoseBoneIndex> BoneIndices;
-
-	{	//Rootbone and TipBone index declaration
-		const FCompactPoseBoneIndex RootIndex = FCompactPoseBoneIndex(RootLink);
-		FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(TipLink);
-		//Fill the array by inserting one by one the indices of the bones in the 0 position and moving the previous ones to the right, until you reach the rootbone.
-		do
-		{
-			BoneIndices.Insert(BoneIndex, 0);
-			BoneIndex = m_ComponentSpacePoseContext->Pose.GetPose().GetParentBoneIndex(BoneIndex);
-		} while (BoneIndex != RootIndex);
-		BoneIndices.Insert(BoneIndex, 0);
-	}
-
-	//Gather transforms
-	int32 const NumTransforms = BoneIndices.Num();
-
-	// Gather chain links and initialize Chain array. These are non zero length bones.
-	TArray<FCCDIKChainLink> Chain;
-	Chain.Reserve(NumTransforms);
-
-	//Start filling the arrays with Root Bone
-	{
-		const FCompactPoseBoneIndex& RootBoneIndex = BoneIndices[0];
-		const FTransform& LocalTransform = m_ComponentSpacePoseContext->Pose.GetLocalSpaceTransform(RootBoneIndex);
-		const FTransform& BoneCSTransform = m_ComponentSpacePoseContext->Pose.GetComponentSpaceTransform(RootBoneIndex);
-
-		//Add Rootbone to OutBoneTransforms array and Chain array in position 0
-		Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, 0, RootBoneIndex));
-	}
-
-	// Go through remaining transforms
-	for (int32 TransformIndex = 1; TransformIndex < NumTransforms; TransformIndex++)
-	{
-		//Get the Bone Index
-		const FCompactPoseBoneIndex& BoneIndex = BoneIndices[TransformIndex];
-
-		//Get CS and Local Transforms for that BoneIndex
-		const FTransform& LocalTransform = m_ComponentSpacePoseContext->Pose.GetLocalSpaceTransform(BoneIndex);
-		const FTransform& BoneCSTransform = m_ComponentSpacePoseContext->Pose.GetComponentSpaceTransform(BoneIndex);
-		FVector const BoneCSPosition = BoneCSTransform.GetLocation();
-
-		Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, TransformIndex, BoneIndex));
-	}
-
-	IKChainList.Add(Chain);
-
-	return Chain;
-}
-
-TArray<float> FAnimNode_CCDIK::CreateRotationLimitArray(int32 Size)
-{
-	TArray<float> RotationLimitArray;
-	RotationLimitArray.Reserve(Size);
-	for (int32 i = 0; i < Size; i++)
-	{
-		RotationLimitArray.Add(50.f);
-	}
-	return RotationLimitArray;
-
-}
-
-
-
-//FUNCTION CREATED BY ME
-int32 FAnimNode_CCDIK::CheckIfJointIsRelevantToChain(TArray<FCCDIKChainLink> CurrentChain, int32 CurrentBoneIndex, int32 CurrentChainIndex)
-{
-	int32 SizeOfChain = CurrentChain.Num();
-	for (int32 iLink = 0; iLink < SizeOfChain; iLink++)
-	{
-		if (CurrentBoneIndex == CurrentChain[iLink].BoneIndex.GetInt())
-		{
-			return CurrentChainIndex;
-		}
-	}
-	return -1;
-}
-
-
-//FUNCTION CREATED BY ME
-int32 FAnimNode_CCDIK::GetIndexFromRelevantChain(TArray<FCCDIKChainLink> CurrentChain, int32 CurrentBoneIndex)
-{
-	int32 SizeOfChain = CurrentChain.Num();
-	for (int32 iLink = 0; iLink < SizeOfChain; iLink++)
-	{
-		if (CurrentBoneIndex == CurrentChain[iLink].BoneIndex.GetInt())
-		{
-			return iLink;
-		}
-	}
-	return -1;
-}
-
-//FUNCTION CREATED BY ME
-int32 FAnimNode_CCDIK::GetIndexPosFromOutBoneTransforms(TArray<FBoneTransform> OutBoneTransforms, int32 CurrentBoneIndex)
-{
-	int32 SizeOfChain = OutBoneTransforms.Num();
-	for (int32 iIndexPos = 0; iIndexPos < SizeOfChain; iIndexPos++)
-	{
-		if (CurrentBoneIndex == OutBoneTransforms[iIndexPos].BoneIndex.GetInt())
-		{
-			return iIndexPos;
-		}
-	}
-	return -1;
-}
-
-
-//FUNCTION CREATED BY ME
-//CCDIK UPDATE
-//void FAnimNode_CCDIK::ApplyIKSolveBatch(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
-void FAnimNode_CCDIK::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
-{
-	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(EvaluateSkeletalControl_AnyThread)
-	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
-
-	// Store references to the context and out transforms
-	m_ComponentSpacePoseContext = &Output;
-	m_OutBoneTransforms = &OutBoneTransforms;
-
-	//If the LOD has changed, re-cache link bones
-	if (m_SkelComp->PredictedLODLevel != m_LastBoneIndicesCacheLOD)
-	{
-		const int32 NumBodies = m_SkelComp->Bodies.Num();
-		if (m_LastBoneIndicesCacheLOD == -1)
-		{
-			m_CachedBoneIndicesForCurrentLOD.SetNum(NumBodies);
-		}
-
-		m_LastBoneIndicesCacheLOD = m_SkelComp->PredictedLODLevel;
-
-		const auto& BoneIndices = BoneContainer.GetBoneIndicesArray();
-		for (int32 iLinkOnCBR = 0; iLinkOnCBR < NumBodies; iLinkOnCBR++)
-		{
-			FBodyInstance* BodyInst = m_SkelComp->Bodies[iLinkOnCBR];
-			const int32 BoneIndex = BodyInst->InstanceBoneIndex;
-			m_CachedBoneIndicesForCurrentLOD[iLinkOnCBR] = BoneIndices.Find(BoneIndex);
-		}
-	}
-
-	GetComponentSpaceTransforms();
-
-	int32 NumBones = m_CachedBoneIndicesForCurrentLOD.Num();
-	//int32 NumBones = BoneContainer.GetNumBones();
-
-
-	// Update EffectorLocation if it is based off a bone position
-	FTransform CSEffectorTransform = GetTargetTransform(Output.AnimInstanceProxy->GetComponentTransform(), Output.Pose, EffectorTarget, EffectorLocationSpace, EffectorLocation);
-	FVector const CSEffectorLocation = CSEffectorTransform.GetLocation();
-
-	// Update EffectorLocation2 if it is based off a bone position
-	FTransform CSEffectorTransform2 = GetTargetTransform(Output.AnimInstanceProxy->GetComponentTransform(), Output.Pose, EffectorTarget2, EffectorLocationSpace2, EffectorLocation2);
-	FVector const CSEffectorLocation2 = CSEffectorTransform2.GetLocation();
-
-	TArray<FCCDIKChainLink> IKChain1 = CreateIKChain(m_RightHandBone, m_RightClavicleBone);
-	TArray<FCCDIKChainLink> IKChain2 = CreateIKChain(m_LeftFootBone, m_LeftThighBone);
-	TArray<float> RotationLimitArray = CreateRotationLimitArray(IKChain1.Num());
-	TArray<float> RotationLimitArray2 = CreateRotationLimitArray(IKChain2.Num());
-	
-	int32 NumIKActions = IKChainList.Num();
-
-	bool bBoneLocationUpdated = false;
-
-	for (int32 iBone = 0; iBone < NumBones; iBone++)
-	{
-		for (int32 iChain = 0; iChain < NumIKActions; iChain++)
-		{
-			int32 BoneIsInChain = CheckIfJointIsRelevantToChain(IKChainList[iChain], m_CachedBoneIndicesForCurrentLOD[iBone], iChain);
-
-			//If the bone is in the current chain, apply IK solver for that bone in that chain
-			if (BoneIsInChain == 0)
-			{
-				//Here we call the CCDIK solver defined in CCDIK.cpp
-				bBoneLocationUpdated = AnimationCore::SolveCCDIK(IKChainList[iChain], CSEffectorLocation, Precision, MaxIterations, bEnableRotationLimit, RotationLimitArray, m_CachedBoneIndicesForCurrentLOD[iBone]);
-			}
-
-			if (BoneIsInChain == 1)
-			{
-				//Here we call the CCDIK solver defined in CCDIK.cpp
-				bBoneLocationUpdated = AnimationCore::SolveCCDIK(IKChainList[iChain], CSEffectorLocation2, Precision, MaxIterations, bEnableRotationLimit, RotationLimitArray2, m_CachedBoneIndicesForCurrentLOD[iBone]);
-			}
-		}
-	}
-
-	if (bBoneLocationUpdated)
-	{
-		for (int32 iChain = 0; iChain < NumIKActions; iChain++)
-		{
-			int32 NumChainLinks = IKChainList[iChain].Num();
-
-			// First step: update bone transform positions from chain links.
-			for (int32 LinkIndex = 0; LinkIndex < NumChainLinks; LinkIndex++)
-			{
-				FCCDIKChainLink const& ChainLink = IKChainList[iChain][LinkIndex];
-				int32 CurrentBoneIndex = ChainLink.BoneIndex.GetInt();
-				//Store OutBoneTransforms with new current link transform
-				int32 IndexPos = GetIndexPosFromOutBoneTransforms(OutBoneTransforms, CurrentBoneIndex);
-				OutBoneTransforms[IndexPos].Transform = ChainLink.Transform;
-
-			}
-		}
-
-#if WITH_EDITOR
-		DebugLines.Reset(OutBoneTransforms.Num());
-		DebugLines.AddUninitialized(OutBoneTransforms.Num());
-		for (int32 Index = 0; Index < OutBoneTransforms.Num(); ++Index)
-		{
-			DebugLines[Index] = OutBoneTransforms[Index].Transform.GetLocation();
-		}
-#endif // WITH_EDITOR
-
-	}
-}
-
-
-bool FAnimNode_CCDIK::IsValidToEvaluate(const USkeleton* Skeleton, const FBoneContainer& RequiredBones)
-{
-	//if (EffectorLocationSpace == BCS_ParentBoneSpace || EffectorLocationSpace == BCS_BoneSpace)
-	//{
-	//	if (!EffectorTarget.IsValidToEvaluate(RequiredBones))
-	//	{
-	//		return false;
-	//	}
-	//}
-
-	//// Allow evaluation if all parameters are initialized and TipBone is child of RootBone
-	//return
-	//	(
-	//		TipBone.IsValidToEvaluate(RequiredBones)
-	//		&& RootBone.IsValidToEvaluate(RequiredBones)
-	//		&& Precision > 0
-	//		&& RequiredBones.BoneIsChildOf(TipBone.BoneIndex, RootBone.BoneIndex)
-	//		);
-	return true;
-}
-
-
-
-#if WITH_EDITOR
-void FAnimNode_CCDIK::ResizeRotationLimitPerJoints(int32 NewSize)
-{
-	if (NewSize == 0)
-	{
-		RotationLimitPerJoints.Reset();
-	}
-	else if (RotationLimitPerJoints.Num() != NewSize)
-	{
-		int32 StartIndex = RotationLimitPerJoints.Num();
-		RotationLimitPerJoints.SetNum(NewSize);
-		for (int32 Index = StartIndex; Index < RotationLimitPerJoints.Num(); ++Index)
-		{
-			RotationLimitPerJoints[Index] = 30.f;
-		}
-	}
-}
-#endif 
-
-void FAnimNode_CCDIK::InitializeBoneReferences(const FBoneContainer& RequiredBones)
-{
-	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(InitializeBoneReferences)
-	TipBone.Initialize(RequiredBones);
-	RootBone.Initialize(RequiredBones);
-	EffectorTarget.InitializeBoneReferences(RequiredBones);
-}
-
-void FAnimNode_CCDIK::GatherDebugData(FNodeDebugData& DebugData)
-{
-	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(GatherDebugData)
-	FString DebugLine = DebugData.GetNodeName(this);
-
-	DebugData.AddDebugItem(DebugLine);
-	ComponentPose.GatherDebugData(DebugData);
-}
-
-
-//FUNCTION CREATED BY ME
-void FAnimNode_CCDIK::DrawLine(FVector P1_in, FVector P2_in, FColor color, float thicknessMult)
-{
-	static float thickness = 3.0f;
-
-	float useThickness = thickness * thicknessMult;
-
-	UWorld* pWorld = m_MyWorld;
-
-	FVector P1 = P1_in;
-
-	FVector P2 = P2_in;
-
-	TFunction<void()> funcLambda =
-
-		[pWorld, P1, P2, color, useThickness]() {
-
-		DrawDebugLine(pWorld, P1, P2, color, false, -1.0f, 0, useThickness);
-
-	};
-
-	FFunctionGraphTask::CreateAndDispatchWhenReady(funcLambda, TStatId(), NULL, ENamedThreads::GameThread);
-}
-
-//FUNCTION CREATED BY ME
-void FAnimNode_CCDIK::printsmth()
-{
-	if (GEngine) 
-	{
-		FString Stringg = FString::Printf(TEXT("World delta for current frame equals %f"), 0);
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Yellow, Stringg);
-	}
-}
-
-
-
-//void FAnimNode_CCDIK::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
-//{
-//					// Store references to the context and out transforms
-//					m_ComponentSpacePoseContext = &Output;
-//					m_OutBoneTransforms = &OutBoneTransforms;
-//					// If the LOD has changed, re-cache link bones
-//					if (m_SkelComp->PredictedLODLevel != m_LastBoneIndicesCacheLOD)
-//					{
-//						const int32 NumBodies = m_SkelComp->Bodies.Num();
-//						if (m_LastBoneIndicesCacheLOD == -1) 
-//						{
-//							m_CachedBoneIndicesForCurrentLOD.SetNum(NumBodies);
-//						}
-//			
-//						m_LastBoneIndicesCacheLOD = m_SkelComp->PredictedLODLevel;
-//						const FBoneContainer& BoneContainer = m_ComponentSpacePoseContext->Pose.GetPose().GetBoneContainer();
-//						const auto& BoneIndices = BoneContainer.GetBoneIndicesArray();
-//						for (int32 iLinkOnCBR = 0; iLinkOnCBR < NumBodies; iLinkOnCBR++)
-//						{
-//							FBodyInstance* BodyInst = m_SkelComp->Bodies[iLinkOnCBR];
-//							const int32 BoneIndex = BodyInst->InstanceBoneIndex;
-//							m_CachedBoneIndicesForCurrentLOD[iLinkOnCBR] = BoneIndices.Find(BoneIndex);
-//						}
-//					}
-//
-//	//The purpose of the following operations up to the invocation of the solver, is to obtain a copy of the string of bones to be worked on, 
-//	//storing all its transforms in an array called Chain. Likewise, the transforms in component space are stored in another array called OutBoneTransforms.
-//
-//	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(EvaluateSkeletalControl_AnyThread)
-//	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
-//
-//	// Update EffectorLocation if it is based off a bone position
-//	FTransform CSEffectorTransform = GetTargetTransform(Output.AnimInstanceProxy->GetComponentTransform(), Output.Pose, EffectorTarget, EffectorLocationSpace, EffectorLocation);
-//	FVector const CSEffectorLocation = CSEffectorTransform.GetLocation();
-//
-//	// Gather all bone indices between root and tip.
-//	TArray<FCompactPoseBoneIndex> BoneIndices;
-//
-//	
-//	{	//Rootbone and TipBone index declaration
-//		const FCompactPoseBoneIndex RootIndex = RootBone.GetCompactPoseIndex(BoneContainer);
-//		FCompactPoseBoneIndex BoneIndex = TipBone.GetCompactPoseIndex(BoneContainer);
-//		//Fill the array by inserting one by one the indices of the bones in the 0 position and moving the previous ones to the right, until you reach the rootbone.
-//		do
-//		{
-//			BoneIndices.Insert(BoneIndex, 0);
-//			BoneIndex = Output.Pose.GetPose().GetParentBoneIndex(BoneIndex);
-//		} while (BoneIndex != RootIndex);
-//		BoneIndices.Insert(BoneIndex, 0);
-//	}
-//
-//	//Gather transforms and initialize OutBoneTransforms array
-//	int32 const NumTransforms = BoneIndices.Num();
-//	OutBoneTransforms.AddUninitialized(NumTransforms);
-//
-//	// Gather chain links and initialize Chain array. These are non zero length bones.
-//	TArray<FCCDIKChainLink> Chain;
-//	Chain.Reserve(NumTransforms);
-//
-//	//Start filling the arrays with Root Bone
-//	{
-//		const FCompactPoseBoneIndex& RootBoneIndex = BoneIndices[0];
-//		const FTransform& LocalTransform = Output.Pose.GetLocalSpaceTransform(RootBoneIndex);
-//		const FTransform& BoneCSTransform = Output.Pose.GetComponentSpaceTransform(RootBoneIndex);
-//
-//		//Add Rootbone to OutBoneTransforms array and Chain array in position 0
-//		OutBoneTransforms[0] = FBoneTransform(RootBoneIndex, BoneCSTransform);
-//		Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, 0));
-//	}
-//
-//	// Go through remaining transforms
-//	for (int32 TransformIndex = 1; TransformIndex < NumTransforms; TransformIndex++)
-//	{
-//		//Get the Bone Index
-//		const FCompactPoseBoneIndex& BoneIndex = BoneIndices[TransformIndex];
-//
-//		//Get CS and Local Transforms for that BoneIndex
-//		const FTransform& LocalTransform = Output.Pose.GetLocalSpaceTransform(BoneIndex);
-//		const FTransform& BoneCSTransform = Output.Pose.GetComponentSpaceTransform(BoneIndex);
-//		FVector const BoneCSPosition = BoneCSTransform.GetLocation();
-//
-//		//Fill OutBoneTransforms array
-//		OutBoneTransforms[TransformIndex] = FBoneTransform(BoneIndex, BoneCSTransform);
-//
-//		// Calculate the combined length of this segment of skeleton
-//		float const BoneLength = FVector::Dist(BoneCSPosition, OutBoneTransforms[TransformIndex - 1].Transform.GetLocation());
-//
-//		//If its big enough, fill Chain array
-//		if (!FMath::IsNearlyZero(BoneLength))
-//		{
-//			Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, TransformIndex));
-//		}
-//		else
-//		{
-//			// Mark this transform as a zero length child of the last link.
-//			// It will inherit position and delta rotation from parent link.
-//			FCCDIKChainLink & ParentLink = Chain[Chain.Num() - 1];
-//			ParentLink.ChildZeroLengthTransformIndices.Add(TransformIndex);
-//		}
-//	}
-//
-//
-//	//Here we call the CCDIK solver defined in CCDIK.cpp
-//	bool bBoneLocationUpdated = AnimationCore::SolveCCDIK(Chain, CSEffectorLocation, Precision, MaxIterations, bEnableRotationLimit, RotationLimitPerJoints);
-//
-//							const FTransform& ComponentToWorld = m_SkelComp->GetComponentTransform();
-//							const FTransform& ComponentToWorldInv = ComponentToWorld.Inverse();
-//
-//							// Convert from articulation to anim bone
-//							for (int32 i = 0; i < m_InRagdollBones.Num(); i++)
-//							{
-//								int32 BoneIndex = m_InRagdollBones[i];
-//								FName boneName = m_SkelComp->SkeletalMesh->RefSkeleton.GetBoneName(BoneIndex);
-//								int32 BodyIndex = InAnimInstance->GetSkelMeshComponent()->GetPhysicsAsset()->FindBodyIndex(boneName);
-//								check(BodyIndex != INDEX_NONE);
-//								FTransform componentSpaceTransform = m_WorldSpaceBoneTM[BodyIndex] * ComponentToWorldInv;
-//								componentSpaceTransform.DiagnosticCheck_IsValid();
-//								m_OutBoneTransforms->Add(FBoneTransform(FCompactPoseBoneIndex(BoneIndex), componentSpaceTransform));
-//							}
-//
-//	// If we moved some bones, update bone transforms.
-//	if (bBoneLocationUpdated)
-//	{
-//		int32 NumChainLinks = Chain.Num();
-//
-//		// First step: update bone transform positions from chain links.
-//		for (int32 LinkIndex = 0; LinkIndex < NumChainLinks; LinkIndex++)
-//		{
-//			FCCDIKChainLink const & ChainLink = Chain[LinkIndex];
-//			//Store OutBoneTransforms with new current link transform
-//			OutBoneTransforms[ChainLink.TransformIndex].Transform = ChainLink.Transform;
-//
-//			// If there are any zero length children, update position of those
-//			int32 const NumChildren = ChainLink.ChildZeroLengthTransformIndices.Num();
-//			for (int32 ChildIndex = 0; ChildIndex < NumChildren; ChildIndex++)
-//			{
-//				OutBoneTransforms[ChainLink.ChildZeroLengthTransformIndices[ChildIndex]].Transform = ChainLink.Transform;
-//			}
-//		}
-//
-//		//DrawLine(Chain[2].Transform.GetLocation(), Chain[3].Transform.GetLocation(), FColor::Green, 10);
-//
-//#if WITH_EDITOR
-//		DebugLines.Reset(OutBoneTransforms.Num());
-//		DebugLines.AddUninitialized(OutBoneTransforms.Num());
-//		for (int32 Index = 0; Index < OutBoneTransforms.Num(); ++Index)
-//		{
-//			DebugLines[Index] = OutBoneTransforms[Index].Transform.GetLocation();
-//		}
-//#endif // WITH_EDITOR
-//
-//	}
-//}
-
-
-
-
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/AnimNode_CCDIK.h"
+#include "Animation/AnimTypes.h"
+#include "AnimationRuntime.h"
+#include "DrawDebugHelpers.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "BoneControllers/CCDIKOpportunisticBatcher.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Algo/StableSort.h"
+#include "Hash/CityHash.h"
+
+DECLARE_CYCLE_STAT(TEXT("CCDIK Evaluate"), STAT_CCDIK_Evaluate, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Chain Solves"), STAT_CCDIK_ChainSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped Chain Solves"), STAT_CCDIK_SkippedSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Warm Started Chain Solves"), STAT_CCDIK_WarmStartedSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Solve Cache Hits"), STAT_CCDIK_SharedCacheHits, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shared Solve Cache Misses"), STAT_CCDIK_SharedCacheMisses, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Solver Iterations"), STAT_CCDIK_Iterations, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Converged Chains"), STAT_CCDIK_ConvergedChains, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Chains At Max Iterations"), STAT_CCDIK_MaxIterationChains, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("CCD Chain Solves"), STAT_CCDIK_CCDSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("CCD Iterations"), STAT_CCDIK_CCDIterations, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FABRIK Chain Solves"), STAT_CCDIK_FABRIKSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FABRIK Iterations"), STAT_CCDIK_FABRIKIterations, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DLS Chain Solves"), STAT_CCDIK_DLSSolves, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DLS Iterations"), STAT_CCDIK_DLSIterations, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bones Written"), STAT_CCDIK_BonesWritten, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Contact Rays"), STAT_CCDIK_ContactRays, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Contact Rays Skipped"), STAT_CCDIK_ContactRaysSkipped, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Allocated In Evaluate"), STAT_CCDIK_BytesAllocated, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Heap Allocations In Evaluate"), STAT_CCDIK_HeapAllocations, STATGROUP_CCDIK);
+
+CSV_DEFINE_CATEGORY(CCDIK, true);
+
+/////////////////////////////////////////////////////
+// AnimNode_CCDIK
+// Implementation of the CCDIK IK Algorithm
+
+FAnimNode_CCDIK::FAnimNode_CCDIK()
+	: EffectorLocation(FVector::ZeroVector)
+	, EffectorLocationSpace(BCS_ComponentSpace)
+	, EffectorLocation2(FVector::ZeroVector)
+	, EffectorLocationSpace2(BCS_ComponentSpace)
+	, ChainSet(nullptr)
+	, RetargetTable(nullptr)
+	, Precision(1.f)
+	, MaxIterations(10)
+	, bStartFromTail(true)
+	, bEnableRotationLimit(false)
+	, bDeterministicSolve(false)
+	, bEnableTemporalCache(false)
+	, InputPoseTolerance(0.01f)
+	, EffectorSkipTolerance(0.1f)
+	, WarmStartTolerance(5.f)
+	, WarmStartMaxIterations(2)
+	, bUseSharedSolveCache(false)
+	, SharedCachePoseTolerance(0.01f)
+	, SharedCacheEffectorTolerance(0.5f)
+	, bEnableGroundContact(false)
+	, ContactTraceChannel(ECC_Visibility)
+	, ContactTraceUp(50.f)
+	, ContactTraceDown(75.f)
+	, ContactOffset(0.f)
+	, ContactRecastDistance(2.f)
+	, bPredictEffectors(false)
+	, MaxPredictionTime(0.1f)
+	, bUseBatchSolve(false)
+	, Significance(1.f)
+	, bDrawDebugChains(false)
+{
+}
+
+//FAnimNode_CCDIK::FAnimNode_CCDIK(FVector _EffectorLocation, FBoneIndexType _TipBone, FBoneIndexType _RootBone)
+//{
+//	EffectorLocation = _EffectorLocation;
+//	TipBone = _TipBone;
+//	RootBone = _RootBone;
+//	TArray<FCCDIKChainLink> IKChain = CreateIKChain(TipBone, RootBone);
+//}
+
+FVector FAnimNode_CCDIK::GetCurrentLocation(FCSPose<FCompactPose>& MeshBases, const FCompactPoseBoneIndex& BoneIndex)
+{
+	return MeshBases.GetComponentSpaceTransform(BoneIndex).GetLocation();
+}
+
+FTransform FAnimNode_CCDIK::GetTargetTransform(const FTransform& InComponentTransform, FCSPose<FCompactPose>& MeshBases, FBoneSocketTarget& InTarget, EBoneControlSpace Space, const FVector& InOffset)
+{
+	FTransform OutTransform;
+	if (Space == BCS_BoneSpace)
+	{
+		OutTransform = InTarget.GetTargetTransform(InOffset, MeshBases, InComponentTransform);
+	}
+	else
+	{
+		// parent bone space still goes through this way
+		// if your target is socket, it will try find parents of joint that socket belongs to
+		OutTransform.SetLocation(InOffset);
+		FAnimationRuntime::ConvertBoneSpaceTransformToCS(InComponentTransform, MeshBases, OutTransform, InTarget.GetCompactPoseBoneIndex(), Space);
+	}
+
+	return OutTransform;
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::PreUpdate(const UAnimInstance* InAnimInstance)
+{
+	m_MyWorld = InAnimInstance->GetSkelMeshComponent()->GetWorld();
+	m_SkelComp = InAnimInstance->GetSkelMeshComponent();
+
+	m_GameThreadSnapshot.bValid = m_SkelComp && m_SkelComp->GetWorld();
+	if (!m_GameThreadSnapshot.bValid)
+	{
+		return;
+	}
+
+	// Everything evaluation needs from the component, so worker threads never touch it
+	m_GameThreadSnapshot.PredictedLODLevel = m_SkelComp->PredictedLODLevel;
+
+#if CCDIK_CAPTURE
+	if (FCCDIKCaptureRecorder::IsRecording())
+	{
+		m_GameThreadSnapshot.MeshName = GetNameSafe(m_SkelComp->SkeletalMesh);
+	}
+#endif // CCDIK_CAPTURE
+
+#if CCDIK_DEBUG_DRAW
+	// Draw what the last evaluation recorded, one batch per node per frame
+	if (bDrawDebugChains)
+	{
+		if (!m_DebugLineBuffer.IsValid())
+		{
+			m_DebugLineBuffer = MakeShared<FCCDIKDebugLineBuffer, ESPMode::ThreadSafe>();
+		}
+
+		TArray<FVector>* DebugPoints = nullptr;
+#if WITH_EDITOR
+		DebugLines.Reset();
+		DebugPoints = &DebugLines;
+#endif // WITH_EDITOR
+		m_DebugLineBuffer->Flush(m_MyWorld, m_SkelComp->GetComponentTransform(), DebugPoints);
+	}
+#endif // CCDIK_DEBUG_DRAW
+
+	// Bone resolution is shared by every node on the same mesh, chain set and retarget table, and only redone when one of them changes.
+	// Only the snapshot is written here, the worker side adopts it in AdoptSharedBoneData.
+	TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe>& SharedBoneData = m_GameThreadSnapshot.SharedBoneData;
+	if (!SharedBoneData.IsValid() || !SharedBoneData->Matches(m_SkelComp->SkeletalMesh, ChainSet, RetargetTable))
+	{
+		SharedBoneData = FCCDIKSharedBoneData::FindOrCreate(m_SkelComp->SkeletalMesh, ChainSet, RetargetTable);
+	}
+
+	UpdateGroundContacts();
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::UpdateGroundContacts()
+{
+	TArray<FCCDIKContactHit>& ContactHits = m_GameThreadSnapshot.ContactHits;
+	m_GameThreadSnapshot.ContactRays = 0;
+	m_GameThreadSnapshot.ContactRaysSkipped = 0;
+	if (!bEnableGroundContact)
+	{
+		ContactHits.Reset();
+		m_IKChainContacts.Reset();
+		return;
+	}
+
+	ICCDIKContactWorld* ContactWorld = m_CustomContactWorld.Get();
+	if (!ContactWorld)
+	{
+		if (!m_SceneContactWorld.IsValid())
+		{
+			m_SceneContactWorld = MakeShared<FCCDIKSceneContactWorld>();
+		}
+		m_SceneContactWorld->SetWorld(m_MyWorld, ContactTraceChannel, FCollisionQueryParams(SCENE_QUERY_STAT(CCDIKContact), false, m_SkelComp->GetOwner()));
+		ContactWorld = m_SceneContactWorld.Get();
+	}
+
+	// Chains are rebuilt while evaluating, ray state starts over when the last evaluation published another number of them
+	const FCCDIKEvaluationSnapshot& Evaluation = m_EvaluationSnapshot;
+	const int32 NumChains = Evaluation.ContactQueryLocations.Num();
+	if (m_IKChainContacts.Num() != NumChains)
+	{
+		m_IKChainContacts.Reset();
+		m_IKChainContacts.SetNum(NumChains);
+	}
+	ContactHits.SetNum(NumChains);
+
+	TArray<FCCDIKContactRay, TInlineAllocator<8>> Rays;
+	TArray<int32, TInlineAllocator<8>> RayChains;
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		FCCDIKChainContact& Contact = m_IKChainContacts[iChain];
+
+		// Last frame's ray is normally answered by now, if not it is checked again next frame rather than waited on
+		FCCDIKContactHit Hit;
+		if (Contact.PendingRay.bValid && ContactWorld->FetchResult(Contact.PendingRay, Hit))
+		{
+			Contact.PendingRay = FCCDIKContactHandle();
+			Contact.Hit = Hit;
+			Contact.bTraced = true;
+		}
+
+		if (!Evaluation.ContactQueryValid[iChain])
+		{
+			Contact = FCCDIKChainContact();
+			ContactHits[iChain] = FCCDIKContactHit();
+			continue;
+		}
+
+		ContactHits[iChain] = Contact.Hit;
+		if (Contact.PendingRay.bValid)
+		{
+			continue;
+		}
+
+		// The cached hit holds while the effector has not moved across the ground, lifting a foot needs no new ray
+		const FVector& Location = Evaluation.ContactQueryLocations[iChain];
+		if (Contact.bTraced && FVector::DistSquared2D(Location, Contact.TracedLocation) <= FMath::Square(ContactRecastDistance))
+		{
+			m_GameThreadSnapshot.ContactRaysSkipped++;
+			continue;
+		}
+
+		FCCDIKContactRay& Ray = Rays.AddDefaulted_GetRef();
+		Ray.Start = Location + FVector::UpVector * ContactTraceUp;
+		Ray.End = Location - FVector::UpVector * ContactTraceDown;
+		RayChains.Add(iChain);
+		Contact.TracedLocation = Location;
+	}
+
+	// Every ray of this character goes out together
+	if (Rays.Num() > 0)
+	{
+		TArray<FCCDIKContactHandle, TInlineAllocator<8>> Handles;
+		Handles.SetNum(Rays.Num());
+		ContactWorld->SubmitRays(Rays.GetData(), Rays.Num(), Handles.GetData());
+		for (int32 RayIndex = 0; RayIndex < Rays.Num(); RayIndex++)
+		{
+			m_IKChainContacts[RayChains[RayIndex]].PendingRay = Handles[RayIndex];
+		}
+	}
+
+	m_GameThreadSnapshot.ContactRays = Rays.Num();
+	INC_DWORD_STAT_BY(STAT_CCDIK_ContactRays, m_GameThreadSnapshot.ContactRays);
+	INC_DWORD_STAT_BY(STAT_CCDIK_ContactRaysSkipped, m_GameThreadSnapshot.ContactRaysSkipped);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::ApplyGroundContacts(const FTransform& ComponentTransform, FVector* CSChainTargets, int32 NumEffectors)
+{
+	const TArray<FCCDIKContactHit>& ContactHits = m_GameThreadSnapshot.ContactHits;
+	const bool bHasHits = ContactHits.Num() == m_IKChains.Num();
+	const FVector CSUp = ComponentTransform.InverseTransformVectorNoScale(FVector::UpVector);
+
+	// Published for the next PreUpdate, only reallocated when the number of chains changed
+	TArray<FVector>& QueryLocations = m_EvaluationSnapshot.ContactQueryLocations;
+	TArray<bool>& QueryValid = m_EvaluationSnapshot.ContactQueryValid;
+	QueryLocations.SetNumUninitialized(m_IKChains.Num(), false);
+	QueryValid.SetNumUninitialized(m_IKChains.Num(), false);
+
+	for (int32 iChain = 0; iChain < m_IKChains.Num(); iChain++)
+	{
+		QueryValid[iChain] = bEnableGroundContact && m_IKChainGroundContact[iChain] && ShouldSolveChain(iChain, NumEffectors);
+		if (!QueryValid[iChain])
+		{
+			continue;
+		}
+
+		// Next rays go below where the animation put the effector, not where the ground moved it
+		FVector& Target = CSChainTargets[iChain];
+		QueryLocations[iChain] = ComponentTransform.TransformPosition(Target);
+
+		if (!bHasHits || !ContactHits[iChain].bHit)
+		{
+			continue;
+		}
+
+		const FVector PlanePoint = ComponentTransform.InverseTransformPosition(ContactHits[iChain].Location);
+		const FVector PlaneNormal = ComponentTransform.InverseTransformVectorNoScale(ContactHits[iChain].Normal);
+		const float UpDotNormal = CSUp | PlaneNormal;
+		if (UpDotNormal < KINDA_SMALL_NUMBER)
+		{
+			// Walls and ceilings are not ground
+			continue;
+		}
+
+		// Height of the hit plane above the component origin, straight below the effector. The animated pose is
+		// authored on flat ground at the origin, so adding it keeps a lifted foot lifted.
+		const FVector TargetOnFloor = Target - CSUp * (Target | CSUp);
+		const float GroundHeight = ((PlanePoint - TargetOnFloor) | PlaneNormal) / UpDotNormal;
+		Target += CSUp * (GroundHeight + ContactOffset);
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::SetContactWorld(TSharedPtr<ICCDIKContactWorld> InContactWorld)
+{
+	// Pending rays belong to the previous world
+	m_CustomContactWorld = InContactWorld;
+	m_IKChainContacts.Reset();
+}
+
+//FUNCTION CREATED BY ME
+const FCCDIKResolvedChainSet& FAnimNode_CCDIK::GetResolvedChains() const
+{
+	static const FCCDIKResolvedChainSet NoChains;
+	return m_SharedBoneData.IsValid() ? m_SharedBoneData->ResolvedChains : NoChains;
+}
+
+////FUNCTION CREATED BY ME
+//void FAnimNode_CCDIK::GetWorldSpaceTransforms(TArray<FBoneTransform>& OutBoneTransforms)
+//{
+//	const FTransform CompWorldSpaceTM = m_ComponentSpacePoseContext->AnimInstanceProxy->GetComponentTransform();
+//
+//	OutBoneTransforms.AddUninitialized(m_SkelComp->Bodies.Num());
+//
+//	for (int32 iJoint = 0; iJoint < m_SkelComp->Bodies.Num(); iJoint++)
+//	{
+//		// Get the UE part transforms from skeleton here as in USkeletalMeshComponent::UpdateKinematicBonesToAnim (just locally)
+//		FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(m_CachedBoneIndicesForCurrentLOD[iJoint]);
+//		const FTransform& ComponentSpaceTM = m_ComponentSpacePoseContext->Pose.GetComponentSpaceTransform(BoneIndex);
+//		const FTransform WorldSpaceBoneTM = ComponentSpaceTM * CompWorldSpaceTM;
+//
+//		m_WorldSpaceBoneTM[iJoint] = WorldSpaceBoneTM;
+//		OutBoneTransforms[iJoint] = FBoneTransform(BoneIndex, WorldSpaceBoneTM);
+//	}
+//}
+
+//FUNCTION CREATED BY ME
+int32 FAnimNode_CCDIK::GetSolvedBoneTransforms(TArray<FBoneTransform>& OutBoneTransforms) const
+{
+	const int32 OutTransformsBase = OutBoneTransforms.Num();
+	OutBoneTransforms.Reserve(OutTransformsBase + m_IKChains.GetTotalLinks() + m_IKChains.GetTotalZeroLengthChildren() + 1);
+
+	// Full body pelvis goes first, so a chain holding the same bone overrides it. Bones below it that no chain moved follow it.
+	if (m_FullBodyPelvisIndex.IsValid() && !m_PelvisOffset.IsNearlyZero())
+	{
+		FTransform PelvisTransform = m_PelvisTransform;
+		PelvisTransform.AddToTranslation(m_PelvisOffset);
+		OutBoneTransforms.Add(FBoneTransform(m_FullBodyPelvisIndex, PelvisTransform));
+	}
+
+	for (int32 iChain : m_IKChainSolveOrder)
+	{
+		if (!m_IKChainFrameStats[iChain].bUpdated)
+		{
+			continue;
+		}
+
+		// Root link never moves, every other link is emitted together with the zero length bones riding on it
+		const int32 FirstLink = m_IKChains.GetFirstLink(iChain);
+		for (int32 LinkIndex = 1; LinkIndex < m_IKChains.GetNumLinks(iChain); LinkIndex++)
+		{
+			const FTransform LinkTransform = m_IKChains.GetTransform(iChain, LinkIndex);
+			OutBoneTransforms.Add(FBoneTransform(m_IKChains.BoneIndices[FirstLink + LinkIndex], LinkTransform));
+
+			const int32 ChildrenEnd = m_IKChains.ZeroLengthChildOffsets[FirstLink + LinkIndex + 1];
+			for (int32 ChildIndex = m_IKChains.ZeroLengthChildOffsets[FirstLink + LinkIndex]; ChildIndex < ChildrenEnd; ChildIndex++)
+			{
+				OutBoneTransforms.Add(FBoneTransform(m_IKChains.ZeroLengthChildren[ChildIndex], LinkTransform));
+			}
+		}
+	}
+
+	const int32 NumAdded = OutBoneTransforms.Num() - OutTransformsBase;
+	if (NumAdded == 0)
+	{
+		return 0;
+	}
+
+	// Base class blends these in order. Stable sort keeps solve order among duplicates, so a bone shared by
+	// several chains takes the result of the chain solved last, which started from what the others left.
+	TArrayView<FBoneTransform> AddedTransforms(OutBoneTransforms.GetData() + OutTransformsBase, NumAdded);
+	Algo::StableSort(AddedTransforms, FCompareBoneTransformIndex());
+
+	int32 NumUnique = 0;
+	for (int32 Index = 0; Index < NumAdded; Index++)
+	{
+		if (NumUnique > 0 && AddedTransforms[NumUnique - 1].BoneIndex == AddedTransforms[Index].BoneIndex)
+		{
+			AddedTransforms[NumUnique - 1] = AddedTransforms[Index];
+		}
+		else
+		{
+			AddedTransforms[NumUnique++] = AddedTransforms[Index];
+		}
+	}
+	OutBoneTransforms.SetNum(OutTransformsBase + NumUnique, false);
+
+	return NumUnique;
+}
+
+//FUNCTION CREATED BY ME
+bool FAnimNode_CCDIK::CreateIKChain(const FBoneContainer& RequiredBones, FBoneIndexType TipLink, FBoneIndexType RootLink, FCCDIKChainStorage& OutChains)
+{
+	if (TipLink == (FBoneIndexType)INDEX_NONE || RootLink == (FBoneIndexType)INDEX_NONE)
+	{
+		return false;
+	}
+
+	//Tip and root come from the reference skeleton, convert them to the compact pose of the current LOD
+	const FCompactPoseBoneIndex RootIndex = RequiredBones.MakeCompactPoseIndex(FMeshPoseBoneIndex(RootLink));
+	const FCompactPoseBoneIndex TipIndex = RequiredBones.MakeCompactPoseIndex(FMeshPoseBoneIndex(TipLink));
+	if (!RootIndex.IsValid() || !TipIndex.IsValid())
+	{
+		return false;
+	}
+
+	// Gather the bones between tip and root, tip first
+	TArray<FCompactPoseBoneIndex, TInlineAllocator<32>> ChainBones;
+	{
+		FCompactPoseBoneIndex BoneIndex = TipIndex;
+		ChainBones.Add(BoneIndex);
+		while (BoneIndex != RootIndex)
+		{
+			BoneIndex = RequiredBones.GetParentBoneIndex(BoneIndex);
+			if (!BoneIndex.IsValid())
+			{
+				// Tip bone is not a child of the root bone
+				return false;
+			}
+			ChainBones.Add(BoneIndex);
+		}
+	}
+
+	// Zero length bones sit on their parent and cannot be rotated towards anything, they are not links.
+	// They inherit the transform of the link above them when the chain is written back.
+	auto IsZeroLengthBone = [&RequiredBones, RootIndex](FCompactPoseBoneIndex BoneIndex)
+	{
+		return BoneIndex != RootIndex && FMath::IsNearlyZero(RequiredBones.GetRefPoseTransform(BoneIndex).GetTranslation().Size());
+	};
+
+	int32 NumLinks = 0;
+	for (const FCompactPoseBoneIndex BoneIndex : ChainBones)
+	{
+		NumLinks += IsZeroLengthBone(BoneIndex) ? 0 : 1;
+	}
+
+	// Transforms are filled in every evaluate by RefreshIKChainTransforms, only the topology is stored here.
+	const int32 FirstLink = OutChains.AddChain(NumLinks);
+	int32 LinkIndex = INDEX_NONE;
+	for (int32 BoneOffset = ChainBones.Num() - 1; BoneOffset >= 0; --BoneOffset)
+	{
+		const FCompactPoseBoneIndex BoneIndex = ChainBones[BoneOffset];
+		if (IsZeroLengthBone(BoneIndex))
+		{
+			OutChains.AddZeroLengthChild(FirstLink + LinkIndex, BoneIndex);
+		}
+		else
+		{
+			OutChains.BoneIndices[FirstLink + ++LinkIndex] = BoneIndex;
+		}
+	}
+
+	return true;
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::AdoptSharedBoneData()
+{
+	if (m_SharedBoneData != m_GameThreadSnapshot.SharedBoneData)
+	{
+		m_SharedBoneData = m_GameThreadSnapshot.SharedBoneData;
+		m_IKChainsDirty = true;
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::RebuildIKChains(const FBoneContainer& RequiredBones)
+{
+	m_IKChainEffectorIndex.Reset();
+	m_IKChainBackend.Reset();
+	m_IKChainDamping.Reset();
+	m_IKChainRetargetScale.Reset();
+	m_IKChainRetargetOffset.Reset();
+	m_IKChainGroundContact.Reset();
+	m_IKChainSolveOrder.Reset();
+	m_IKChainFrameStats.Reset();
+
+	const FCCDIKResolvedChainSet& ResolvedChains = GetResolvedChains();
+
+	// All chains live in one set of buffers, rebuilt in place so LOD switches reuse their memory
+	m_IKChains.Reset();
+
+	// Bone names are resolved on the game thread in PreUpdate, the resolved chain set stays empty until then
+	m_IKChainDescriptorIndex.Reset();
+	for (int32 iDescriptor = 0; iDescriptor < ResolvedChains.Num(); iDescriptor++)
+	{
+		if (CreateIKChain(RequiredBones, ResolvedChains.TipBones[iDescriptor], ResolvedChains.RootBones[iDescriptor], m_IKChains))
+		{
+			const int32 iChain = m_IKChains.Num() - 1;
+			const int32 FirstLink = m_IKChains.GetFirstLink(iChain);
+			for (int32 iLink = 0; iLink < m_IKChains.GetNumLinks(iChain); iLink++)
+			{
+				m_IKChains.RotationLimits[FirstLink + iLink] = FMath::DegreesToRadians(ResolvedChains.GetRotationLimit(iDescriptor, iLink));
+			}
+			BuildChainJointLimits(RequiredBones, iChain, iDescriptor);
+
+			m_IKChainEffectorIndex.Add(ResolvedChains.EffectorIndices[iDescriptor]);
+			m_IKChainBackend.Add((CCDIKSolverCore::ESolverBackend)ResolvedChains.Backends[iDescriptor]);
+			m_IKChainDamping.Add(ResolvedChains.Dampings[iDescriptor]);
+			m_IKChainRetargetScale.Add(ResolvedChains.RetargetScales[iDescriptor]);
+			m_IKChainRetargetOffset.Add(ResolvedChains.RetargetOffsets[iDescriptor]);
+			m_IKChainGroundContact.Add(ResolvedChains.GroundContacts[iDescriptor]);
+			m_IKChainDescriptorIndex.Add(ResolvedChains.DescriptorIndices[iDescriptor]);
+			m_IKChainSolveOrder.Add(iChain);
+		}
+	}
+
+	// Every chain gets its own slice of solver planes so chains can be handed to the batch solver together
+	m_IKChains.Finalize();
+	const int32 NumChains = m_IKChains.Num();
+	const int32 TotalLinks = m_IKChains.GetTotalLinks();
+
+	BuildChainCouplings(RequiredBones);
+
+	// Compact pose indices always place parents before children, so sorting on the root link solves ancestor chains first.
+	// Their solved bones are handed to the chains below through PropagateSharedLinks before those solve.
+	m_IKChainSolveOrder.Sort([this](int32 A, int32 B)
+	{
+		return m_IKChains.BoneIndices[m_IKChains.GetFirstLink(A)] < m_IKChains.BoneIndices[m_IKChains.GetFirstLink(B)];
+	});
+	m_IKChainFrameStats.SetNum(NumChains);
+
+	m_BatchJobs.SetNum(NumChains);
+	m_BatchJobChainIndex.SetNum(NumChains);
+
+	// Kernel choice only depends on chain length and flags, done here once rather than per solve
+	m_IKSolveFunctionFlags = INDEX_NONE;
+	SelectChainSolveFunctions();
+
+	// New topology, nothing from previous solves can be reused
+	m_IKChainHistory.Reset();
+	m_IKChainHistory.SetNum(NumChains);
+	m_ChainHistoryData.SetNumUninitialized(TotalLinks * 7);
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		m_IKChainHistory[iChain].DataOffset = m_IKChains.GetFirstLink(iChain) * 7;
+	}
+
+	// Which chains each IK LOD solves
+	const int32 NumLODs = ResolvedChains.LODSettings.Num();
+	m_IKChainLODActive.SetNum(NumLODs * NumChains);
+	for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
+	{
+		const TArray<int32>& ActiveChains = ResolvedChains.LODSettings[LODIndex].ActiveChains;
+		for (int32 iChain = 0; iChain < NumChains; iChain++)
+		{
+			m_IKChainLODActive[LODIndex * NumChains + iChain] = ActiveChains.Num() == 0 || ActiveChains.Contains(m_IKChainDescriptorIndex[iChain]);
+		}
+	}
+
+	m_IKPrevLocalOffsets.SetNumUninitialized(TotalLinks);
+	m_IKLastLocalOffsets.SetNumUninitialized(TotalLinks);
+	m_IKChainHasLocalOffsets.Reset();
+	m_IKChainHasLocalOffsets.SetNumZeroed(NumChains);
+	m_IKUpdatePhase = PointerHash(this);
+	m_IKUpdateFrame = 0;
+	m_IKEffectorHistory.Reset();
+	m_IKEffectorHistory.SetNum(NumChains);
+
+	m_CurrentIKLOD = INDEX_NONE;
+
+	// Everything EvaluateSkeletalControl_AnyThread needs per frame comes out of the arena
+	m_FrameArena.Reserve((GetNumEffectors() + NumChains) * (int32)sizeof(FVector) + 2 * (int32)alignof(FVector)
+		+ NumChains * (int32)sizeof(CCDIKSolverCore::FSolveResult) + (int32)alignof(CCDIKSolverCore::FSolveResult)
+		+ (TotalLinks * 7 + NumChains * 12) * (int32)sizeof(int32) + NumChains * (int32)alignof(int32));
+
+	m_IKChainsDirty = false;
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::BuildChainJointLimits(const FBoneContainer& RequiredBones, int32 ChainIndex, int32 ResolvedChainIndex)
+{
+	const FCCDIKResolvedChainSet& ResolvedChains = GetResolvedChains();
+	const int32 FirstLink = m_IKChains.GetFirstLink(ChainIndex);
+
+	// Root link never rotates, so it is never constrained
+	for (int32 iLink = 1; iLink < m_IKChains.GetNumLinks(ChainIndex); iLink++)
+	{
+		const FCCDIKJointConstraint* Constraint = ResolvedChains.GetJointConstraint(ResolvedChainIndex, iLink);
+		if (!Constraint)
+		{
+			continue;
+		}
+
+		// Reference pose rotation relative to the parent link, through any zero length bones in between
+		const FCompactPoseBoneIndex ParentLinkBone = m_IKChains.BoneIndices[FirstLink + iLink - 1];
+		FQuat RefRotation = FQuat::Identity;
+		for (FCompactPoseBoneIndex BoneIndex = m_IKChains.BoneIndices[FirstLink + iLink]; BoneIndex != ParentLinkBone; BoneIndex = RequiredBones.GetParentBoneIndex(BoneIndex))
+		{
+			RefRotation = RequiredBones.GetRefPoseTransform(BoneIndex).GetRotation() * RefRotation;
+		}
+		RefRotation.Normalize();
+
+		const FVector TwistAxis = Constraint->TwistAxis.GetSafeNormal(SMALL_NUMBER, FVector::ForwardVector);
+		const float HalfSwingLimit = FMath::DegreesToRadians(FMath::Clamp(Constraint->SwingLimit, 0.f, 180.f)) * 0.5f;
+
+		CCDIKSolverCore::FJointLimit& Limit = m_IKChains.JointLimits[FirstLink + iLink];
+		Limit.RefRotation[0] = RefRotation.X;
+		Limit.RefRotation[1] = RefRotation.Y;
+		Limit.RefRotation[2] = RefRotation.Z;
+		Limit.RefRotation[3] = RefRotation.W;
+		Limit.TwistAxis[0] = TwistAxis.X;
+		Limit.TwistAxis[1] = TwistAxis.Y;
+		Limit.TwistAxis[2] = TwistAxis.Z;
+		FMath::SinCos(&Limit.SinHalfSwingLimit, &Limit.CosHalfSwingLimit, HalfSwingLimit);
+		Limit.SinHalfMinTwist = FMath::Sin(FMath::DegreesToRadians(FMath::Clamp(Constraint->MinTwist, -180.f, 0.f)) * 0.5f);
+		Limit.SinHalfMaxTwist = FMath::Sin(FMath::DegreesToRadians(FMath::Clamp(Constraint->MaxTwist, 0.f, 180.f)) * 0.5f);
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::BuildChainCouplings(const FBoneContainer& RequiredBones)
+{
+	m_ChainCouplings.Reset();
+	m_CouplingLinkPairs.Reset();
+	m_IKChainPelvisFirstLink.Reset();
+	m_FullBodyPelvisIndex = FCompactPoseBoneIndex(INDEX_NONE);
+	m_PelvisOffset = FVector::ZeroVector;
+
+	const int32 NumChains = m_IKChains.Num();
+	m_IKChainHasCouplingSource.Reset();
+	m_IKChainHasCouplingSource.SetNumZeroed(NumChains);
+	for (int32 SourceChain = 0; SourceChain < NumChains; SourceChain++)
+	{
+		const int32 SourceFirstLink = m_IKChains.GetFirstLink(SourceChain);
+		const int32 SourceNumLinks = m_IKChains.GetNumLinks(SourceChain);
+		for (int32 TargetChain = 0; TargetChain < NumChains; TargetChain++)
+		{
+			if (TargetChain == SourceChain)
+			{
+				continue;
+			}
+
+			// Bones shared by two chains sit on one path from the root, so they are a single run of links in both chains
+			const int32 TargetFirstLink = m_IKChains.GetFirstLink(TargetChain);
+			const int32 FirstLinkPair = m_CouplingLinkPairs.Num();
+			bool bShared = false;
+			bool bSourceRotatesShared = false;
+			for (int32 TargetLink = 0; TargetLink < m_IKChains.GetNumLinks(TargetChain); TargetLink++)
+			{
+				int32 SourceLink = INDEX_NONE;
+				for (int32 Link = 0; Link < SourceNumLinks; Link++)
+				{
+					if (m_IKChains.BoneIndices[SourceFirstLink + Link] == m_IKChains.BoneIndices[TargetFirstLink + TargetLink])
+					{
+						SourceLink = Link;
+						break;
+					}
+				}
+
+				bShared |= SourceLink != INDEX_NONE;
+				bSourceRotatesShared |= SourceLink > 0;
+				if (bShared)
+				{
+					m_CouplingLinkPairs.Add(FIntPoint(TargetLink, SourceLink));
+				}
+			}
+
+			// A source root link never moves during the source's solve, sharing only that bone needs no coupling
+			if (!bSourceRotatesShared)
+			{
+				m_CouplingLinkPairs.SetNum(FirstLinkPair, false);
+				continue;
+			}
+
+			FCCDIKChainCoupling& Coupling = m_ChainCouplings.AddDefaulted_GetRef();
+			Coupling.SourceChain = SourceChain;
+			Coupling.TargetChain = TargetChain;
+			Coupling.FirstLinkPair = FirstLinkPair;
+			Coupling.NumLinkPairs = m_CouplingLinkPairs.Num() - FirstLinkPair;
+			m_IKChainHasCouplingSource[TargetChain] = true;
+		}
+	}
+
+	m_IKChainPelvisFirstLink.Init(INDEX_NONE, NumChains);
+	const FCCDIKResolvedChainSet& ResolvedChains = GetResolvedChains();
+	if (!ResolvedChains.FullBody.bEnabled)
+	{
+		return;
+	}
+
+	if (ResolvedChains.PelvisBone != INDEX_NONE)
+	{
+		m_FullBodyPelvisIndex = RequiredBones.MakeCompactPoseIndex(FMeshPoseBoneIndex(ResolvedChains.PelvisBone));
+	}
+	if (!m_FullBodyPelvisIndex.IsValid())
+	{
+		return;
+	}
+
+	// Chains rooted on or below the pelvis move with it entirely, chains running through it from its link on
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		const int32 FirstLink = m_IKChains.GetFirstLink(iChain);
+		const FCompactPoseBoneIndex ChainRoot = m_IKChains.BoneIndices[FirstLink];
+		if (ChainRoot == m_FullBodyPelvisIndex || RequiredBones.BoneIsChildOf(ChainRoot, m_FullBodyPelvisIndex))
+		{
+			m_IKChainPelvisFirstLink[iChain] = 0;
+			continue;
+		}
+
+		for (int32 iLink = 1; iLink < m_IKChains.GetNumLinks(iChain); iLink++)
+		{
+			if (m_IKChains.BoneIndices[FirstLink + iLink] == m_FullBodyPelvisIndex)
+			{
+				m_IKChainPelvisFirstLink[iChain] = iLink;
+				break;
+			}
+		}
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::RefreshIKChainTransforms(FCSPose<FCompactPose>& MeshBases)
+{
+	// Input pose goes straight into the solver planes, links of all chains in order
+	for (int32 iChain = 0; iChain < m_IKChains.Num(); iChain++)
+	{
+		const int32 FirstLink = m_IKChains.GetFirstLink(iChain);
+		const CCDIKSolverCore::FChainView& View = m_IKChains.Views[iChain];
+		for (int32 iLink = 0; iLink < View.NumLinks; iLink++)
+		{
+			const FCompactPoseBoneIndex BoneIndex = m_IKChains.BoneIndices[FirstLink + iLink];
+			const FTransform& ComponentSpaceTM = MeshBases.GetComponentSpaceTransform(BoneIndex);
+			m_IKChains.SetTransform(iChain, iLink, ComponentSpaceTM);
+			m_IKChains.Scales[FirstLink + iLink] = ComponentSpaceTM.GetScale3D();
+
+			// Local transforms are relative to the parent link. With zero length bones in between, that is not the bone's own parent.
+			const int32 ParentLink = m_IKChains.ParentLinks[FirstLink + iLink];
+			if (ParentLink == INDEX_NONE || MeshBases.GetPose().GetParentBoneIndex(BoneIndex) == m_IKChains.BoneIndices[ParentLink])
+			{
+				m_IKChains.LocalTransforms[FirstLink + iLink] = MeshBases.GetLocalSpaceTransform(BoneIndex);
+			}
+			else
+			{
+				m_IKChains.LocalTransforms[FirstLink + iLink] = ComponentSpaceTM.GetRelativeTransform(MeshBases.GetComponentSpaceTransform(m_IKChains.BoneIndices[ParentLink]));
+			}
+			View.AngleDelta[iLink] = 0.f;
+		}
+	}
+
+	if (m_FullBodyPelvisIndex.IsValid())
+	{
+		m_PelvisTransform = MeshBases.GetComponentSpaceTransform(m_FullBodyPelvisIndex);
+	}
+}
+
+
+//FUNCTION CREATED BY ME
+uint32 FAnimNode_CCDIK::HashChainInput(const CCDIKSolverCore::FChainView& View) const
+{
+	// PosX..RotW are laid out back to back in the chain's slice
+	const float InvTolerance = 1.f / FMath::Max(InputPoseTolerance, KINDA_SMALL_NUMBER);
+	const float* Data = View.PosX;
+	uint32 Hash = GetTypeHash(View.NumLinks);
+	for (int32 Index = 0; Index < View.NumLinks * 7; Index++)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(FMath::RoundToInt(Data[Index] * InvTolerance)));
+	}
+	return Hash;
+}
+
+//FUNCTION CREATED BY ME
+uint64 FAnimNode_CCDIK::MakeSharedSolveKey(int32 ChainIndex, const FVector& Target, const CCDIKSolverCore::FSolveSettings& Settings)
+{
+	const CCDIKSolverCore::FChainView& View = m_IKChains.Views[ChainIndex];
+	const int32 NumValues = 12 + (View.NumLinks - 1) * 7;
+	int32* Values = m_FrameArena.Alloc<int32>(NumValues);
+	int32 NumWritten = 0;
+	auto WriteBits = [Values, &NumWritten](float Value)
+	{
+		FMemory::Memcpy(&Values[NumWritten++], &Value, sizeof(float));
+	};
+
+	// Which chain of which assets, and everything else the solve depends on. Rotation limits come with the chain.
+	Values[NumWritten++] = (int32)m_SharedBoneData->SolveCacheId;
+	Values[NumWritten++] = m_IKChainDescriptorIndex[ChainIndex];
+	Values[NumWritten++] = View.NumLinks;
+	Values[NumWritten++] = (Settings.bStartFromTail ? 1 : 0) | (Settings.bEnableRotationLimit ? 2 : 0) | ((int32)Settings.Backend << 2);
+	Values[NumWritten++] = Settings.MaxIterations;
+	WriteBits(Settings.Precision);
+	WriteBits(Settings.Damping);
+	WriteBits(SharedCachePoseTolerance);
+	WriteBits(SharedCacheEffectorTolerance);
+
+	// Input pose and effector relative to the root link, which the solver never moves, so the character's placement does not matter
+	const FTransform RootTransform(m_IKChains.GetRotation(ChainIndex, 0), m_IKChains.GetLocation(ChainIndex, 0));
+	const FQuat InvRootRotation = RootTransform.GetRotation().Inverse();
+	const float InvPoseStep = 1.f / FMath::Max(SharedCachePoseTolerance, KINDA_SMALL_NUMBER);
+	for (int32 iLink = 1; iLink < View.NumLinks; iLink++)
+	{
+		const FVector Location = RootTransform.InverseTransformPositionNoScale(m_IKChains.GetLocation(ChainIndex, iLink));
+		FQuat Rotation = InvRootRotation * m_IKChains.GetRotation(ChainIndex, iLink);
+		if (Rotation.W < 0.f)
+		{
+			Rotation = Rotation * -1.f;
+		}
+
+		Values[NumWritten++] = FMath::RoundToInt(Location.X * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Location.Y * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Location.Z * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Rotation.X * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Rotation.Y * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Rotation.Z * InvPoseStep);
+		Values[NumWritten++] = FMath::RoundToInt(Rotation.W * InvPoseStep);
+	}
+
+	const FVector EffectorOffset = RootTransform.InverseTransformPositionNoScale(Target) / FMath::Max(SharedCacheEffectorTolerance, KINDA_SMALL_NUMBER);
+	Values[NumWritten++] = FMath::RoundToInt(EffectorOffset.X);
+	Values[NumWritten++] = FMath::RoundToInt(EffectorOffset.Y);
+	Values[NumWritten++] = FMath::RoundToInt(EffectorOffset.Z);
+	check(NumWritten == NumValues);
+
+	// Zero means not shared
+	const uint64 Key = CityHash64(reinterpret_cast<const char*>(Values), NumValues * sizeof(int32));
+	return Key != 0 ? Key : 1;
+}
+
+//FUNCTION CREATED BY ME
+bool FAnimNode_CCDIK::PrepareChainSolve(int32 ChainIndex, const FVector& Target, CCDIKSolverCore::FSolveSettings& InOutSettings, CCDIKSolverCore::FSolveResult& OutSkippedResult)
+{
+	// A deterministic solve must not depend on what earlier frames left behind
+	if (!bEnableTemporalCache || bDeterministicSolve)
+	{
+		return true;
+	}
+
+	FCCDIKChainHistory& History = m_IKChainHistory[ChainIndex];
+	FCCDIKChainFrameStats& ChainStats = m_IKChainFrameStats[ChainIndex];
+	const CCDIKSolverCore::FChainView& View = m_IKChains.Views[ChainIndex];
+	float* SolvedData = m_ChainHistoryData.GetData() + History.DataOffset;
+
+	const uint32 InputPoseHash = HashChainInput(View);
+	if (History.bValid && History.InputPoseHash == InputPoseHash)
+	{
+		const float EffectorDelta = FVector::Dist(History.Effector, Target);
+
+		// Same input, same target: last solution still holds
+		if (EffectorDelta <= EffectorSkipTolerance)
+		{
+			FMemory::Memcpy(View.PosX, SolvedData, View.NumLinks * 7 * sizeof(float));
+			OutSkippedResult = CCDIKSolverCore::FSolveResult();
+			OutSkippedResult.bUpdated = History.bUpdated;
+			OutSkippedResult.TipError = History.TipError;
+			ChainStats.bSkipped = true;
+			INC_DWORD_STAT(STAT_CCDIK_SkippedSolves);
+			return false;
+		}
+
+		// Target moved a little, last solution is a good starting point
+		if (EffectorDelta <= WarmStartTolerance)
+		{
+			FMemory::Memcpy(View.PosX, SolvedData, View.NumLinks * 7 * sizeof(float));
+			InOutSettings.MaxIterations = FMath::Min(InOutSettings.MaxIterations, WarmStartMaxIterations);
+			ChainStats.bWarmStarted = true;
+			INC_DWORD_STAT(STAT_CCDIK_WarmStartedSolves);
+		}
+	}
+
+	// Only record the effector of real solves, so small per-frame moves cannot drift away from a skipped solution
+	History.Effector = Target;
+	History.InputPoseHash = InputPoseHash;
+	return true;
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::SelectChainSolveFunctions()
+{
+	const int32 Flags = (bStartFromTail ? 1 : 0) | (bEnableRotationLimit ? 2 : 0) | (bDeterministicSolve ? 4 : 0);
+	if (Flags == m_IKSolveFunctionFlags)
+	{
+		return;
+	}
+
+	m_IKSolveFunctionFlags = Flags;
+	m_IKChainSolveFunctions.SetNum(m_IKChains.Num());
+	for (int32 iChain = 0; iChain < m_IKChains.Num(); iChain++)
+	{
+		CCDIKSolverCore::FSolveSettings ChainSettings;
+		ChainSettings.bStartFromTail = bStartFromTail;
+		ChainSettings.bEnableRotationLimit = bEnableRotationLimit;
+		ChainSettings.bDeterministic = bDeterministicSolve;
+		ChainSettings.Backend = m_IKChainBackend[iChain];
+		m_IKChainSolveFunctions[iChain] = CCDIKSolverCore::GetSolveFunction(m_IKChains.GetNumLinks(iChain), ChainSettings);
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::ApplyChainSolveResult(int32 ChainIndex, const CCDIKSolverCore::FSolveSettings& Settings, const CCDIKSolverCore::FSolveResult& Result)
+{
+	FCCDIKChainFrameStats& ChainStats = m_IKChainFrameStats[ChainIndex];
+	checkSlow(ChainStats.SolvesThisFrame == 0);
+
+	// The solver wrote its result in place, only history and stats are left to update
+	if (bEnableTemporalCache && !ChainStats.bSkipped)
+	{
+		FCCDIKChainHistory& History = m_IKChainHistory[ChainIndex];
+		const CCDIKSolverCore::FChainView& View = m_IKChains.Views[ChainIndex];
+		FMemory::Memcpy(m_ChainHistoryData.GetData() + History.DataOffset, View.PosX, View.NumLinks * 7 * sizeof(float));
+		History.TipError = Result.TipError;
+		History.bUpdated = Result.bUpdated;
+		History.bValid = true;
+	}
+
+	ChainStats.bUpdated = Result.bUpdated;
+
+	// Solved here from the input pose, offer it to every character with the same chain input
+	if (ChainStats.SharedSolveKey != 0 && !ChainStats.bSkipped && !ChainStats.bWarmStarted)
+	{
+		FCCDIKSolveCache::Get().Add(ChainStats.SharedSolveKey, m_SharedBoneData->SolveCacheId, m_IKChains.Views[ChainIndex], Result.bUpdated);
+	}
+
+	// Throttled: remember the solution as local offsets and start blending towards it
+	if (m_bIKThrottled)
+	{
+		StoreChainLocalOffsets(ChainIndex);
+		ApplyChainLocalOffsets(ChainIndex, m_IKInterpolationAlpha);
+		ChainStats.bUpdated = true;
+	}
+	else
+	{
+		m_IKChainHasLocalOffsets[ChainIndex] = false;
+	}
+
+	ChainStats.Iterations = Result.Iterations;
+	ChainStats.TipError = Result.TipError;
+	ChainStats.bConverged = Result.TipError <= Settings.Precision;
+	ChainStats.bHitMaxIterations = !ChainStats.bConverged && Result.Iterations >= Settings.MaxIterations;
+	ChainStats.SolvesThisFrame++;
+	INC_DWORD_STAT(STAT_CCDIK_ChainSolves);
+}
+
+//FUNCTION CREATED BY ME
+int32 FAnimNode_CCDIK::GetNumEffectors() const
+{
+	return 2 + AdditionalEffectors.Num();
+}
+
+//FUNCTION CREATED BY ME
+bool FAnimNode_CCDIK::IsChainActiveAtLOD(int32 ChainIndex) const
+{
+	return m_CurrentIKLOD == INDEX_NONE || m_IKChainLODActive[m_CurrentIKLOD * m_IKChains.Num() + ChainIndex];
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::StoreChainLocalOffsets(int32 ChainIndex)
+{
+	const int32 FirstLink = m_IKChains.GetFirstLink(ChainIndex);
+	const bool bHadOffsets = m_IKChainHasLocalOffsets[ChainIndex];
+
+	// Offset of each solved local rotation from the input local rotation. The root link never rotates.
+	m_IKPrevLocalOffsets[FirstLink] = FQuat::Identity;
+	m_IKLastLocalOffsets[FirstLink] = FQuat::Identity;
+	for (int32 iLink = 1; iLink < m_IKChains.GetNumLinks(ChainIndex); iLink++)
+	{
+		const FQuat SolvedLocalRotation = m_IKChains.GetRotation(ChainIndex, iLink - 1).Inverse() * m_IKChains.GetRotation(ChainIndex, iLink);
+		const FQuat Offset = m_IKChains.LocalTransforms[FirstLink + iLink].GetRotation().Inverse() * SolvedLocalRotation;
+
+		// First solve blends in from the animated pose
+		m_IKPrevLocalOffsets[FirstLink + iLink] = bHadOffsets ? m_IKLastLocalOffsets[FirstLink + iLink] : FQuat::Identity;
+		m_IKLastLocalOffsets[FirstLink + iLink] = Offset.GetNormalized();
+	}
+
+	m_IKChainHasLocalOffsets[ChainIndex] = true;
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::ApplyChainLocalOffsets(int32 ChainIndex, float Alpha)
+{
+	const int32 FirstLink = m_IKChains.GetFirstLink(ChainIndex);
+
+	// Offsets are applied on top of this frame's animated pose, so the limb follows the body between solves
+	FTransform ParentTransform = m_IKChains.GetTransform(ChainIndex, 0);
+	for (int32 iLink = 1; iLink < m_IKChains.GetNumLinks(ChainIndex); iLink++)
+	{
+		const FQuat Offset = FQuat::Slerp(m_IKPrevLocalOffsets[FirstLink + iLink], m_IKLastLocalOffsets[FirstLink + iLink], Alpha);
+		const FTransform& LocalTransform = m_IKChains.LocalTransforms[FirstLink + iLink];
+		const FTransform OffsetLocalTransform(LocalTransform.GetRotation() * Offset, LocalTransform.GetTranslation(), LocalTransform.GetScale3D());
+		ParentTransform = OffsetLocalTransform * ParentTransform;
+		m_IKChains.SetTransform(ChainIndex, iLink, ParentTransform);
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::SolveIKChains(FVector* CSChainTargets, int32 NumEffectors)
+{
+	for (FCCDIKChainFrameStats& ChainStats : m_IKChainFrameStats)
+	{
+		ChainStats = FCCDIKChainFrameStats();
+	}
+
+	const FCCDIKLODSettings* LODSettings = GetResolvedChains().LODSettings.IsValidIndex(m_CurrentIKLOD) ? &GetResolvedChains().LODSettings[m_CurrentIKLOD] : nullptr;
+
+	CCDIKSolverCore::FSolveSettings Settings;
+	Settings.Precision = LODSettings ? LODSettings->Precision : Precision;
+	Settings.MaxIterations = LODSettings ? LODSettings->MaxIterations : MaxIterations;
+	Settings.bStartFromTail = bStartFromTail;
+	Settings.bEnableRotationLimit = bEnableRotationLimit;
+	Settings.bDeterministic = bDeterministicSolve;
+
+	// Throttled levels solve every Nth frame, with a per node phase so characters do not all solve on the same frame.
+	// Deterministic nodes share phase zero, so a replica solves on the same frames as the instance it replays.
+	const uint32 UpdatePhase = bDeterministicSolve ? 0 : m_IKUpdatePhase;
+	m_IKUpdateInterval = LODSettings ? FMath::Max(LODSettings->UpdateInterval, 1) : 1;
+	bool bSolveFrame = true;
+	float PredictionTime = 0.f;
+	if (LODSettings && LODSettings->SolveRate > 0.f)
+	{
+		// Rate limited: the phase is a time offset, and blending follows elapsed time rather than evaluations
+		const float SolvePeriod = 1.f / LODSettings->SolveRate;
+		if (m_IKUpdateFrame++ == 0)
+		{
+			m_IKTimeSinceSolve = SolvePeriod * float(UpdatePhase % 1024) / 1024.f;
+		}
+		m_IKTimeSinceSolve += m_IKPendingDeltaTime;
+		bSolveFrame = m_IKTimeSinceSolve >= SolvePeriod;
+		if (bSolveFrame)
+		{
+			m_IKTimeSinceSolve = FMath::Fmod(m_IKTimeSinceSolve, SolvePeriod);
+		}
+		m_IKInterpolationAlpha = FMath::Clamp(m_IKTimeSinceSolve / SolvePeriod, 0.f, 1.f);
+		m_bIKThrottled = true;
+
+		// Fully blended in when the next solve is due
+		PredictionTime = SolvePeriod - m_IKTimeSinceSolve;
+	}
+	else
+	{
+		const int32 FrameInInterval = (m_IKUpdateFrame++ + UpdatePhase) % m_IKUpdateInterval;
+		bSolveFrame = FrameInInterval == 0;
+		m_IKInterpolationAlpha = float(FrameInInterval + 1) / float(m_IKUpdateInterval);
+		m_bIKThrottled = m_IKUpdateInterval > 1;
+
+		// Fully blended in on the last frame of the interval, assuming frames keep their current length
+		PredictionTime = float(m_IKUpdateInterval - 1) * m_IKPendingDeltaTime;
+	}
+	m_IKPendingDeltaTime = 0.f;
+
+	PredictChainTargets(CSChainTargets, NumEffectors, bSolveFrame && m_bIKThrottled ? PredictionTime : 0.f);
+
+	// Flags are not pinnable, this only does work after they were edited
+	SelectChainSolveFunctions();
+
+	// Chains pulling on shared bones and on the pelvis cannot be solved one by one, nor skipped or batched
+	if (GetResolvedChains().FullBody.bEnabled)
+	{
+		SolveFullBody(CSChainTargets, NumEffectors, Settings, bSolveFrame);
+		return;
+	}
+
+	int32 NumJobs = 0;
+
+	// One solve per chain per frame, in hierarchy order
+	for (int32 iChain : m_IKChainSolveOrder)
+	{
+		if (!ShouldSolveChain(iChain, NumEffectors))
+		{
+			m_IKChainHasLocalOffsets[iChain] = false;
+			continue;
+		}
+
+		// Chains below a queued one start from its solved bones, so the queue is drained first
+		if (NumJobs > 0 && m_IKChainHasCouplingSource[iChain])
+		{
+			SolveBatchJobs(NumJobs);
+			NumJobs = 0;
+		}
+
+		// Between solves, blend towards the latest solution on top of the current pose
+		if (!bSolveFrame && m_IKChainHasLocalOffsets[iChain])
+		{
+			ApplyChainLocalOffsets(iChain, m_IKInterpolationAlpha);
+			m_IKChainFrameStats[iChain].bUpdated = true;
+			m_IKChainFrameStats[iChain].bInterpolated = true;
+			PropagateSharedLinks(iChain);
+			continue;
+		}
+
+		const FVector& Target = CSChainTargets[iChain];
+
+		CCDIKSolverCore::FSolveSettings ChainSettings = Settings;
+		ChainSettings.Backend = m_IKChainBackend[iChain];
+		ChainSettings.Damping = m_IKChainDamping[iChain];
+		m_IKChainFrameStats[iChain].Backend = ChainSettings.Backend;
+
+		// Another character may already have solved this chain input. Looked up before warm starting replaces the input pose.
+		if (bUseSharedSolveCache && !bDeterministicSolve && m_SharedBoneData.IsValid())
+		{
+			const uint64 SharedSolveKey = MakeSharedSolveKey(iChain, Target, ChainSettings);
+			const uint32 InputPoseHash = bEnableTemporalCache ? HashChainInput(m_IKChains.Views[iChain]) : 0;
+			CCDIKSolverCore::FSolveResult SharedResult;
+			if (FCCDIKSolveCache::Get().Find(SharedSolveKey, m_SharedBoneData->SolveCacheId, m_IKChains.Views[iChain], SharedResult.bUpdated))
+			{
+				// Recorded like a solve from this input, so later frames skip or warm start from the shared solution
+				if (bEnableTemporalCache)
+				{
+					m_IKChainHistory[iChain].Effector = Target;
+					m_IKChainHistory[iChain].InputPoseHash = InputPoseHash;
+				}
+				SharedResult.TipError = FVector::Dist(m_IKChains.GetLocation(iChain, m_IKChains.GetNumLinks(iChain) - 1), Target);
+				m_IKChainFrameStats[iChain].bSharedCacheHit = true;
+				INC_DWORD_STAT(STAT_CCDIK_SharedCacheHits);
+				ApplyChainSolveResult(iChain, ChainSettings, SharedResult);
+				PropagateSharedLinks(iChain);
+				continue;
+			}
+			m_IKChainFrameStats[iChain].SharedSolveKey = SharedSolveKey;
+			INC_DWORD_STAT(STAT_CCDIK_SharedCacheMisses);
+		}
+
+		CCDIKSolverCore::FSolveResult SkippedResult;
+		if (!PrepareChainSolve(iChain, Target, ChainSettings, SkippedResult))
+		{
+			ApplyChainSolveResult(iChain, ChainSettings, SkippedResult);
+			PropagateSharedLinks(iChain);
+			continue;
+		}
+
+#if CCDIK_CAPTURE
+		// Recorded after warm starting, so a replay sees exactly what the solver saw
+		if (FCCDIKCaptureRecorder::IsRecording())
+		{
+			const float CaptureTarget[3] = { Target.X, Target.Y, Target.Z };
+			FCCDIKCaptureRecorder::Get().Record(m_GameThreadSnapshot.MeshName, m_IKChains.Views[iChain], CaptureTarget, ChainSettings);
+		}
+#endif // CCDIK_CAPTURE
+
+		// The batch queue solves CCD lanes only, other backends and deterministic solves run inline
+		if (bUseBatchSolve && !bDeterministicSolve && ChainSettings.Backend == CCDIKSolverCore::ESolverBackend::CCD)
+		{
+			// Queued until the loop is done or a chain depending on it comes up, then solved in lane groups together with
+			// whatever other characters have queued at that moment. Chains sharing bones are only coupled through PropagateSharedLinks.
+			FCCDIKBatchJob& Job = m_BatchJobs[NumJobs];
+			Job.Chain = m_IKChains.Views[iChain];
+			Job.Target[0] = Target.X;
+			Job.Target[1] = Target.Y;
+			Job.Target[2] = Target.Z;
+			Job.Settings = ChainSettings;
+			m_BatchJobChainIndex[NumJobs] = iChain;
+			NumJobs++;
+			continue;
+		}
+
+		const float TargetArray[3] = { Target.X, Target.Y, Target.Z };
+		ApplyChainSolveResult(iChain, ChainSettings, m_IKChainSolveFunctions[iChain](m_IKChains.Views[iChain], TargetArray, ChainSettings));
+		PropagateSharedLinks(iChain);
+	}
+
+	if (NumJobs > 0)
+	{
+		SolveBatchJobs(NumJobs);
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::SolveBatchJobs(int32 NumJobs)
+{
+	FCCDIKOpportunisticBatcher::Get().Solve(m_BatchOwner, m_BatchJobs.GetData(), NumJobs);
+
+	// Jobs were queued in solve order, so ancestors still propagate before the chains below them
+	for (int32 iJob = 0; iJob < NumJobs; iJob++)
+	{
+		ApplyChainSolveResult(m_BatchJobChainIndex[iJob], m_BatchJobs[iJob].Settings, m_BatchJobs[iJob].Result);
+		PropagateSharedLinks(m_BatchJobChainIndex[iJob]);
+	}
+}
+
+void FCCDIKEffectorHistory::Add(const FVector& Location, double Time)
+{
+	Locations[Head] = Location;
+	Times[Head] = Time;
+	Head = (Head + 1) % Capacity;
+	Num = FMath::Min(Num + 1, Capacity);
+}
+
+FVector FCCDIKEffectorHistory::Predict(double Time) const
+{
+	const int32 Newest = (Head + Capacity - 1) % Capacity;
+	if (Num < 2)
+	{
+		return Num > 0 ? Locations[Newest] : FVector::ZeroVector;
+	}
+
+	// Velocity over the whole buffer rather than the last step, a single uneven tick does not throw the prediction off
+	const int32 Oldest = (Head + Capacity - Num) % Capacity;
+	const double Span = Times[Newest] - Times[Oldest];
+	if (Span <= SMALL_NUMBER)
+	{
+		return Locations[Newest];
+	}
+
+	const FVector Velocity = (Locations[Newest] - Locations[Oldest]) / float(Span);
+	return Locations[Newest] + Velocity * float(Time - Times[Newest]);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::PredictChainTargets(FVector* CSChainTargets, int32 NumEffectors, float PredictionTime)
+{
+	if (!bPredictEffectors || bDeterministicSolve)
+	{
+		return;
+	}
+
+	const int32 NumChains = m_IKChains.Num();
+	if (m_IKEffectorHistory.Num() != NumChains)
+	{
+		m_IKEffectorHistory.SetNum(NumChains);
+	}
+
+	const double PredictedTime = m_IKTime + FMath::Min(PredictionTime, MaxPredictionTime);
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		FCCDIKEffectorHistory& History = m_IKEffectorHistory[iChain];
+		if (!ShouldSolveChain(iChain, NumEffectors))
+		{
+			// Samples from before the chain was switched off say nothing about where its effector goes next
+			History.Reset();
+			continue;
+		}
+
+		History.Add(CSChainTargets[iChain], m_IKTime);
+		if (PredictionTime > 0.f)
+		{
+			CSChainTargets[iChain] = History.Predict(PredictedTime);
+		}
+	}
+}
+
+//FUNCTION CREATED BY ME
+bool FAnimNode_CCDIK::ShouldSolveChain(int32 ChainIndex, int32 NumEffectors) const
+{
+	return m_IKChainEffectorIndex[ChainIndex] < NumEffectors && IsChainActiveAtLOD(ChainIndex);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::SolveFullBody(const FVector* CSChainTargets, int32 NumEffectors, const CCDIKSolverCore::FSolveSettings& Settings, bool bSolveFrame)
+{
+	const int32 NumChains = m_IKChains.Num();
+	const int32 NumPasses = FMath::Max(GetResolvedChains().FullBody.Passes, 1);
+
+	// Throttled frames blend every chain towards its latest solution, unless a chain has none yet
+	for (int32 iChain = 0; iChain < NumChains && !bSolveFrame; iChain++)
+	{
+		bSolveFrame = ShouldSolveChain(iChain, NumEffectors) && !m_IKChainHasLocalOffsets[iChain];
+	}
+
+	// Pelvis moves first and carries every chain below it, throttled frames keep the latest offset
+	if (bSolveFrame)
+	{
+		m_PelvisOffset = ComputePelvisOffset(CSChainTargets, NumEffectors);
+	}
+	ApplyPelvisOffset(m_PelvisOffset);
+
+	CCDIKSolverCore::FSolveResult* Results = m_FrameArena.Alloc<CCDIKSolverCore::FSolveResult>(NumChains);
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		Results[iChain] = CCDIKSolverCore::FSolveResult();
+	}
+
+	// Every pass solves each chain from the shared bones the chains before it left, so the error of one limb
+	// is taken up by the spine the others also rotate instead of each limb owning a copy of it
+	CCDIKSolverCore::FSolveSettings PassSettings = Settings;
+	PassSettings.MaxIterations = FMath::DivideAndRoundUp(FMath::Max(Settings.MaxIterations, 1), NumPasses);
+	for (int32 Pass = 0; Pass < NumPasses && bSolveFrame; Pass++)
+	{
+		for (int32 iChain : m_IKChainSolveOrder)
+		{
+			if (!ShouldSolveChain(iChain, NumEffectors))
+			{
+				continue;
+			}
+
+			const FVector& Target = CSChainTargets[iChain];
+			const float TargetArray[3] = { Target.X, Target.Y, Target.Z };
+			PassSettings.Backend = m_IKChainBackend[iChain];
+			PassSettings.Damping = m_IKChainDamping[iChain];
+
+			const CCDIKSolverCore::FSolveResult PassResult = m_IKChainSolveFunctions[iChain](m_IKChains.Views[iChain], TargetArray, PassSettings);
+			Results[iChain].Iterations += PassResult.Iterations;
+			Results[iChain].bUpdated |= PassResult.bUpdated;
+			PropagateSharedLinks(iChain);
+		}
+	}
+
+	CCDIKSolverCore::FSolveSettings ChainSettings = Settings;
+	ChainSettings.MaxIterations = PassSettings.MaxIterations * NumPasses;
+	for (int32 iChain : m_IKChainSolveOrder)
+	{
+		if (!ShouldSolveChain(iChain, NumEffectors))
+		{
+			m_IKChainHasLocalOffsets[iChain] = false;
+			continue;
+		}
+
+		FCCDIKChainFrameStats& ChainStats = m_IKChainFrameStats[iChain];
+		if (bSolveFrame)
+		{
+			// Chains solved early in the last pass may have been moved since, the error is measured on the final pose
+			const int32 TipLink = m_IKChains.GetNumLinks(iChain) - 1;
+			Results[iChain].TipError = FVector::Dist(m_IKChains.GetLocation(iChain, TipLink), CSChainTargets[iChain]);
+			ChainSettings.Backend = m_IKChainBackend[iChain];
+			ChainStats.Backend = ChainSettings.Backend;
+			ApplyChainSolveResult(iChain, ChainSettings, Results[iChain]);
+		}
+		else
+		{
+			ApplyChainLocalOffsets(iChain, m_IKInterpolationAlpha);
+			ChainStats.bUpdated = true;
+			ChainStats.bInterpolated = true;
+		}
+
+		// Blending rebuilt this chain from local offsets, chains sharing its bones follow again
+		PropagateSharedLinks(iChain);
+	}
+}
+
+//FUNCTION CREATED BY ME
+FVector FAnimNode_CCDIK::ComputePelvisOffset(const FVector* CSChainTargets, int32 NumEffectors) const
+{
+	const FCCDIKFullBodySettings& FullBody = GetResolvedChains().FullBody;
+	if (!m_FullBodyPelvisIndex.IsValid() || FullBody.PelvisOffsetWeight <= 0.f || FullBody.MaxPelvisOffset <= 0.f)
+	{
+		return FVector::ZeroVector;
+	}
+
+	FVector OutOfReach = FVector::ZeroVector;
+	int32 NumPelvisChains = 0;
+	for (int32 iChain = 0; iChain < m_IKChains.Num(); iChain++)
+	{
+		const int32 NumLinks = m_IKChains.GetNumLinks(iChain);
+		if (m_IKChainPelvisFirstLink[iChain] == INDEX_NONE || NumLinks < 2 || !ShouldSolveChain(iChain, NumEffectors))
+		{
+			continue;
+		}
+
+		// The first rotating link at or below the pelvis stays put while the chain solves, the tip reaches
+		// no further from it than the bone lengths below it add up to
+		const int32 AnchorLink = FMath::Max(m_IKChainPelvisFirstLink[iChain], 1);
+		float Reach = 0.f;
+		for (int32 iLink = AnchorLink + 1; iLink < NumLinks; iLink++)
+		{
+			Reach += FVector::Dist(m_IKChains.GetLocation(iChain, iLink - 1), m_IKChains.GetLocation(iChain, iLink));
+		}
+
+		const FVector ToTarget = CSChainTargets[iChain] - m_IKChains.GetLocation(iChain, AnchorLink);
+		const float Distance = ToTarget.Size();
+		if (Distance > Reach)
+		{
+			OutOfReach += ToTarget * ((Distance - Reach) / Distance);
+		}
+
+		// Chains within reach count too, a planted foot holds the pelvis back from a hand reaching away
+		NumPelvisChains++;
+	}
+
+	if (NumPelvisChains == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	return (OutOfReach * (FullBody.PelvisOffsetWeight / NumPelvisChains)).GetClampedToMaxSize(FullBody.MaxPelvisOffset);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::ApplyPelvisOffset(const FVector& Offset)
+{
+	if (Offset.IsNearlyZero())
+	{
+		return;
+	}
+
+	for (int32 iChain = 0; iChain < m_IKChains.Num(); iChain++)
+	{
+		const CCDIKSolverCore::FChainView& View = m_IKChains.Views[iChain];
+		const int32 FirstPelvisLink = m_IKChainPelvisFirstLink[iChain];
+		for (int32 iLink = FirstPelvisLink; FirstPelvisLink != INDEX_NONE && iLink < View.NumLinks; iLink++)
+		{
+			View.PosX[iLink] += Offset.X;
+			View.PosY[iLink] += Offset.Y;
+			View.PosZ[iLink] += Offset.Z;
+		}
+	}
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::PropagateSharedLinks(int32 SourceChain)
+{
+	for (const FCCDIKChainCoupling& Coupling : m_ChainCouplings)
+	{
+		if (Coupling.SourceChain != SourceChain)
+		{
+			continue;
+		}
+
+		// Shared links take the source transform, the links below them move rigidly with the last shared one
+		FVector OldAnchor = FVector::ZeroVector;
+		FVector NewAnchor = FVector::ZeroVector;
+		FQuat DeltaRotation = FQuat::Identity;
+		for (int32 PairIndex = Coupling.FirstLinkPair; PairIndex < Coupling.FirstLinkPair + Coupling.NumLinkPairs; PairIndex++)
+		{
+			const FIntPoint& LinkPair = m_CouplingLinkPairs[PairIndex];
+			const FVector OldLocation = m_IKChains.GetLocation(Coupling.TargetChain, LinkPair.X);
+			const FQuat OldRotation = m_IKChains.GetRotation(Coupling.TargetChain, LinkPair.X);
+
+			FVector NewLocation;
+			FQuat NewRotation;
+			if (LinkPair.Y != INDEX_NONE)
+			{
+				NewLocation = m_IKChains.GetLocation(SourceChain, LinkPair.Y);
+				NewRotation = m_IKChains.GetRotation(SourceChain, LinkPair.Y);
+				DeltaRotation = NewRotation * OldRotation.Inverse();
+				OldAnchor = OldLocation;
+				NewAnchor = NewLocation;
+			}
+			else
+			{
+				NewLocation = NewAnchor + DeltaRotation.RotateVector(OldLocation - OldAnchor);
+				NewRotation = (DeltaRotation * OldRotation).GetNormalized();
+			}
+
+			m_IKChains.SetTransform(Coupling.TargetChain, LinkPair.X, FTransform(NewRotation, NewLocation));
+		}
+	}
+}
+
+//FUNCTION CREATED BY ME
+//CCDIK UPDATE
+//void FAnimNode_CCDIK::ApplyIKSolveBatch(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
+void FAnimNode_CCDIK::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(EvaluateSkeletalControl_AnyThread)
+	SCOPE_CYCLE_COUNTER(STAT_CCDIK_Evaluate);
+	CSV_SCOPED_TIMING_STAT(CCDIK, Evaluate);
+	const uint64 EvaluateStartCycles = FPlatformTime::Cycles64();
+	FCCDIKNodeAllocations AllocationsBefore;
+	GetNodeAllocations(AllocationsBefore);
+	m_FrameArena.Reset();
+
+	// Only the snapshot taken in PreUpdate is read from here on, never the component
+	const FCCDIKGameThreadSnapshot& Snapshot = m_GameThreadSnapshot;
+	if (!Snapshot.bValid)
+	{
+		return;
+	}
+
+	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
+	AdoptSharedBoneData();
+
+	//If the LOD has changed, re-cache link bones
+	if (Snapshot.PredictedLODLevel != m_LastBoneIndicesCacheLOD)
+	{
+		m_LastBoneIndicesCacheLOD = Snapshot.PredictedLODLevel;
+
+		// The compact pose changed with the LOD, so the chain topology has to be rebuilt
+		m_IKChainsDirty = true;
+	}
+
+	if (m_IKChainsDirty)
+	{
+		RebuildIKChains(BoneContainer);
+	}
+
+	m_CurrentIKLOD = GetResolvedChains().FindLODSettings(Snapshot.PredictedLODLevel, Significance);
+
+	// Update effector locations if they are based off a bone position
+	const FTransform& ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
+	const int32 NumEffectors = GetNumEffectors();
+	FVector* CSEffectorLocations = m_FrameArena.Alloc<FVector>(NumEffectors);
+	CSEffectorLocations[0] = GetTargetTransform(ComponentTransform, Output.Pose, EffectorTarget, EffectorLocationSpace, EffectorLocation).GetLocation();
+	CSEffectorLocations[1] = GetTargetTransform(ComponentTransform, Output.Pose, EffectorTarget2, EffectorLocationSpace2, EffectorLocation2).GetLocation();
+	for (int32 iEffector = 0; iEffector < AdditionalEffectors.Num(); iEffector++)
+	{
+		FCCDIKEffectorTarget& Effector = AdditionalEffectors[iEffector];
+		CSEffectorLocations[2 + iEffector] = GetTargetTransform(ComponentTransform, Output.Pose, Effector.EffectorTarget, Effector.EffectorLocationSpace, Effector.EffectorLocation).GetLocation();
+	}
+
+	// One target per chain, retargeted from the rig the effectors were authored for: a multiply-add per chain
+	int32 NumIKActions = m_IKChains.Num();
+	FVector* CSChainTargets = m_FrameArena.Alloc<FVector>(NumIKActions);
+	for (int32 iChain = 0; iChain < NumIKActions; iChain++)
+	{
+		const int32 EffectorIndex = m_IKChainEffectorIndex[iChain];
+		const FVector& Effector = EffectorIndex < NumEffectors ? CSEffectorLocations[EffectorIndex] : FVector::ZeroVector;
+		CSChainTargets[iChain] = m_IKChainRetargetOffset[iChain] + Effector * m_IKChainRetargetScale[iChain];
+	}
+	ApplyGroundContacts(ComponentTransform, CSChainTargets, NumEffectors);
+
+	RefreshIKChainTransforms(Output.Pose);
+
+	m_IKTime += m_IKPendingDeltaTime;
+	SolveIKChains(CSChainTargets, NumEffectors);
+
+	// Only bones the solver moved go back to the base class, untouched bones keep the input pose for free
+	const int32 BonesWritten = GetSolvedBoneTransforms(OutBoneTransforms);
+
+#if CCDIK_DEBUG_DRAW
+	if (bDrawDebugChains)
+	{
+		for (int32 iChain = 0; iChain < NumIKActions; iChain++)
+		{
+			const int32 NumChainLinks = m_IKChains.GetNumLinks(iChain);
+			const FColor ChainColor = m_IKChainFrameStats[iChain].bUpdated ? FColor::Green : FColor::Silver;
+			for (int32 LinkIndex = 1; LinkIndex < NumChainLinks; LinkIndex++)
+			{
+				DrawLine(m_IKChains.GetLocation(iChain, LinkIndex - 1), m_IKChains.GetLocation(iChain, LinkIndex), ChainColor, 1.f);
+			}
+
+			const int32 EffectorIndex = m_IKChainEffectorIndex[iChain];
+			if (NumChainLinks > 0 && EffectorIndex < NumEffectors)
+			{
+				DrawLine(m_IKChains.GetLocation(iChain, NumChainLinks - 1), CSChainTargets[iChain], FColor::Red, 0.5f);
+			}
+		}
+	}
+#endif // CCDIK_DEBUG_DRAW
+
+	UpdateNodeStats(EvaluateStartCycles, AllocationsBefore);
+	m_NodeStats.BonesWritten = BonesWritten;
+	m_NodeStats.PelvisOffset = m_PelvisOffset.Size();
+	INC_DWORD_STAT_BY(STAT_CCDIK_BonesWritten, BonesWritten);
+	CSV_CUSTOM_STAT(CCDIK, BonesWritten, BonesWritten, ECsvCustomStatOp::Accumulate);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::GetNodeAllocations(FCCDIKNodeAllocations& OutAllocations) const
+{
+	OutAllocations.NumContainers = 0;
+	OutAllocations.ArenaSize = m_FrameArena.GetAllocatedSize();
+	OutAllocations.Add(m_IKChains);
+	OutAllocations.Add(m_IKChainEffectorIndex);
+	OutAllocations.Add(m_IKChainBackend);
+	OutAllocations.Add(m_IKChainDamping);
+	OutAllocations.Add(m_IKChainRetargetScale);
+	OutAllocations.Add(m_IKChainRetargetOffset);
+	OutAllocations.Add(m_IKChainSolveOrder);
+	OutAllocations.Add(m_IKChainFrameStats);
+	OutAllocations.Add(m_IKChainHistory);
+	OutAllocations.Add(m_ChainHistoryData);
+	OutAllocations.Add(m_IKChainDescriptorIndex);
+	OutAllocations.Add(m_IKChainLODActive);
+	OutAllocations.Add(m_IKPrevLocalOffsets);
+	OutAllocations.Add(m_IKLastLocalOffsets);
+	OutAllocations.Add(m_IKChainHasLocalOffsets);
+	OutAllocations.Add(m_BatchJobs);
+	OutAllocations.Add(m_BatchJobChainIndex);
+	OutAllocations.Add(m_IKChainSolveFunctions);
+	OutAllocations.Add(m_IKEffectorHistory);
+	OutAllocations.Add(m_IKChainGroundContact);
+	OutAllocations.Add(m_EvaluationSnapshot.ContactQueryLocations);
+	OutAllocations.Add(m_EvaluationSnapshot.ContactQueryValid);
+	OutAllocations.Add(m_ChainCouplings);
+	OutAllocations.Add(m_CouplingLinkPairs);
+	OutAllocations.Add(m_IKChainHasCouplingSource);
+	OutAllocations.Add(m_IKChainPelvisFirstLink);
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::UpdateNodeStats(uint64 EvaluateStartCycles, const FCCDIKNodeAllocations& AllocationsBefore)
+{
+	m_NodeStats = FCCDIKNodeStats();
+	for (const FCCDIKChainFrameStats& ChainStats : m_IKChainFrameStats)
+	{
+		if (ChainStats.SolvesThisFrame == 0 || ChainStats.bSkipped)
+		{
+			continue;
+		}
+
+		m_NodeStats.ChainsSolved++;
+		m_NodeStats.TotalIterations += ChainStats.Iterations;
+		m_NodeStats.ChainsConverged += ChainStats.bConverged ? 1 : 0;
+		m_NodeStats.ChainsHitMaxIterations += ChainStats.bHitMaxIterations ? 1 : 0;
+		m_NodeStats.MaxTipError = FMath::Max(m_NodeStats.MaxTipError, ChainStats.TipError);
+
+		const int32 BackendIndex = (int32)ChainStats.Backend;
+		m_NodeStats.ChainsSolvedPerBackend[BackendIndex]++;
+		m_NodeStats.IterationsPerBackend[BackendIndex] += ChainStats.Iterations;
+		m_NodeStats.ChainsConvergedPerBackend[BackendIndex] += ChainStats.bConverged ? 1 : 0;
+	}
+
+	FCCDIKNodeAllocations AllocationsAfter;
+	GetNodeAllocations(AllocationsAfter);
+	const SIZE_T AllocatedSizeBefore = AllocationsBefore.GetTotal();
+	const SIZE_T AllocatedSizeAfter = AllocationsAfter.GetTotal();
+	m_NodeStats.BytesAllocated = AllocatedSizeAfter > AllocatedSizeBefore ? int64(AllocatedSizeAfter - AllocatedSizeBefore) : 0;
+	m_NodeStats.HeapAllocations = m_FrameArena.GetNumHeapAllocations() + AllocationsAfter.CountReallocationsSince(AllocationsBefore);
+	m_NodeStats.EvaluateSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - EvaluateStartCycles);
+
+	INC_DWORD_STAT_BY(STAT_CCDIK_Iterations, m_NodeStats.TotalIterations);
+	INC_DWORD_STAT_BY(STAT_CCDIK_ConvergedChains, m_NodeStats.ChainsConverged);
+	INC_DWORD_STAT_BY(STAT_CCDIK_MaxIterationChains, m_NodeStats.ChainsHitMaxIterations);
+	INC_DWORD_STAT_BY(STAT_CCDIK_CCDSolves, m_NodeStats.ChainsSolvedPerBackend[(int32)CCDIKSolverCore::ESolverBackend::CCD]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_CCDIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::CCD]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_FABRIKSolves, m_NodeStats.ChainsSolvedPerBackend[(int32)CCDIKSolverCore::ESolverBackend::FABRIK]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_FABRIKIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::FABRIK]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_DLSSolves, m_NodeStats.ChainsSolvedPerBackend[(int32)CCDIKSolverCore::ESolverBackend::DampedLeastSquares]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_DLSIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::DampedLeastSquares]);
+	INC_DWORD_STAT_BY(STAT_CCDIK_BytesAllocated, m_NodeStats.BytesAllocated);
+	INC_DWORD_STAT_BY(STAT_CCDIK_HeapAllocations, m_NodeStats.HeapAllocations);
+
+	// Frame totals over every node, for CSV captures and Insights
+	CSV_CUSTOM_STAT(CCDIK, ChainsSolved, m_NodeStats.ChainsSolved, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, Iterations, m_NodeStats.TotalIterations, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, CCDIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::CCD], ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, FABRIKIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::FABRIK], ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, DLSIterations, m_NodeStats.IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::DampedLeastSquares], ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, ChainsAtMaxIterations, m_NodeStats.ChainsHitMaxIterations, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, MaxTipError, m_NodeStats.MaxTipError, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(CCDIK, BytesAllocated, int32(m_NodeStats.BytesAllocated), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(CCDIK, HeapAllocations, m_NodeStats.HeapAllocations, ECsvCustomStatOp::Accumulate);
+}
+
+
+bool FAnimNode_CCDIK::IsValidToEvaluate(const USkeleton* Skeleton, const FBoneContainer& RequiredBones)
+{
+	//if (EffectorLocationSpace == BCS_ParentBoneSpace || EffectorLocationSpace == BCS_BoneSpace)
+	//{
+	//	if (!EffectorTarget.IsValidToEvaluate(RequiredBones))
+	//	{
+	//		return false;
+	//	}
+	//}
+
+	//// Allow evaluation if all parameters are initialized and TipBone is child of RootBone
+	//return
+	//	(
+	//		TipBone.IsValidToEvaluate(RequiredBones)
+	//		&& RootBone.IsValidToEvaluate(RequiredBones)
+	//		&& Precision > 0
+	//		&& RequiredBones.BoneIsChildOf(TipBone.BoneIndex, RootBone.BoneIndex)
+	//		);
+	return true;
+}
+
+
+
+void FAnimNode_CCDIK::UpdateInternal(const FAnimationUpdateContext& Context)
+{
+	FAnimNode_SkeletalControlBase::UpdateInternal(Context);
+
+	// Throttled ticks arrive with long delta times, rate limited solving and effector prediction work on elapsed time
+	m_IKPendingDeltaTime += Context.GetDeltaTime();
+}
+
+void FAnimNode_CCDIK::InitializeBoneReferences(const FBoneContainer& RequiredBones)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(InitializeBoneReferences)
+	EffectorTarget.InitializeBoneReferences(RequiredBones);
+	EffectorTarget2.InitializeBoneReferences(RequiredBones);
+	for (FCCDIKEffectorTarget& Effector : AdditionalEffectors)
+	{
+		Effector.EffectorTarget.InitializeBoneReferences(RequiredBones);
+	}
+
+	// Bone container changed, chain topology has to follow
+	AdoptSharedBoneData();
+	m_LastBoneIndicesCacheLOD = INDEX_NONE;
+	m_IKChainsDirty = true;
+	RebuildIKChains(RequiredBones);
+}
+
+void FAnimNode_CCDIK::GatherDebugData(FNodeDebugData& DebugData)
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(GatherDebugData)
+	FString DebugLine = DebugData.GetNodeName(this);
+	for (int32 iChain = 0; iChain < m_IKChainFrameStats.Num(); iChain++)
+	{
+		DebugLine += FString::Printf(TEXT(" Chain%d(Solved: %d)"), iChain, m_IKChainFrameStats[iChain].SolvesThisFrame);
+	}
+
+	if (bEnableTemporalCache)
+	{
+		int32 NumSkipped = 0;
+		int32 NumWarmStarted = 0;
+		for (const FCCDIKChainFrameStats& ChainStats : m_IKChainFrameStats)
+		{
+			NumSkipped += ChainStats.bSkipped ? 1 : 0;
+			NumWarmStarted += ChainStats.bWarmStarted ? 1 : 0;
+		}
+		DebugLine += FString::Printf(TEXT(" (Skipped: %d/%d, Warm started: %d/%d)"), NumSkipped, m_IKChainFrameStats.Num(), NumWarmStarted, m_IKChainFrameStats.Num());
+	}
+
+	if (bUseSharedSolveCache)
+	{
+		int32 NumHits = 0;
+		int32 NumLookups = 0;
+		for (const FCCDIKChainFrameStats& ChainStats : m_IKChainFrameStats)
+		{
+			NumHits += ChainStats.bSharedCacheHit ? 1 : 0;
+			NumLookups += ChainStats.bSharedCacheHit || ChainStats.SharedSolveKey != 0 ? 1 : 0;
+		}
+		const FCCDIKSolveCache::FStats CacheStats = FCCDIKSolveCache::Get().GetStats();
+		DebugLine += FString::Printf(TEXT(" (Shared cache: %d/%d hits, %.1f%% over all characters, %d/%d entries)"), NumHits, NumLookups, CacheStats.GetHitRate() * 100.f, CacheStats.Entries, CacheStats.MaxEntries);
+	}
+
+	if (m_CurrentIKLOD != INDEX_NONE)
+	{
+		const TArray<FCCDIKLODSettings>& LODSettings = GetResolvedChains().LODSettings;
+		if (LODSettings.IsValidIndex(m_CurrentIKLOD) && LODSettings[m_CurrentIKLOD].SolveRate > 0.f)
+		{
+			DebugLine += FString::Printf(TEXT(" (IK LOD: %d, Rate: %.1f Hz)"), m_CurrentIKLOD, LODSettings[m_CurrentIKLOD].SolveRate);
+		}
+		else
+		{
+			DebugLine += FString::Printf(TEXT(" (IK LOD: %d, Interval: %d)"), m_CurrentIKLOD, m_IKUpdateInterval);
+		}
+	}
+
+	DebugLine += FString::Printf(TEXT(" (Solved: %d, Iterations: %d, Converged: %d, At max: %d, Tip error: %.2f, Bones written: %d, Time: %.3fms, Allocated: %lld bytes in %d allocations)"),
+		m_NodeStats.ChainsSolved, m_NodeStats.TotalIterations, m_NodeStats.ChainsConverged, m_NodeStats.ChainsHitMaxIterations,
+		m_NodeStats.MaxTipError, m_NodeStats.BonesWritten, m_NodeStats.EvaluateSeconds * 1000.0, m_NodeStats.BytesAllocated, m_NodeStats.HeapAllocations);
+
+	if (bEnableGroundContact)
+	{
+		DebugLine += FString::Printf(TEXT(" (Contact rays: %d, skipped: %d)"), m_GameThreadSnapshot.ContactRays, m_GameThreadSnapshot.ContactRaysSkipped);
+	}
+
+	if (GetResolvedChains().FullBody.bEnabled)
+	{
+		DebugLine += FString::Printf(TEXT(" (Full body: %d couplings, pelvis offset %.2f)"), m_ChainCouplings.Num(), m_NodeStats.PelvisOffset);
+	}
+
+	static const TCHAR* BackendNames[(int32)CCDIKSolverCore::ESolverBackend::Num] = { TEXT("CCD"), TEXT("FABRIK"), TEXT("DLS") };
+	for (int32 BackendIndex = 0; BackendIndex < (int32)CCDIKSolverCore::ESolverBackend::Num; BackendIndex++)
+	{
+		if (m_NodeStats.ChainsSolvedPerBackend[BackendIndex] > 0)
+		{
+			DebugLine += FString::Printf(TEXT(" (%s: %d solved, %d iterations, %d converged)"), BackendNames[BackendIndex],
+				m_NodeStats.ChainsSolvedPerBackend[BackendIndex], m_NodeStats.IterationsPerBackend[BackendIndex], m_NodeStats.ChainsConvergedPerBackend[BackendIndex]);
+		}
+	}
+
+	DebugData.AddDebugItem(DebugLine);
+	ComponentPose.GatherDebugData(DebugData);
+}
+
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::DrawLine(FVector P1_in, FVector P2_in, FColor color, float thicknessMult)
+{
+#if CCDIK_DEBUG_DRAW
+	const float thickness = 3.0f;
+
+	// Component space, queued for the game thread. Drawn in the next PreUpdate together with every other line of this node.
+	if (m_DebugLineBuffer.IsValid())
+	{
+		m_DebugLineBuffer->Add(P1_in, P2_in, color, thickness * thicknessMult);
+	}
+#endif // CCDIK_DEBUG_DRAW
+}
+
+//FUNCTION CREATED BY ME
+void FAnimNode_CCDIK::printsmth()
+{
+	if (GEngine) 
+	{
+		FString Stringg = FString::Printf(TEXT("World delta for current frame equals %f"), 0);
+		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Yellow, Stringg);
+	}
+}
+
+
+
+//void FAnimNode_CCDIK::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
+//{
+//					// Store references to the context and out transforms
+//					m_ComponentSpacePoseContext = &Output;
+//					m_OutBoneTransforms = &OutBoneTransforms;
+//					// If the LOD has changed, re-cache link bones
+//					if (m_SkelComp->PredictedLODLevel != m_LastBoneIndicesCacheLOD)
+//					{
+//						const int32 NumBodies = m_SkelComp->Bodies.Num();
+//						if (m_LastBoneIndicesCacheLOD == -1) 
+//						{
+//							m_CachedBoneIndicesForCurrentLOD.SetNum(NumBodies);
+//						}
+//			
+//						m_LastBoneIndicesCacheLOD = m_SkelComp->PredictedLODLevel;
+//						const FBoneContainer& BoneContainer = m_ComponentSpacePoseContext->Pose.GetPose().GetBoneContainer();
+//						const auto& BoneIndices = BoneContainer.GetBoneIndicesArray();
+//						for (int32 iLinkOnCBR = 0; iLinkOnCBR < NumBodies; iLinkOnCBR++)
+//						{
+//							FBodyInstance* BodyInst = m_SkelComp->Bodies[iLinkOnCBR];
+//							const int32 BoneIndex = BodyInst->InstanceBoneIndex;
+//							m_CachedBoneIndicesForCurrentLOD[iLinkOnCBR] = BoneIndices.Find(BoneIndex);
+//						}
+//					}
+//
+//	//The purpose of the following operations up to the invocation of the solver, is to obtain a copy of the string of bones to be worked on, 
+//	//storing all its transforms in an array called Chain. Likewise, the transforms in component space are stored in another array called OutBoneTransforms.
+//
+//	DECLARE_SCOPE_HIERARCHICAL_COUNTER_ANIMNODE(EvaluateSkeletalControl_AnyThread)
+//	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
+//
+//	// Update EffectorLocation if it is based off a bone position
+//	FTransform CSEffectorTransform = GetTargetTransform(Output.AnimInstanceProxy->GetComponentTransform(), Output.Pose, EffectorTarget, EffectorLocationSpace, EffectorLocation);
+//	FVector const CSEffectorLocation = CSEffectorTransform.GetLocation();
+//
+//	// Gather all bone indices between root and tip.
+//	TArray<FCompactPoseBoneIndex> BoneIndices;
+//
+//	
+//	{	//Rootbone and TipBone index declaration
+//		const FCompactPoseBoneIndex RootIndex = RootBone.GetCompactPoseIndex(BoneContainer);
+//		FCompactPoseBoneIndex BoneIndex = TipBone.GetCompactPoseIndex(BoneContainer);
+//		//Fill the array by inserting one by one the indices of the bones in the 0 position and moving the previous ones to the right, until you reach the rootbone.
+//		do
+//		{
+//			BoneIndices.Insert(BoneIndex, 0);
+//			BoneIndex = Output.Pose.GetPose().GetParentBoneIndex(BoneIndex);
+//		} while (BoneIndex != RootIndex);
+//		BoneIndices.Insert(BoneIndex, 0);
+//	}
+//
+//	//Gather transforms and initialize OutBoneTransforms array
+//	int32 const NumTransforms = BoneIndices.Num();
+//	OutBoneTransforms.AddUninitialized(NumTransforms);
+//
+//	// Gather chain links and initialize Chain array. These are non zero length bones.
+//	TArray<FCCDIKChainLink> Chain;
+//	Chain.Reserve(NumTransforms);
+//
+//	//Start filling the arrays with Root Bone
+//	{
+//		const FCompactPoseBoneIndex& RootBoneIndex = BoneIndices[0];
+//		const FTransform& LocalTransform = Output.Pose.GetLocalSpaceTransform(RootBoneIndex);
+//		const FTransform& BoneCSTransform = Output.Pose.GetComponentSpaceTransform(RootBoneIndex);
+//
+//		//Add Rootbone to OutBoneTransforms array and Chain array in position 0
+//		OutBoneTransforms[0] = FBoneTransform(RootBoneIndex, BoneCSTransform);
+//		Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, 0));
+//	}
+//
+//	// Go through remaining transforms
+//	for (int32 TransformIndex = 1; TransformIndex < NumTransforms; TransformIndex++)
+//	{
+//		//Get the Bone Index
+//		const FCompactPoseBoneIndex& BoneIndex = BoneIndices[TransformIndex];
+//
+//		//Get CS and Local Transforms for that BoneIndex
+//		const FTransform& LocalTransform = Output.Pose.GetLocalSpaceTransform(BoneIndex);
+//		const FTransform& BoneCSTransform = Output.Pose.GetComponentSpaceTransform(BoneIndex);
+//		FVector const BoneCSPosition = BoneCSTransform.GetLocation();
+//
+//		//Fill OutBoneTransforms array
+//		OutBoneTransforms[TransformIndex] = FBoneTransform(BoneIndex, BoneCSTransform);
+//
+//		// Calculate the combined length of this segment of skeleton
+//		float const BoneLength = FVector::Dist(BoneCSPosition, OutBoneTransforms[TransformIndex - 1].Transform.GetLocation());
+//
+//		//If its big enough, fill Chain array
+//		if (!FMath::IsNearlyZero(BoneLength))
+//		{
+//			Chain.Add(FCCDIKChainLink(BoneCSTransform, LocalTransform, TransformIndex));
+//		}
+//		else
+//		{
+//			// Mark this transform as a zero length child of the last link.
+//			// It will inherit position and delta rotation from parent link.
+//			FCCDIKChainLink & ParentLink = Chain[Chain.Num() - 1];
+//			ParentLink.ChildZeroLengthTransformIndices.Add(TransformIndex);
+//		}
+//	}
+//
+//
+//	//Here we call the CCDIK solver defined in CCDIK.cpp
+//	bool bBoneLocationUpdated = AnimationCore::SolveCCDIK(Chain, CSEffectorLocation, Precision, MaxIterations, bEnableRotationLimit, RotationLimitPerJoints);
+//
+//							const FTransform& ComponentToWorld = m_SkelComp->GetComponentTransform();
+//							const FTransform& ComponentToWorldInv = ComponentToWorld.Inverse();
+//
+//							// Convert from articulation to anim bone
+//							for (int32 i = 0; i < m_InRagdollBones.Num(); i++)
+//							{
+//								int32 BoneIndex = m_InRagdollBones[i];
+//								FName boneName = m_SkelComp->SkeletalMesh->RefSkeleton.GetBoneName(BoneIndex);
+//								int32 BodyIndex = InAnimInstance->GetSkelMeshComponent()->GetPhysicsAsset()->FindBodyIndex(boneName);
+//								check(BodyIndex != INDEX_NONE);
+//								FTransform componentSpaceTransform = m_WorldSpaceBoneTM[BodyIndex] * ComponentToWorldInv;
+//								componentSpaceTransform.DiagnosticCheck_IsValid();
+//								m_OutBoneTransforms->Add(FBoneTransform(FCompactPoseBoneIndex(BoneIndex), componentSpaceTransform));
+//							}
+//
+//	// If we moved some bones, update bone transforms.
+//	if (bBoneLocationUpdated)
+//	{
+//		int32 NumChainLinks = Chain.Num();
+//
+//		// First step: update bone transform positions from chain links.
+//		for (int32 LinkIndex = 0; LinkIndex < NumChainLinks; LinkIndex++)
+//		{
+//			FCCDIKChainLink const & ChainLink = Chain[LinkIndex];
+//			//Store OutBoneTransforms with new current link transform
+//			OutBoneTransforms[ChainLink.TransformIndex].Transform = ChainLink.Transform;
+//
+//			// If there are any zero length children, update position of those
+//			int32 const NumChildren = ChainLink.ChildZeroLengthTransformIndices.Num();
+//			for (int32 ChildIndex = 0; ChildIndex < NumChildren; ChildIndex++)
+//			{
+//				OutBoneTransforms[ChainLink.ChildZeroLengthTransformIndices[ChildIndex]].Transform = ChainLink.Transform;
+//			}
+//		}
+//
+//		//DrawLine(Chain[2].Transform.GetLocation(), Chain[3].Transform.GetLocation(), FColor::Green, 10);
+//
+//#if WITH_EDITOR
+//		DebugLines.Reset(OutBoneTransforms.Num());
+//		DebugLines.AddUninitialized(OutBoneTransforms.Num());
+//		for (int32 Index = 0; Index < OutBoneTransforms.Num(); ++Index)
+//		{
+//			DebugLines[Index] = OutBoneTransforms[Index].Transform.GetLocation();
+//		}
+//#endif // WITH_EDITOR
+//
+//	}
+//}
+
+
+
+
@@ -1,150 +1,680 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "AnimNode_SkeletalControlBase.h"
-#include "CCDIK.h"
-#include "AnimNode_CCDIK.generated.h"
-
-/**
-*	Controller which implements the CCDIK IK approximation algorithm
-*/
-USTRUCT()
-struct ANIMGRAPHRUNTIME_API FAnimNode_CCDIK : public FAnimNode_SkeletalControlBase
-{
-	GENERATED_USTRUCT_BODY()
-
-	/** Coordinates for target location of tip bone - if EffectorLocationSpace is bone, this is the offset from Target Bone to use as target location*/
-	UPROPERTY(EditAnywhere, Category = Effector, meta = (PinShownByDefault))
-	FVector EffectorLocation;
-
-	/** Reference frame of Effector Transform. */
-	UPROPERTY(EditAnywhere, Category = Effector)
-	TEnumAsByte<enum EBoneControlSpace> EffectorLocationSpace;
-
-	/** If EffectorTransformSpace is a bone, this is the bone to use. **/
-	UPROPERTY(EditAnywhere, Category = Effector)
-	FBoneSocketTarget EffectorTarget;
-
-			/** Coordinates for target location of tip bone - if EffectorLocationSpace is bone, this is the offset from Target Bone to use as target location*/
-			UPROPERTY(EditAnywhere, Category = Effector, meta = (PinShownByDefault))
-				FVector EffectorLocation2;
-
-			/** Reference frame of Effector Transform. */
-			UPROPERTY(EditAnywhere, Category = Effector)
-				TEnumAsByte<enum EBoneControlSpace> EffectorLocationSpace2;
-
-			/** If EffectorTransformSpace is a bone, this is the bone to use. **/
-			UPROPERTY(EditAnywhere, Category = Effector)
-				FBoneSocketTarget EffectorTarget2;
-
-	/** Name of tip bone */
-	UPROPERTY(EditAnywhere, Category = Solver)
-	FBoneReference TipBone;
-
-	/** Name of the root bone*/
-	UPROPERTY(EditAnywhere, Category = Solver)
-	FBoneReference RootBone;
-
-	/** Tolerance for final tip location delta from EffectorLocation*/
-	UPROPERTY(EditAnywhere, Category = Solver)
-	float Precision;
-
-	/** Maximum number of iterations allowed, to control performance. */
-	UPROPERTY(EditAnywhere, Category = Solver)
-	int32 MaxIterations;
-
-	/** Toggle drawing of axes to debug joint rotation*/
-	UPROPERTY(EditAnywhere, Category = Solver)
-	bool bStartFromTail;
-
-	/** Tolerance for final tip location delta from EffectorLocation*/
-	UPROPERTY(EditAnywhere, Category = Solver)
-	bool bEnableRotationLimit;
-
-	TArray<TArray<FCCDIKChainLink>> IKChainList;
-
-
-	UWorld* m_MyWorld;
-	USkeletalMeshComponent* m_SkelComp;
-	TArray<FTransform> m_WorldSpaceBoneTM;
-	FComponentSpacePoseContext* m_ComponentSpacePoseContext;
-	int32 m_LastBoneIndicesCacheLOD = -1;
-	TArray<int32> m_CachedBoneIndicesForCurrentLOD;
-	TArray<FBoneTransform>* m_OutBoneTransforms;
-	TArray<FBoneIndexType> m_InRagdollBones;
-	bool m_UpdateBoneMapCrated = false;
-	
-	
-	//these FBoneIndexTypes are bones of interest
-	FBoneIndexType m_Spine02Bone;
-	FBoneIndexType m_RightClavicleBone;
-	FBoneIndexType m_RightHandBone;
-	FBoneIndexType m_LeftThighBone;
-	FBoneIndexType m_LeftFootBone;
-
-
-private:
-	/** symmetry rotation limit per joint. Index 0 matches with root bone and last index matches with tip bone. */
-	UPROPERTY(EditAnywhere, EditFixedSize, Category = Solver)
-	TArray<float> RotationLimitPerJoints;
-
-				/** symmetry rotation limit per joint. Index 0 matches with root bone and last index matches with tip bone. */
-				UPROPERTY(EditAnywhere, EditFixedSize, Category = Solver)
-				TArray<float> RotationLimitPerJoints2;
-
-public:
-	FAnimNode_CCDIK();
-	//FAnimNode_CCDIK(FVector _EffectorLocation, FBoneIndexType _TipBone, FBoneIndexType _RootBone);
-
-	// FAnimNode_Base interface
-	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
-	virtual bool HasPreUpdate() const { return true; }
-	virtual void PreUpdate(const UAnimInstance* InAnimInstance) override;
-	// End of FAnimNode_Base interface
-
-	// FAnimNode_SkeletalControlBase interface
-	virtual void EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms) override;
-	virtual bool IsValidToEvaluate(const USkeleton* Skeleton, const FBoneContainer& RequiredBones) override;
-	// End of FAnimNode_SkeletalControlBase interface
-
-	//void GetWorldSpaceTransforms(TArray<FBoneTransform>& OutBoneTransforms);
-
-	void GetComponentSpaceTransforms();
-
-	TArray<FCCDIKChainLink> CreateIKChain(FBoneIndexType _TipBone, FBoneIndexType _RootBone);
-
-	TArray<float> CreateRotationLimitArray(int32 NewSize);
-
-	int32 CheckIfJointIsRelevantToChain(TArray<FCCDIKChainLink> CurrentChain, int32 CurrentBoneIndex, int32 CurrentChainIndex);
-
-	int32 GetIndexFromRelevantChain(TArray<FCCDIKChainLink> CurrentChain, int32 CurrentBoneIndex);
-
-	int32 GetIndexPosFromOutBoneTransforms(TArray<FBoneTransform> OutBoneTransforms, int32 CurrentBoneIndex);
-
-	//void ApplyIKSolveBatch(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms);
-
-	void DrawLine(FVector P1_in, FVector P2_in, FColor color, float thicknessMult);
-
-	void printsmth();
-
-
-private:
-	// FAnimNode_SkeletalControlBase interface
-	virtual void InitializeBoneReferences(const FBoneContainer& RequiredBones) override;
-	// End of FAnimNode_SkeletalControlBase interface
-
-	// Convenience function to get current (pre-translation iteration) component space location of bone by bone index
-	FVector GetCurrentLocation(FCSPose<FCompactPose>& MeshBases, const FCompactPoseBoneIndex& BoneIndex);
-
-	static FTransform GetTargetTransform(const FTransform& InComponentTransform, FCSPose<FCompactPose>& MeshBases, FBoneSocketTarget& InTarget, EBoneControlSpace Space, const FVector& InOffset);
-
-public:
-#if WITH_EDITOR
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	TArray<FVector> DebugLines;
-#endif // #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	// resize rotation limit array based on set up
-	void ResizeRotationLimitPerJoints(int32 NewSize);
-#endif
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "AnimNode_SkeletalControlBase.h"
+#include "CCDIK.h"
+#include "BoneControllers/CCDIKChainSet.h"
+#include "BoneControllers/CCDIKRetargetTable.h"
+#include "BoneControllers/CCDIKOpportunisticBatcher.h"
+#include "BoneControllers/CCDIKDebugDraw.h"
+#include "BoneControllers/CCDIKFrameArena.h"
+#include "BoneControllers/CCDIKSharedBoneData.h"
+#include "BoneControllers/CCDIKChainStorage.h"
+#include "BoneControllers/CCDIKCapture.h"
+#include "BoneControllers/CCDIKContact.h"
+#include "BoneControllers/CCDIKSolveCache.h"
+#include "AnimNode_CCDIK.generated.h"
+
+DECLARE_STATS_GROUP(TEXT("CCDIK"), STATGROUP_CCDIK, STATCAT_Advanced);
+
+/** Extra effector for chains beyond the first two. Same meaning as EffectorLocation/EffectorLocationSpace/EffectorTarget on the node. */
+USTRUCT(BlueprintType)
+struct ANIMGRAPHRUNTIME_API FCCDIKEffectorTarget
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Coordinates for target location of tip bone - if EffectorLocationSpace is bone, this is the offset from Target Bone to use as target location*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effector)
+	FVector EffectorLocation;
+
+	/** Reference frame of Effector Transform. */
+	UPROPERTY(EditAnywhere, Category = Effector)
+	TEnumAsByte<enum EBoneControlSpace> EffectorLocationSpace;
+
+	/** If EffectorTransformSpace is a bone, this is the bone to use. **/
+	UPROPERTY(EditAnywhere, Category = Effector)
+	FBoneSocketTarget EffectorTarget;
+
+	FCCDIKEffectorTarget()
+		: EffectorLocation(FVector::ZeroVector)
+		, EffectorLocationSpace(BCS_ComponentSpace)
+	{
+	}
+};
+
+/** Links of a target chain that follow a source chain once it is solved, iterated on in a full body solve, see FCCDIKFullBodySettings */
+struct FCCDIKChainCoupling
+{
+	/** Chain whose solve moves bones of TargetChain */
+	int32 SourceChain = INDEX_NONE;
+
+	int32 TargetChain = INDEX_NONE;
+
+	/** Range of this coupling in FAnimNode_CCDIK::m_CouplingLinkPairs */
+	int32 FirstLinkPair = 0;
+	int32 NumLinkPairs = 0;
+};
+
+/** Per-chain bookkeeping for the current evaluate */
+struct FCCDIKChainFrameStats
+{
+	/** Number of solves this chain got this frame. The scheduler guarantees at most one. */
+	int32 SolvesThisFrame = 0;
+
+	/** Algorithm the chain was solved with */
+	CCDIKSolverCore::ESolverBackend Backend = CCDIKSolverCore::ESolverBackend::CCD;
+
+	/** Whether the solve moved any link */
+	bool bUpdated = false;
+
+	/** Iterations used by the solve */
+	int32 Iterations = 0;
+
+	/** Distance between tip and effector after the solve */
+	float TipError = 0.f;
+
+	/** Last frame's solution was reused as is */
+	bool bSkipped = false;
+
+	/** Solve started from last frame's solution with WarmStartMaxIterations */
+	bool bWarmStarted = false;
+
+	/** Solution came from another character through FCCDIKSolveCache */
+	bool bSharedCacheHit = false;
+
+	/** Key the solve is stored under in FCCDIKSolveCache, 0 when it is not shared */
+	uint64 SharedSolveKey = 0;
+
+	/** No solve this frame, the chain blended towards its latest throttled solution instead */
+	bool bInterpolated = false;
+
+	/** Tip ended within Precision of the effector */
+	bool bConverged = false;
+
+	/** Solve stopped on MaxIterations without converging */
+	bool bHitMaxIterations = false;
+};
+
+/**
+*	Game thread state FAnimNode_CCDIK needs while evaluating, copied from the skeletal mesh component in PreUpdate.
+*	Evaluation only reads this, never the component, so it can run on any thread alongside physics and other work.
+*/
+struct FCCDIKGameThreadSnapshot
+{
+	/** Component was valid during the last PreUpdate */
+	bool bValid = false;
+
+	int32 PredictedLODLevel = INDEX_NONE;
+
+	/** Bone data resolved for the component's current assets, taken over by the worker side at its next InitializeBoneReferences or evaluate */
+	TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> SharedBoneData;
+
+	/** Latest ground hit below each chain's effector, world space, empty while the contact stage is off */
+	TArray<FCCDIKContactHit> ContactHits;
+
+	/** Contact rays issued and skipped on cached hits in this PreUpdate */
+	int32 ContactRays = 0;
+	int32 ContactRaysSkipped = 0;
+
+#if CCDIK_CAPTURE
+	/** Skeletal mesh name, only filled while a capture is recording */
+	FString MeshName;
+#endif // CCDIK_CAPTURE
+};
+
+/**
+*	Evaluation results the game thread needs in PreUpdate, the reverse of FCCDIKGameThreadSnapshot. Only evaluation
+*	writes this and PreUpdate only reads it, so the game thread never touches arrays the worker side resizes.
+*/
+struct FCCDIKEvaluationSnapshot
+{
+	/** World space effector location of each chain in the last evaluation, the next contact rays are cast below them */
+	TArray<FVector> ContactQueryLocations;
+
+	/** Whether each chain wants a contact ray, off for chains without ground contact or not solved at the current IK LOD */
+	TArray<bool> ContactQueryValid;
+};
+
+/** Totals of one FAnimNode_CCDIK evaluation, to find the characters that cost the most */
+struct FCCDIKNodeStats
+{
+	/** Chains that ran the solver, skipped and interpolated chains are not counted */
+	int32 ChainsSolved = 0;
+
+	/** Iterations of every solved chain */
+	int32 TotalIterations = 0;
+
+	int32 ChainsConverged = 0;
+
+	int32 ChainsHitMaxIterations = 0;
+
+	/** Largest distance between a chain tip and its effector */
+	float MaxTipError = 0.f;
+
+	/** Same totals split by solver backend, indexed by CCDIKSolverCore::ESolverBackend */
+	int32 ChainsSolvedPerBackend[(int32)CCDIKSolverCore::ESolverBackend::Num] = {};
+	int32 IterationsPerBackend[(int32)CCDIKSolverCore::ESolverBackend::Num] = {};
+	int32 ChainsConvergedPerBackend[(int32)CCDIKSolverCore::ESolverBackend::Num] = {};
+
+	/** Bone transforms handed to the base class: moved links and their zero length children */
+	int32 BonesWritten = 0;
+
+	/** Distance the full body solve moved the pelvis */
+	float PelvisOffset = 0.f;
+
+	/** Time spent in EvaluateSkeletalControl_AnyThread */
+	double EvaluateSeconds = 0.0;
+
+	/** Growth of node-owned heap memory during the evaluation, frame arena included */
+	int64 BytesAllocated = 0;
+
+	/** Heap allocations during the evaluation: frame arena spills and growth, plus one per node-owned container reallocated. Zero at steady state. */
+	int32 HeapAllocations = 0;
+};
+
+/** Capacity of every heap container a FAnimNode_CCDIK owns, compared before and after an evaluation to find its allocations */
+struct FCCDIKNodeAllocations
+{
+	static constexpr int32 MaxContainers = 40;
+
+	/** Bytes held by each container, always added in the same order. The chain storage counts as one container. */
+	SIZE_T ContainerSizes[MaxContainers];
+	int32 NumContainers = 0;
+
+	/** Frame arena capacity. The arena counts its own allocations. */
+	SIZE_T ArenaSize = 0;
+
+	template<typename ContainerType>
+	void Add(const ContainerType& Container)
+	{
+		check(NumContainers < MaxContainers);
+		ContainerSizes[NumContainers++] = Container.GetAllocatedSize();
+	}
+
+	SIZE_T GetTotal() const
+	{
+		SIZE_T Total = ArenaSize;
+		for (int32 Index = 0; Index < NumContainers; Index++)
+		{
+			Total += ContainerSizes[Index];
+		}
+		return Total;
+	}
+
+	/** Containers whose capacity differs from Before, each one was reallocated at least once in between */
+	int32 CountReallocationsSince(const FCCDIKNodeAllocations& Before) const
+	{
+		int32 NumReallocations = 0;
+		for (int32 Index = 0; Index < NumContainers; Index++)
+		{
+			NumReallocations += ContainerSizes[Index] != Before.ContainerSizes[Index] ? 1 : 0;
+		}
+		return NumReallocations;
+	}
+};
+
+/** What a chain looked like when it was last solved, used to skip or warm start the next solve */
+struct FCCDIKChainHistory
+{
+	/** Component space effector location the chain was last solved for */
+	FVector Effector = FVector::ZeroVector;
+
+	/** Quantized hash of the input link transforms of that solve */
+	uint32 InputPoseHash = 0;
+
+	float TipError = 0.f;
+
+	bool bUpdated = false;
+
+	bool bValid = false;
+
+	/** Offset of this chain's solved positions and rotations in m_ChainHistoryData, 7 floats per link */
+	int32 DataOffset = 0;
+};
+
+/** Contact stage state of one chain, game thread only */
+struct FCCDIKChainContact
+{
+	/** Ray submitted last PreUpdate, fetched in the next one */
+	FCCDIKContactHandle PendingRay;
+
+	/** Latest result, reused while the effector stays within ContactRecastDistance of TracedLocation */
+	FCCDIKContactHit Hit;
+
+	/** World space effector location the latest ray was cast below */
+	FVector TracedLocation = FVector::ZeroVector;
+
+	/** A ray of this chain was answered at least once */
+	bool bTraced = false;
+};
+
+/** Latest effector samples of a chain, to extrapolate where the effector will be when the next solve is shown */
+struct FCCDIKEffectorHistory
+{
+	static constexpr int32 Capacity = 4;
+
+	/** Component space chain target and evaluation time of each sample, oldest overwritten first */
+	FVector Locations[Capacity];
+	double Times[Capacity];
+
+	int32 Num = 0;
+
+	/** Slot the next sample goes to */
+	int32 Head = 0;
+
+	void Reset() { Num = 0; Head = 0; }
+
+	void Add(const FVector& Location, double Time);
+
+	/** Latest sample moved on by the average velocity over the buffer until Time, the latest sample with less than two */
+	FVector Predict(double Time) const;
+};
+
+/**
+*	Controller which implements the CCDIK IK approximation algorithm
+*/
+USTRUCT()
+struct ANIMGRAPHRUNTIME_API FAnimNode_CCDIK : public FAnimNode_SkeletalControlBase
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Coordinates for target location of tip bone - if EffectorLocationSpace is bone, this is the offset from Target Bone to use as target location*/
+	UPROPERTY(EditAnywhere, Category = Effector, meta = (PinShownByDefault))
+	FVector EffectorLocation;
+
+	/** Reference frame of Effector Transform. */
+	UPROPERTY(EditAnywhere, Category = Effector)
+	TEnumAsByte<enum EBoneControlSpace> EffectorLocationSpace;
+
+	/** If EffectorTransformSpace is a bone, this is the bone to use. **/
+	UPROPERTY(EditAnywhere, Category = Effector)
+	FBoneSocketTarget EffectorTarget;
+
+			/** Coordinates for target location of tip bone - if EffectorLocationSpace is bone, this is the offset from Target Bone to use as target location*/
+			UPROPERTY(EditAnywhere, Category = Effector, meta = (PinShownByDefault))
+				FVector EffectorLocation2;
+
+			/** Reference frame of Effector Transform. */
+			UPROPERTY(EditAnywhere, Category = Effector)
+				TEnumAsByte<enum EBoneControlSpace> EffectorLocationSpace2;
+
+			/** If EffectorTransformSpace is a bone, this is the bone to use. **/
+			UPROPERTY(EditAnywhere, Category = Effector)
+				FBoneSocketTarget EffectorTarget2;
+
+	/** Effectors 2 and up, for chain sets driving more than two chains */
+	UPROPERTY(EditAnywhere, Category = Effector, meta = (PinShownByDefault))
+	TArray<FCCDIKEffectorTarget> AdditionalEffectors;
+
+	/**
+	*	Chains solved by this node, authored per character. None keeps the behaviour of nodes authored before chain sets:
+	*	clavicle_r to hand_r towards EffectorLocation and thigh_l to foot_l towards EffectorLocation2 with 50 degree
+	*	limits, see UCCDIKChainSet::GetDefaultChains. Move such nodes to a chain set to use other bones or limits.
+	*/
+	UPROPERTY(EditAnywhere, Category = Solver)
+	UCCDIKChainSet* ChainSet;
+
+	/** Retargets effectors authored for another rig onto this one, per chain. Must be built for this mesh and ChainSet. None applies effectors as they are. */
+	UPROPERTY(EditAnywhere, Category = Solver)
+	UCCDIKRetargetTable* RetargetTable;
+
+	/** Tolerance for final tip location delta from EffectorLocation*/
+	UPROPERTY(EditAnywhere, Category = Solver)
+	float Precision;
+
+	/** Maximum number of iterations allowed, to control performance. */
+	UPROPERTY(EditAnywhere, Category = Solver)
+	int32 MaxIterations;
+
+	/** Toggle drawing of axes to debug joint rotation*/
+	UPROPERTY(EditAnywhere, Category = Solver)
+	bool bStartFromTail;
+
+	/** Tolerance for final tip location delta from EffectorLocation*/
+	UPROPERTY(EditAnywhere, Category = Solver)
+	bool bEnableRotationLimit;
+
+	/**
+	*	Same solved pose for the same input pose and effectors on server and clients, whatever the platform, thread or build.
+	*	Chains always run MaxIterations with portable math and canonical rotations, batching, the temporal cache and effector
+	*	prediction are bypassed, and throttled IK LODs solve on the same frames for every instance. Costs the full iteration budget.
+	*/
+	UPROPERTY(EditAnywhere, Category = Solver)
+	bool bDeterministicSolve;
+
+	/** Reuse or warm start from last frame's solution when the input pose and effector barely changed */
+	UPROPERTY(EditAnywhere, Category = Temporal)
+	bool bEnableTemporalCache;
+
+	/** Input link locations/rotations are quantized to this step before hashing. Poses closer than this count as unchanged. */
+	UPROPERTY(EditAnywhere, Category = Temporal, meta = (ClampMin = "0.0001", EditCondition = "bEnableTemporalCache"))
+	float InputPoseTolerance;
+
+	/** Skip the solve entirely when the effector moved less than this since the last solve */
+	UPROPERTY(EditAnywhere, Category = Temporal, meta = (ClampMin = "0.0", EditCondition = "bEnableTemporalCache"))
+	float EffectorSkipTolerance;
+
+	/** Start from last frame's solution when the effector moved less than this since the last solve */
+	UPROPERTY(EditAnywhere, Category = Temporal, meta = (ClampMin = "0.0", EditCondition = "bEnableTemporalCache"))
+	float WarmStartTolerance;
+
+	/** Iteration budget of a warm started solve */
+	UPROPERTY(EditAnywhere, Category = Temporal, meta = (ClampMin = "1", EditCondition = "bEnableTemporalCache"))
+	int32 WarmStartMaxIterations;
+
+	/**
+	*	Reuse chain solutions of other characters with the same mesh, chain set and settings when their chain input pose
+	*	and effector, both relative to the chain root, match after quantization. Meant for crowds playing the same animations:
+	*	each distinct chain input is solved once per frame instead of once per character. See FCCDIKSolveCache.
+	*/
+	UPROPERTY(EditAnywhere, Category = SharedCache)
+	bool bUseSharedSolveCache;
+
+	/** Quantization step of the chain input pose: link offsets in component space units, link rotations per quaternion component */
+	UPROPERTY(EditAnywhere, Category = SharedCache, meta = (ClampMin = "0.0001", EditCondition = "bUseSharedSolveCache"))
+	float SharedCachePoseTolerance;
+
+	/** Quantization step of the effector offset from the chain root, in component space units */
+	UPROPERTY(EditAnywhere, Category = SharedCache, meta = (ClampMin = "0.0001", EditCondition = "bUseSharedSolveCache"))
+	float SharedCacheEffectorTolerance;
+
+	/**
+	*	When chains solve less often than the node evaluates (IK LOD UpdateInterval or SolveRate), solve for where the effector
+	*	will be by the time the solution is fully blended in, extrapolated from its recent velocity. Throttled limbs then
+	*	track moving targets instead of trailing one solve behind them.
+	*/
+	UPROPERTY(EditAnywhere, Category = Temporal)
+	bool bPredictEffectors;
+
+	/** Furthest ahead, in seconds, effectors are extrapolated */
+	UPROPERTY(EditAnywhere, Category = Temporal, meta = (ClampMin = "0.0", EditCondition = "bPredictEffectors"))
+	float MaxPredictionTime;
+
+	/**
+	*	Move effectors of chains with FCCDIKChainDescriptor::bGroundContact by the ground height below them, relative to the component origin.
+	*	Rays for every such chain are issued together in PreUpdate and their results used the following frame, nothing waits on collision.
+	*/
+	UPROPERTY(EditAnywhere, Category = Contact)
+	bool bEnableGroundContact;
+
+	UPROPERTY(EditAnywhere, Category = Contact, meta = (EditCondition = "bEnableGroundContact"))
+	TEnumAsByte<ECollisionChannel> ContactTraceChannel;
+
+	/** Ray length above and below the animated effector location */
+	UPROPERTY(EditAnywhere, Category = Contact, meta = (ClampMin = "0.0", EditCondition = "bEnableGroundContact"))
+	float ContactTraceUp;
+
+	UPROPERTY(EditAnywhere, Category = Contact, meta = (ClampMin = "0.0", EditCondition = "bEnableGroundContact"))
+	float ContactTraceDown;
+
+	/** Extra height added on top of the ground, for the ankle to sole distance */
+	UPROPERTY(EditAnywhere, Category = Contact, meta = (EditCondition = "bEnableGroundContact"))
+	float ContactOffset;
+
+	/** The cached hit is reused, and no ray cast, while the effector moved less than this across the ground since the last ray */
+	UPROPERTY(EditAnywhere, Category = Contact, meta = (ClampMin = "0.0", EditCondition = "bEnableGroundContact"))
+	float ContactRecastDistance;
+
+	/** Solve CCD chains in SIMD lane groups, sharing lanes with chains of other characters when their evaluations happen to overlap */
+	UPROPERTY(EditAnywhere, Category = Solver)
+	bool bUseBatchSolve;
+
+	/** Importance of this character, matched against FCCDIKLODSettings::MinSignificance of the chain set's IK LODs */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (PinHiddenByDefault))
+	float Significance;
+
+	/** Draw solved chains and their effectors in the world. Has no effect in shipping and test builds. */
+	UPROPERTY(EditAnywhere, Category = Debug)
+	bool bDrawDebugChains;
+
+	/** Persistent IK chains, root link first. Topology is rebuilt only when the bone container or LOD changes, transforms are refreshed in place every evaluate. */
+	FCCDIKChainStorage m_IKChains;
+
+	/** Effector driving each chain in m_IKChains, see FCCDIKChainDescriptor::EffectorIndex */
+	TArray<int32> m_IKChainEffectorIndex;
+
+	/** Solver backend and damping of each chain, from the chain set */
+	TArray<CCDIKSolverCore::ESolverBackend> m_IKChainBackend;
+	TArray<float> m_IKChainDamping;
+
+	/** Effector retargeting of each chain, from the chain set's retarget table */
+	TArray<float> m_IKChainRetargetScale;
+	TArray<FVector> m_IKChainRetargetOffset;
+
+	/** Order in which chains are solved, ancestors first (spine before limbs), each starting from the bones solved before it */
+	TArray<int32> m_IKChainSolveOrder;
+
+	/** Solve stats per chain in m_IKChains, reset every evaluate */
+	TArray<FCCDIKChainFrameStats> m_IKChainFrameStats;
+
+	/** Whether each chain in m_IKChains has ground contact, from the chain set */
+	TArray<bool> m_IKChainGroundContact;
+
+	/** Totals of the last evaluation, shown in GatherDebugData and fed to the CCDIK stat group and CSV category */
+	FCCDIKNodeStats m_NodeStats;
+
+
+	/** Game thread only, evaluation reads m_GameThreadSnapshot instead */
+	UWorld* m_MyWorld;
+	USkeletalMeshComponent* m_SkelComp;
+
+	/** Written in PreUpdate, read only while evaluating */
+	FCCDIKGameThreadSnapshot m_GameThreadSnapshot;
+
+	/** Written while evaluating, read only in PreUpdate */
+	FCCDIKEvaluationSnapshot m_EvaluationSnapshot;
+
+	int32 m_LastBoneIndicesCacheLOD = -1;
+
+	bool m_IKChainsDirty = true;
+
+	/** Last solve of each chain in m_IKChains, and their solved positions and rotations */
+	TArray<FCCDIKChainHistory> m_IKChainHistory;
+	TArray<float> m_ChainHistoryData;
+
+	/** Entry of the resolved chain set's LODSettings used this frame, INDEX_NONE without a LOD table */
+	int32 m_CurrentIKLOD = INDEX_NONE;
+
+	/** Index in the chain set of each chain in m_IKChains */
+	TArray<int32> m_IKChainDescriptorIndex;
+
+	/** Whether a chain is solved at an IK LOD, indexed [LOD * m_IKChains.Num() + Chain] */
+	TArray<bool> m_IKChainLODActive;
+
+	/** Throttled solving: solved local rotation offsets of the two latest solves, blended on frames in between */
+	TArray<FQuat> m_IKPrevLocalOffsets;
+	TArray<FQuat> m_IKLastLocalOffsets;
+	TArray<bool> m_IKChainHasLocalOffsets;
+	uint32 m_IKUpdateFrame = 0;
+	uint32 m_IKUpdatePhase = 0;
+	int32 m_IKUpdateInterval = 1;
+	float m_IKInterpolationAlpha = 1.f;
+
+	/** Chains solve less often than the node evaluates this frame, by UpdateInterval or SolveRate */
+	bool m_bIKThrottled = false;
+
+	/** Time accumulated by UpdateInternal since the last evaluate, node time at the last evaluate, and time since the last rate limited solve */
+	float m_IKPendingDeltaTime = 0.f;
+	double m_IKTime = 0.0;
+	float m_IKTimeSinceSolve = 0.f;
+
+	/** Contact stage: per chain ray state, game thread only. Sized from m_EvaluationSnapshot. */
+	TArray<FCCDIKChainContact> m_IKChainContacts;
+
+	/** Collision queried by the contact stage: the custom world when set, the component's world otherwise */
+	TSharedPtr<ICCDIKContactWorld> m_CustomContactWorld;
+	TSharedPtr<FCCDIKSceneContactWorld> m_SceneContactWorld;
+
+	/** Effector samples of each chain in m_IKChains, filled while bPredictEffectors is set */
+	TArray<FCCDIKEffectorHistory> m_IKEffectorHistory;
+
+#if CCDIK_DEBUG_DRAW
+	/** Lines recorded during evaluation, drawn in PreUpdate. Created on the game thread the first time it is needed. */
+	TSharedPtr<FCCDIKDebugLineBuffer, ESPMode::ThreadSafe> m_DebugLineBuffer;
+#endif // CCDIK_DEBUG_DRAW
+
+	/** Solver of each chain for its backend and length, picked for the flags in m_IKSolveFunctionFlags */
+	TArray<CCDIKSolverCore::FSolveChainFunction> m_IKChainSolveFunctions;
+	int32 m_IKSolveFunctionFlags = INDEX_NONE;
+
+	/**
+	*	Chains sharing bones with another chain, and per pair the link of the target chain with the link of the source
+	*	chain holding the same bone (X target, Y source, INDEX_NONE when the target link only follows).
+	*	Pairs run from the first shared link to the tip of the target chain. Full body solves iterate over them, otherwise
+	*	each chain only starts from what the chains solved before it left.
+	*/
+	TArray<FCCDIKChainCoupling> m_ChainCouplings;
+	TArray<FIntPoint> m_CouplingLinkPairs;
+
+	/** Chains that are the target of a coupling, solved only after their sources */
+	TArray<bool> m_IKChainHasCouplingSource;
+
+	/** Full body pelvis, and the first link of each chain moving with it (INDEX_NONE when the chain is not below it) */
+	FCompactPoseBoneIndex m_FullBodyPelvisIndex = FCompactPoseBoneIndex(INDEX_NONE);
+	TArray<int32> m_IKChainPelvisFirstLink;
+
+	/** Input pose pelvis transform, and how far the latest full body solve moved it */
+	FTransform m_PelvisTransform;
+	FVector m_PelvisOffset = FVector::ZeroVector;
+
+	/** Jobs handed to FCCDIKOpportunisticBatcher when bUseBatchSolve is set, and the chain each one solves */
+	TArray<FCCDIKBatchJob> m_BatchJobs;
+	TArray<int32> m_BatchJobChainIndex;
+	FCCDIKBatchOwner m_BatchOwner;
+
+	/**
+	*	Chain set resolved for this mesh, shared with every node using the same assets.
+	*	Worker side copy of FCCDIKGameThreadSnapshot::SharedBoneData, only ever written by AdoptSharedBoneData.
+	*/
+	TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> m_SharedBoneData;
+
+	/** Per-evaluate scratch memory, sized in RebuildIKChains and reset at the start of every evaluate */
+	FCCDIKFrameArena m_FrameArena;
+
+public:
+	FAnimNode_CCDIK();
+	//FAnimNode_CCDIK(FVector _EffectorLocation, FBoneIndexType _TipBone, FBoneIndexType _RootBone);
+
+	// FAnimNode_Base interface
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	virtual bool HasPreUpdate() const { return true; }
+	virtual void PreUpdate(const UAnimInstance* InAnimInstance) override;
+	// End of FAnimNode_Base interface
+
+	// FAnimNode_SkeletalControlBase interface
+	virtual void EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms) override;
+	virtual bool IsValidToEvaluate(const USkeleton* Skeleton, const FBoneContainer& RequiredBones) override;
+	// End of FAnimNode_SkeletalControlBase interface
+
+	//void GetWorldSpaceTransforms(TArray<FBoneTransform>& OutBoneTransforms);
+
+	/** Append the bones moved this frame, sorted by compact index as the base class expects. Returns how many were added. */
+	int32 GetSolvedBoneTransforms(TArray<FBoneTransform>& OutBoneTransforms) const;
+
+	bool CreateIKChain(const FBoneContainer& RequiredBones, FBoneIndexType _TipBone, FBoneIndexType _RootBone, FCCDIKChainStorage& OutChains);
+
+	void RebuildIKChains(const FBoneContainer& RequiredBones);
+
+	/** Take over the bone data the last PreUpdate resolved, flagging the chains for a rebuild when it changed. Worker side only. */
+	void AdoptSharedBoneData();
+
+	/** Precompile the chain set's swing and twist constraints of one chain into m_IKChains.JointLimits */
+	void BuildChainJointLimits(const FBoneContainer& RequiredBones, int32 ChainIndex, int32 ResolvedChainIndex);
+
+	/** Find the bones chains share, and the chains moving with the pelvis for the chain set's full body solve */
+	void BuildChainCouplings(const FBoneContainer& RequiredBones);
+
+	void RefreshIKChainTransforms(FCSPose<FCompactPose>& MeshBases);
+
+	/** Solve every chain towards its entry in CSChainTargets */
+	void SolveIKChains(FVector* CSChainTargets, int32 NumEffectors);
+
+	/** Solve the first NumJobs of m_BatchJobs through FCCDIKOpportunisticBatcher and apply them in queue order */
+	void SolveBatchJobs(int32 NumJobs);
+
+	/** Cast contact rays below last frame's effectors and fetch the previous rays' results into the snapshot. Game thread. */
+	void UpdateGroundContacts();
+
+	/** Move chain targets by the ground height in the snapshot, and record where the next rays go */
+	void ApplyGroundContacts(const FTransform& ComponentTransform, FVector* CSChainTargets, int32 NumEffectors);
+
+	/** Query a stand-in collision world instead of the component's world, nullptr to go back to it. Game thread. */
+	void SetContactWorld(TSharedPtr<ICCDIKContactWorld> InContactWorld);
+
+	/** Record this frame's chain targets and, on throttled solve frames, replace them with their extrapolation PredictionTime ahead */
+	void PredictChainTargets(FVector* CSChainTargets, int32 NumEffectors, float PredictionTime);
+
+	/** Move the pelvis, then solve all chains in turns, each handing the bones it shares to the chains after it */
+	void SolveFullBody(const FVector* CSChainTargets, int32 NumEffectors, const CCDIKSolverCore::FSolveSettings& Settings, bool bSolveFrame);
+
+	/** Pelvis offset pulling the body towards the targets its chains cannot reach */
+	FVector ComputePelvisOffset(const FVector* CSChainTargets, int32 NumEffectors) const;
+
+	void ApplyPelvisOffset(const FVector& Offset);
+
+	/** Copy the shared bones of a chain into every chain coupled to it, their links below follow rigidly */
+	void PropagateSharedLinks(int32 SourceChain);
+
+	/** Chain has an effector and is solved at the current IK LOD */
+	bool ShouldSolveChain(int32 ChainIndex, int32 NumEffectors) const;
+
+	bool PrepareChainSolve(int32 ChainIndex, const FVector& Target, CCDIKSolverCore::FSolveSettings& InOutSettings, CCDIKSolverCore::FSolveResult& OutSkippedResult);
+
+	uint32 HashChainInput(const CCDIKSolverCore::FChainView& View) const;
+
+	/** FCCDIKSolveCache key of a chain's input pose relative to its root link, its effector relative to the root link and its settings */
+	uint64 MakeSharedSolveKey(int32 ChainIndex, const FVector& Target, const CCDIKSolverCore::FSolveSettings& Settings);
+
+	/** ChainSet, or the default chains without one, resolved against the current mesh. Empty until the first PreUpdate. */
+	const FCCDIKResolvedChainSet& GetResolvedChains() const;
+
+	/** EffectorLocation, EffectorLocation2 and AdditionalEffectors */
+	int32 GetNumEffectors() const;
+
+	bool IsChainActiveAtLOD(int32 ChainIndex) const;
+
+	/** Heap memory held by the node's containers and frame arena, used to track allocations made while evaluating */
+	void GetNodeAllocations(FCCDIKNodeAllocations& OutAllocations) const;
+
+	void UpdateNodeStats(uint64 EvaluateStartCycles, const FCCDIKNodeAllocations& AllocationsBefore);
+
+	void StoreChainLocalOffsets(int32 ChainIndex);
+
+	void ApplyChainLocalOffsets(int32 ChainIndex, float Alpha);
+
+	/** Pick each chain's solver for its backend, its length and the current bStartFromTail and bEnableRotationLimit */
+	void SelectChainSolveFunctions();
+
+	void ApplyChainSolveResult(int32 ChainIndex, const CCDIKSolverCore::FSolveSettings& Settings, const CCDIKSolverCore::FSolveResult& Result);
+
+	//void ApplyIKSolveBatch(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms);
+
+	void DrawLine(FVector P1_in, FVector P2_in, FColor color, float thicknessMult);
+
+	void printsmth();
+
+
+private:
+	// FAnimNode_SkeletalControlBase interface
+	virtual void InitializeBoneReferences(const FBoneContainer& RequiredBones) override;
+	virtual void UpdateInternal(const FAnimationUpdateContext& Context) override;
+	// End of FAnimNode_SkeletalControlBase interface
+
+	// Convenience function to get current (pre-translation iteration) component space location of bone by bone index
+	FVector GetCurrentLocation(FCSPose<FCompactPose>& MeshBases, const FCompactPoseBoneIndex& BoneIndex);
+
+	static FTransform GetTargetTransform(const FTransform& InComponentTransform, FCSPose<FCompactPose>& MeshBases, FBoneSocketTarget& InTarget, EBoneControlSpace Space, const FVector& InOffset);
+
+public:
+#if WITH_EDITOR
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	/**
+	*	Component space lines drawn for this node in the last PreUpdate, as start and end pairs: [2 * i] and [2 * i + 1]
+	*	are the ends of line i. Each chain adds its bone to bone links, then a line from its tip to its effector. This used
+	*	to hold one location per solved bone; draw it as separate lines, not as a polyline.
+	*/
+	TArray<FVector> DebugLines;
+#endif // #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
 };
\ No newline at end of file
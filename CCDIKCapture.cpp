@@ -0,0 +1,363 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKCapture.h"
+
+#if CCDIK_CAPTURE
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "EngineLogs.h"
+
+namespace CCDIKCapture
+{
+	static const uint32 CaptureMagic = 0x43444343; // 'CCDC'
+	static const uint32 ReportMagic = 0x52444343; // 'CCDR'
+	static const int32 FileVersion = 3;
+
+	/** Floats per link of the recorded pose: PosX, PosY, PosZ, RotX, RotY, RotZ, RotW, then the rotation limit */
+	static const int32 FloatsPerLink = 8;
+
+	static const int32 FloatsPerJointLimit = sizeof(CCDIKSolverCore::FJointLimit) / sizeof(float);
+	static_assert(sizeof(CCDIKSolverCore::FJointLimit) % sizeof(float) == 0, "Joint limits are stored as floats");
+
+	static FString GetDefaultFilename(const TCHAR* Name)
+	{
+		return FPaths::ProfilingDir() / TEXT("CCDIK") / Name;
+	}
+
+	template<typename DataType>
+	static bool SaveToFile(const uint32 Magic, DataType& Data, const FString& Filename)
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		uint32 FileMagic = Magic;
+		int32 Version = FileVersion;
+		Writer << FileMagic << Version << Data;
+		return FFileHelper::SaveArrayToFile(Bytes, *Filename);
+	}
+
+	template<typename DataType>
+	static bool LoadFromFile(const uint32 Magic, DataType& Data, const FString& Filename)
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *Filename))
+		{
+			return false;
+		}
+
+		FMemoryReader Reader(Bytes);
+		uint32 FileMagic = 0;
+		int32 Version = 0;
+		Reader << FileMagic << Version;
+		if (FileMagic != Magic || Version != FileVersion)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("CCDIK: %s is not a version %d capture file."), *Filename, FileVersion);
+			return false;
+		}
+
+		Reader << Data;
+		return !Reader.IsError();
+	}
+}
+
+/////////////////////////////////////////////////////
+// FCCDIKCapture
+
+void FCCDIKCapture::Reset()
+{
+	Characters.Reset();
+	Solves.Reset();
+	Data.Reset();
+}
+
+void FCCDIKCapture::AddSolve(const FString& Character, uint32 Frame, const CCDIKSolverCore::FChainView& Chain, const float Target[3], const CCDIKSolverCore::FSolveSettings& Settings)
+{
+	using namespace CCDIKCapture;
+
+	FCCDIKCapturedSolve& Solve = Solves.AddDefaulted_GetRef();
+	Solve.CharacterIndex = Characters.AddUnique(Character);
+	Solve.Frame = Frame;
+	Solve.NumLinks = Chain.NumLinks;
+	Solve.DataOffset = Data.Num();
+	Solve.bHasJointLimits = Chain.JointLimits != nullptr;
+	Solve.Target[0] = Target[0];
+	Solve.Target[1] = Target[1];
+	Solve.Target[2] = Target[2];
+	Solve.Settings = Settings;
+
+	const float* Planes[] = { Chain.PosX, Chain.PosY, Chain.PosZ, Chain.RotX, Chain.RotY, Chain.RotZ, Chain.RotW };
+	for (const float* Plane : Planes)
+	{
+		Data.Append(Plane, Chain.NumLinks);
+	}
+
+	for (int32 LinkIndex = 0; LinkIndex < Chain.NumLinks; LinkIndex++)
+	{
+		Data.Add(Chain.RotationLimits ? Chain.RotationLimits[LinkIndex] : PI);
+	}
+
+	if (Solve.bHasJointLimits)
+	{
+		Data.Append(reinterpret_cast<const float*>(Chain.JointLimits), Chain.NumLinks * FloatsPerJointLimit);
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FCCDIKCapture& Capture)
+{
+	Ar << Capture.Characters;
+
+	int32 NumSolves = Capture.Solves.Num();
+	Ar << NumSolves;
+	if (Ar.IsLoading())
+	{
+		Capture.Solves.SetNum(NumSolves);
+	}
+
+	for (FCCDIKCapturedSolve& Solve : Capture.Solves)
+	{
+		Ar << Solve.CharacterIndex << Solve.Frame << Solve.NumLinks << Solve.DataOffset << Solve.bHasJointLimits;
+		Ar << Solve.Target[0] << Solve.Target[1] << Solve.Target[2];
+		Ar << Solve.Settings.Precision << Solve.Settings.MaxIterations << Solve.Settings.bStartFromTail << Solve.Settings.bEnableRotationLimit;
+
+		uint8 Backend = (uint8)Solve.Settings.Backend;
+		Ar << Backend << Solve.Settings.Damping << Solve.Settings.bDeterministic;
+		Solve.Settings.Backend = (CCDIKSolverCore::ESolverBackend)FMath::Min<uint8>(Backend, (uint8)CCDIKSolverCore::ESolverBackend::Num - 1);
+	}
+
+	// Float data is written in one block
+	Capture.Data.BulkSerialize(Ar);
+	return Ar;
+}
+
+bool FCCDIKCapture::SaveToFile(const FString& Filename) const
+{
+	return CCDIKCapture::SaveToFile(CCDIKCapture::CaptureMagic, const_cast<FCCDIKCapture&>(*this), Filename);
+}
+
+bool FCCDIKCapture::LoadFromFile(const FString& Filename)
+{
+	Reset();
+	return CCDIKCapture::LoadFromFile(CCDIKCapture::CaptureMagic, *this, Filename);
+}
+
+/////////////////////////////////////////////////////
+// FCCDIKReplayReport
+
+FArchive& operator<<(FArchive& Ar, FCCDIKReplayStats& Stats)
+{
+	Ar << Stats.Character << Stats.Solves << Stats.NanosecondsPerSolve << Stats.IterationsPerSolve << Stats.MeanTipError << Stats.MaxTipError << Stats.OutputHash;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FCCDIKReplayReport& Report)
+{
+	Ar << Report.Characters;
+	return Ar;
+}
+
+void FCCDIKReplayReport::Run(const FCCDIKCapture& Capture, int32 NumRepeats, int32 BackendOverride)
+{
+	using namespace CCDIKCapture;
+	using namespace CCDIKSolverCore;
+
+	NumRepeats = FMath::Max(NumRepeats, 1);
+
+	Characters.Reset();
+	Characters.SetNum(Capture.Characters.Num());
+	TArray<uint64> Cycles;
+	TArray<int64> Iterations;
+	TArray<double> TipErrors;
+	Cycles.SetNumZeroed(Capture.Characters.Num());
+	Iterations.SetNumZeroed(Capture.Characters.Num());
+	TipErrors.SetNumZeroed(Capture.Characters.Num());
+
+	TArray<float> Scratch;
+	for (const FCCDIKCapturedSolve& Solve : Capture.Solves)
+	{
+		const int32 NumLinks = Solve.NumLinks;
+		const float* SolveData = Capture.Data.GetData() + Solve.DataOffset;
+		Scratch.SetNumUninitialized(NumLinks * 8, false);
+
+		FChainView Chain;
+		Chain.PosX = Scratch.GetData();
+		Chain.PosY = Chain.PosX + NumLinks;
+		Chain.PosZ = Chain.PosY + NumLinks;
+		Chain.RotX = Chain.PosZ + NumLinks;
+		Chain.RotY = Chain.RotX + NumLinks;
+		Chain.RotZ = Chain.RotY + NumLinks;
+		Chain.RotW = Chain.RotZ + NumLinks;
+		Chain.AngleDelta = Chain.RotW + NumLinks;
+		Chain.RotationLimits = SolveData + NumLinks * 7;
+		Chain.JointLimits = Solve.bHasJointLimits ? reinterpret_cast<const FJointLimit*>(SolveData + NumLinks * FloatsPerLink) : nullptr;
+		Chain.NumLinks = NumLinks;
+
+		FSolveSettings Settings = Solve.Settings;
+		if (BackendOverride >= 0 && BackendOverride < (int32)ESolverBackend::Num)
+		{
+			Settings.Backend = (ESolverBackend)BackendOverride;
+		}
+
+		// Same kernel choice as FAnimNode_CCDIK::SelectChainSolveFunctions
+		const FSolveChainFunction SolveFunction = GetSolveFunction(NumLinks, Settings);
+
+		FSolveResult Result;
+		for (int32 Repeat = 0; Repeat < NumRepeats; Repeat++)
+		{
+			FMemory::Memcpy(Chain.PosX, SolveData, NumLinks * 7 * sizeof(float));
+			FMemory::Memzero(Chain.AngleDelta, NumLinks * sizeof(float));
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Result = SolveFunction(Chain, Solve.Target, Settings);
+			Cycles[Solve.CharacterIndex] += FPlatformTime::Cycles64() - StartCycles;
+		}
+
+		FCCDIKReplayStats& Stats = Characters[Solve.CharacterIndex];
+		Stats.Solves++;
+		Stats.MaxTipError = FMath::Max(Stats.MaxTipError, Result.TipError);
+		Stats.OutputHash = FCrc::MemCrc32(Chain.PosX, NumLinks * 7 * sizeof(float), Stats.OutputHash);
+		Iterations[Solve.CharacterIndex] += Result.Iterations;
+		TipErrors[Solve.CharacterIndex] += Result.TipError;
+	}
+
+	for (int32 CharacterIndex = 0; CharacterIndex < Characters.Num(); CharacterIndex++)
+	{
+		FCCDIKReplayStats& Stats = Characters[CharacterIndex];
+		Stats.Character = Capture.Characters[CharacterIndex];
+		if (Stats.Solves > 0)
+		{
+			Stats.NanosecondsPerSolve = FPlatformTime::ToSeconds64(Cycles[CharacterIndex]) * 1.e9 / (double(Stats.Solves) * NumRepeats);
+			Stats.IterationsPerSolve = double(Iterations[CharacterIndex]) / Stats.Solves;
+			Stats.MeanTipError = float(TipErrors[CharacterIndex] / Stats.Solves);
+		}
+	}
+}
+
+void FCCDIKReplayReport::Log(const FCCDIKReplayReport* Baseline) const
+{
+	auto Change = [](double Value, double BaselineValue)
+	{
+		return BaselineValue != 0.0 ? FString::Printf(TEXT(" (%+.1f%%)"), (Value / BaselineValue - 1.0) * 100.0) : FString();
+	};
+
+	for (const FCCDIKReplayStats& Stats : Characters)
+	{
+		const FCCDIKReplayStats* BaselineStats = Baseline ? Baseline->Characters.FindByPredicate([&Stats](const FCCDIKReplayStats& Other) { return Other.Character == Stats.Character; }) : nullptr;
+		UE_LOG(LogAnimation, Display, TEXT("CCDIK replay %s: %d solves, %.1f ns/solve%s, %.2f iterations/solve%s, tip error mean %.3f%s max %.3f, output %08x%s"),
+			*Stats.Character, Stats.Solves,
+			Stats.NanosecondsPerSolve, BaselineStats ? *Change(Stats.NanosecondsPerSolve, BaselineStats->NanosecondsPerSolve) : TEXT(""),
+			Stats.IterationsPerSolve, BaselineStats ? *Change(Stats.IterationsPerSolve, BaselineStats->IterationsPerSolve) : TEXT(""),
+			Stats.MeanTipError, BaselineStats ? *Change(Stats.MeanTipError, BaselineStats->MeanTipError) : TEXT(""),
+			Stats.MaxTipError,
+			Stats.OutputHash, BaselineStats ? (BaselineStats->OutputHash == Stats.OutputHash ? TEXT(" (bit identical)") : TEXT(" (CHANGED)")) : TEXT(""));
+	}
+}
+
+bool FCCDIKReplayReport::SaveToFile(const FString& Filename) const
+{
+	return CCDIKCapture::SaveToFile(CCDIKCapture::ReportMagic, const_cast<FCCDIKReplayReport&>(*this), Filename);
+}
+
+bool FCCDIKReplayReport::LoadFromFile(const FString& Filename)
+{
+	Characters.Reset();
+	return CCDIKCapture::LoadFromFile(CCDIKCapture::ReportMagic, *this, Filename);
+}
+
+/////////////////////////////////////////////////////
+// FCCDIKCaptureRecorder
+
+TAtomic<bool> FCCDIKCaptureRecorder::bRecording(false);
+
+FCCDIKCaptureRecorder& FCCDIKCaptureRecorder::Get()
+{
+	static FCCDIKCaptureRecorder Instance;
+	return Instance;
+}
+
+void FCCDIKCaptureRecorder::Start()
+{
+	FScopeLock Lock(&CaptureLock);
+	Capture.Reset();
+	bRecording = true;
+}
+
+bool FCCDIKCaptureRecorder::Stop(const FString& Filename)
+{
+	bRecording = false;
+
+	FScopeLock Lock(&CaptureLock);
+	const bool bSaved = Capture.SaveToFile(Filename);
+	UE_LOG(LogAnimation, Display, TEXT("CCDIK capture: %d solves of %d characters %s %s"), Capture.Solves.Num(), Capture.Characters.Num(), bSaved ? TEXT("saved to") : TEXT("could not be saved to"), *Filename);
+	Capture.Reset();
+	return bSaved;
+}
+
+void FCCDIKCaptureRecorder::Record(const FString& Character, const CCDIKSolverCore::FChainView& Chain, const float Target[3], const CCDIKSolverCore::FSolveSettings& Settings)
+{
+	FScopeLock Lock(&CaptureLock);
+	if (bRecording)
+	{
+		Capture.AddSolve(Character, uint32(GFrameCounter), Chain, Target, Settings);
+	}
+}
+
+/////////////////////////////////////////////////////
+// Console commands
+
+static FAutoConsoleCommand CCDIKCaptureStartCommand(
+	TEXT("a.CCDIK.Capture.Start"),
+	TEXT("Start recording the input of every CCDIK chain solve."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FCCDIKCaptureRecorder::Get().Start();
+	}));
+
+static FAutoConsoleCommand CCDIKCaptureStopCommand(
+	TEXT("a.CCDIK.Capture.Stop"),
+	TEXT("Stop recording and save the capture. Optional argument: file name, defaults to Saved/Profiling/CCDIK/Capture.ccdik."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FCCDIKCaptureRecorder::Get().Stop(Args.Num() > 0 ? Args[0] : CCDIKCapture::GetDefaultFilename(TEXT("Capture.ccdik")));
+	}));
+
+static FAutoConsoleCommand CCDIKCaptureReplayCommand(
+	TEXT("a.CCDIK.Capture.Replay"),
+	TEXT("Replay a capture through the solver and report per character cost. Arguments: [CaptureFile] [BaselineFile] [Repeats] [Backend]. ")
+	TEXT("Compares against the baseline if it exists, otherwise stores this run as the baseline. ")
+	TEXT("Backend 0 (CCD), 1 (FABRIK) or 2 (DampedLeastSquares) solves every chain with that backend, to compare them on the same data."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString CaptureFile = Args.Num() > 0 ? Args[0] : CCDIKCapture::GetDefaultFilename(TEXT("Capture.ccdik"));
+		const FString BaselineFile = Args.Num() > 1 ? Args[1] : CCDIKCapture::GetDefaultFilename(TEXT("Baseline.ccdikreport"));
+		const int32 NumRepeats = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 16;
+		const int32 BackendOverride = Args.Num() > 3 ? FCString::Atoi(*Args[3]) : INDEX_NONE;
+
+		FCCDIKCapture Capture;
+		if (!Capture.LoadFromFile(CaptureFile))
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("CCDIK replay: could not load %s"), *CaptureFile);
+			return;
+		}
+
+		FCCDIKReplayReport Report;
+		Report.Run(Capture, NumRepeats, BackendOverride);
+
+		FCCDIKReplayReport Baseline;
+		if (Baseline.LoadFromFile(BaselineFile))
+		{
+			Report.Log(&Baseline);
+		}
+		else
+		{
+			Report.Log();
+			Report.SaveToFile(BaselineFile);
+			UE_LOG(LogAnimation, Display, TEXT("CCDIK replay: baseline stored in %s"), *BaselineFile);
+		}
+	}));
+
+#endif // CCDIK_CAPTURE
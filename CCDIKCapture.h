@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+#include "BoneControllers/CCDIKSolverCore.h"
+
+/** Solve capture and replay, compiled out of shipping builds */
+#define CCDIK_CAPTURE !UE_BUILD_SHIPPING
+
+#if CCDIK_CAPTURE
+
+/** One chain solve, exactly as FAnimNode_CCDIK handed it to the solver */
+struct ANIMGRAPHRUNTIME_API FCCDIKCapturedSolve
+{
+	/** Index into FCCDIKCapture::Characters */
+	int32 CharacterIndex = 0;
+
+	/** Engine frame the solve was recorded on */
+	uint32 Frame = 0;
+
+	int32 NumLinks = 0;
+
+	/** Start of this solve in FCCDIKCapture::Data: PosX..RotW planes, rotation limits, then joint limits if bHasJointLimits */
+	int32 DataOffset = 0;
+
+	bool bHasJointLimits = false;
+
+	/** Component space effector location */
+	float Target[3] = { 0.f, 0.f, 0.f };
+
+	CCDIKSolverCore::FSolveSettings Settings;
+};
+
+/**
+*	Solver input recorded from live characters: chain poses, effector tracks and settings of every chain solve.
+*	Replaying it needs nothing but CCDIKSolverCore, so solver changes can be measured on real data without a world.
+*/
+struct ANIMGRAPHRUNTIME_API FCCDIKCapture
+{
+	/** Skeletal mesh name of every captured character */
+	TArray<FString> Characters;
+
+	TArray<FCCDIKCapturedSolve> Solves;
+
+	/** Float data of all solves, back to back */
+	TArray<float> Data;
+
+	void Reset();
+
+	/** Append a solve. Chain is read before solving, AngleDelta is not recorded since the node zeroes it. */
+	void AddSolve(const FString& Character, uint32 Frame, const CCDIKSolverCore::FChainView& Chain, const float Target[3], const CCDIKSolverCore::FSolveSettings& Settings);
+
+	/** Binary format: magic, version, character table, solve headers, float data */
+	bool SaveToFile(const FString& Filename) const;
+	bool LoadFromFile(const FString& Filename);
+
+	friend ANIMGRAPHRUNTIME_API FArchive& operator<<(FArchive& Ar, FCCDIKCapture& Capture);
+};
+
+/** Replay results of one character */
+struct ANIMGRAPHRUNTIME_API FCCDIKReplayStats
+{
+	FString Character;
+
+	int32 Solves = 0;
+
+	double NanosecondsPerSolve = 0.0;
+
+	double IterationsPerSolve = 0.0;
+
+	/** Distance between tip and target after the solve */
+	float MeanTipError = 0.f;
+	float MaxTipError = 0.f;
+
+	/** CRC of every solved pose, in solve order. Equal between two runs only when the solver output is bit identical. */
+	uint32 OutputHash = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FCCDIKReplayStats& Stats);
+};
+
+/** Per character replay results. Saved as a baseline, later runs are reported against it. */
+struct ANIMGRAPHRUNTIME_API FCCDIKReplayReport
+{
+	TArray<FCCDIKReplayStats> Characters;
+
+	/**
+	*	Solve every captured chain NumRepeats times through the same kernels the node uses, and measure them.
+	*	A valid BackendOverride (a CCDIKSolverCore::ESolverBackend) replaces the recorded backend of every solve.
+	*/
+	void Run(const FCCDIKCapture& Capture, int32 NumRepeats, int32 BackendOverride = INDEX_NONE);
+
+	/** One line per character, with the change from Baseline when given */
+	void Log(const FCCDIKReplayReport* Baseline = nullptr) const;
+
+	bool SaveToFile(const FString& Filename) const;
+	bool LoadFromFile(const FString& Filename);
+
+	friend ANIMGRAPHRUNTIME_API FArchive& operator<<(FArchive& Ar, FCCDIKReplayReport& Report);
+};
+
+/**
+*	Records the solves of every FAnimNode_CCDIK while active, from any anim worker thread.
+*	Driven by the a.CCDIK.Capture.* console commands.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKCaptureRecorder
+{
+public:
+	static FCCDIKCaptureRecorder& Get();
+
+	/** Cheap check for the node before building anything to record */
+	static bool IsRecording() { return bRecording.Load(EMemoryOrder::Relaxed); }
+
+	void Start();
+
+	/** Stop recording and write what was captured. Returns false if the file could not be written. */
+	bool Stop(const FString& Filename);
+
+	void Record(const FString& Character, const CCDIKSolverCore::FChainView& Chain, const float Target[3], const CCDIKSolverCore::FSolveSettings& Settings);
+
+private:
+	static TAtomic<bool> bRecording;
+
+	FCCDIKCapture Capture;
+	FCriticalSection CaptureLock;
+};
+
+#endif // CCDIK_CAPTURE
@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKChainSet.h"
+#include "Engine/SkeletalMesh.h"
+#include "EngineLogs.h"
+
+/////////////////////////////////////////////////////
+// FCCDIKResolvedChainSet
+
+void FCCDIKResolvedChainSet::Reset()
+{
+	RootBones.Reset();
+	TipBones.Reset();
+	EffectorIndices.Reset();
+	Backends.Reset();
+	Dampings.Reset();
+	RetargetScales.Reset();
+	GroundContacts.Reset();
+	RetargetOffsets.Reset();
+	DefaultRotationLimits.Reset();
+	RotationLimitOffsets.Reset();
+	RotationLimits.Reset();
+	JointConstraintOffsets.Reset();
+	JointConstraints.Reset();
+	DescriptorIndices.Reset();
+	LODSettings.Reset();
+	FullBody = FCCDIKFullBodySettings();
+	PelvisBone = INDEX_NONE;
+}
+
+float FCCDIKResolvedChainSet::GetRotationLimit(int32 ChainIndex, int32 JointIndex) const
+{
+	const int32 LimitIndex = RotationLimitOffsets[ChainIndex] + JointIndex;
+	return LimitIndex < RotationLimitOffsets[ChainIndex + 1] ? RotationLimits[LimitIndex] : DefaultRotationLimits[ChainIndex];
+}
+
+const FCCDIKJointConstraint* FCCDIKResolvedChainSet::GetJointConstraint(int32 ChainIndex, int32 JointIndex) const
+{
+	const int32 ConstraintIndex = JointConstraintOffsets[ChainIndex] + JointIndex;
+	return ConstraintIndex < JointConstraintOffsets[ChainIndex + 1] ? &JointConstraints[ConstraintIndex] : nullptr;
+}
+
+int32 FCCDIKResolvedChainSet::FindLODSettings(int32 LODLevel, float Significance) const
+{
+	for (int32 LODIndex = 0; LODIndex < LODSettings.Num(); LODIndex++)
+	{
+		if (LODLevel <= LODSettings[LODIndex].MaxLODLevel && Significance >= LODSettings[LODIndex].MinSignificance)
+		{
+			return LODIndex;
+		}
+	}
+	return LODSettings.Num() - 1;
+}
+
+/////////////////////////////////////////////////////
+// UCCDIKChainSet
+
+namespace CCDIKChainSet
+{
+	/** Append the chains whose bones exist on Mesh to OutResolved. SourceName names the chains' owner in warnings. */
+	static void ResolveChains(const TArray<FCCDIKChainDescriptor>& Chains, const USkeletalMesh* Mesh, const FString& SourceName, FCCDIKResolvedChainSet& OutResolved)
+	{
+		const FReferenceSkeleton& RefSkeleton = Mesh->RefSkeleton;
+
+		OutResolved.RootBones.Reserve(Chains.Num());
+		OutResolved.TipBones.Reserve(Chains.Num());
+		OutResolved.EffectorIndices.Reserve(Chains.Num());
+		OutResolved.Backends.Reserve(Chains.Num());
+		OutResolved.Dampings.Reserve(Chains.Num());
+		OutResolved.RetargetScales.Reserve(Chains.Num());
+		OutResolved.GroundContacts.Reserve(Chains.Num());
+		OutResolved.RetargetOffsets.Reserve(Chains.Num());
+		OutResolved.DefaultRotationLimits.Reserve(Chains.Num());
+		OutResolved.RotationLimitOffsets.Reserve(Chains.Num() + 1);
+		OutResolved.RotationLimitOffsets.Add(0);
+		OutResolved.JointConstraintOffsets.Reserve(Chains.Num() + 1);
+		OutResolved.JointConstraintOffsets.Add(0);
+		OutResolved.DescriptorIndices.Reserve(Chains.Num());
+
+		for (int32 DescriptorIndex = 0; DescriptorIndex < Chains.Num(); DescriptorIndex++)
+		{
+			const FCCDIKChainDescriptor& Chain = Chains[DescriptorIndex];
+			const int32 RootIndex = RefSkeleton.FindBoneIndex(Chain.RootBone);
+			const int32 TipIndex = RefSkeleton.FindBoneIndex(Chain.TipBone);
+			if (RootIndex == INDEX_NONE || TipIndex == INDEX_NONE)
+			{
+				UE_LOG(LogAnimation, Warning, TEXT("CCDIK %s: chain %s -> %s not found on %s, skipping it."),
+					*SourceName, *Chain.RootBone.ToString(), *Chain.TipBone.ToString(), *Mesh->GetName());
+				continue;
+			}
+
+			OutResolved.RootBones.Add(RootIndex);
+			OutResolved.TipBones.Add(TipIndex);
+			OutResolved.EffectorIndices.Add(Chain.EffectorIndex);
+			OutResolved.Backends.Add(Chain.Backend);
+			OutResolved.Dampings.Add(Chain.Damping);
+			OutResolved.RetargetScales.Add(1.f);
+			OutResolved.GroundContacts.Add(Chain.bGroundContact);
+			OutResolved.RetargetOffsets.Add(FVector::ZeroVector);
+			OutResolved.DefaultRotationLimits.Add(Chain.DefaultRotationLimit);
+			OutResolved.RotationLimits.Append(Chain.RotationLimitPerJoints);
+			OutResolved.RotationLimitOffsets.Add(OutResolved.RotationLimits.Num());
+			OutResolved.JointConstraints.Append(Chain.JointConstraints);
+			OutResolved.JointConstraintOffsets.Add(OutResolved.JointConstraints.Num());
+			OutResolved.DescriptorIndices.Add(DescriptorIndex);
+		}
+	}
+}
+
+void UCCDIKChainSet::Resolve(const USkeletalMesh* Mesh, FCCDIKResolvedChainSet& OutResolved) const
+{
+	OutResolved.Reset();
+	if (!Mesh)
+	{
+		return;
+	}
+
+	OutResolved.LODSettings = LODSettings;
+	OutResolved.FullBody = FullBody;
+
+	if (FullBody.bEnabled && !FullBody.PelvisBone.IsNone())
+	{
+		OutResolved.PelvisBone = Mesh->RefSkeleton.FindBoneIndex(FullBody.PelvisBone);
+		if (OutResolved.PelvisBone == INDEX_NONE)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("CCDIK chain set %s: pelvis bone %s not found on %s, the pelvis will not move."),
+				*GetName(), *FullBody.PelvisBone.ToString(), *Mesh->GetName());
+		}
+	}
+
+	CCDIKChainSet::ResolveChains(Chains, Mesh, FString::Printf(TEXT("chain set %s"), *GetName()), OutResolved);
+}
+
+const TArray<FCCDIKChainDescriptor>& UCCDIKChainSet::GetDefaultChains()
+{
+	static const TArray<FCCDIKChainDescriptor> DefaultChains = []()
+	{
+		TArray<FCCDIKChainDescriptor> Chains;
+
+		FCCDIKChainDescriptor& RightArm = Chains.AddDefaulted_GetRef();
+		RightArm.RootBone = TEXT("clavicle_r");
+		RightArm.TipBone = TEXT("hand_r");
+		RightArm.EffectorIndex = 0;
+
+		FCCDIKChainDescriptor& LeftLeg = Chains.AddDefaulted_GetRef();
+		LeftLeg.RootBone = TEXT("thigh_l");
+		LeftLeg.TipBone = TEXT("foot_l");
+		LeftLeg.EffectorIndex = 1;
+
+		for (FCCDIKChainDescriptor& Chain : Chains)
+		{
+			Chain.Backend = ECCDIKSolverBackend::CCD;
+			Chain.DefaultRotationLimit = 50.f;
+		}
+		return Chains;
+	}();
+	return DefaultChains;
+}
+
+void UCCDIKChainSet::ResolveDefaultChains(const USkeletalMesh* Mesh, FCCDIKResolvedChainSet& OutResolved)
+{
+	OutResolved.Reset();
+	if (!Mesh)
+	{
+		return;
+	}
+
+	CCDIKChainSet::ResolveChains(GetDefaultChains(), Mesh, TEXT("default chains"), OutResolved);
+}
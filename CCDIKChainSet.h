@@ -0,0 +1,292 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CCDIKChainSet.generated.h"
+
+class USkeletalMesh;
+
+/** Algorithm solving a chain, see CCDIKSolverCore::ESolverBackend */
+UENUM(BlueprintType)
+enum class ECCDIKSolverBackend : uint8
+{
+	/** Cyclic coordinate descent. Cheapest per iteration, best on short limbs. */
+	CCD,
+
+	/** Forward and backward reaching. Converges in few iterations on long chains such as spine to hand. */
+	FABRIK,
+
+	/** Damped least squares. Smooth, moves every joint a little, steady when the target is out of reach. */
+	DampedLeastSquares UMETA(DisplayName = "Damped Least Squares"),
+};
+
+/** Swing cone and twist range of one joint, relative to its reference pose rotation */
+USTRUCT(BlueprintType)
+struct ANIMGRAPHRUNTIME_API FCCDIKJointConstraint
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Bone space axis the joint twists around, usually the axis pointing down the bone */
+	UPROPERTY(EditAnywhere, Category = Constraint)
+	FVector TwistAxis;
+
+	/** Largest angle, in degrees, the twist axis may swing away from its reference direction */
+	UPROPERTY(EditAnywhere, Category = Constraint, meta = (ClampMin = "0", ClampMax = "180"))
+	float SwingLimit;
+
+	/** Twist range around TwistAxis, in degrees */
+	UPROPERTY(EditAnywhere, Category = Constraint, meta = (ClampMin = "-180", ClampMax = "0"))
+	float MinTwist;
+
+	UPROPERTY(EditAnywhere, Category = Constraint, meta = (ClampMin = "0", ClampMax = "180"))
+	float MaxTwist;
+
+	FCCDIKJointConstraint()
+		: TwistAxis(FVector::ForwardVector)
+		, SwingLimit(180.f)
+		, MinTwist(-180.f)
+		, MaxTwist(180.f)
+	{
+	}
+};
+
+/** Describes one IK chain driven by FAnimNode_CCDIK */
+USTRUCT(BlueprintType)
+struct ANIMGRAPHRUNTIME_API FCCDIKChainDescriptor
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** First bone of the chain. This bone does not rotate. */
+	UPROPERTY(EditAnywhere, Category = Chain)
+	FName RootBone;
+
+	/** Last bone of the chain, moved towards the effector */
+	UPROPERTY(EditAnywhere, Category = Chain)
+	FName TipBone;
+
+	/** Effector driving this chain. 0 is EffectorLocation, 1 is EffectorLocation2, then AdditionalEffectors in order. */
+	UPROPERTY(EditAnywhere, Category = Chain, meta = (ClampMin = "0"))
+	int32 EffectorIndex;
+
+	/** Algorithm solving this chain. Compare them with the per backend CCDIK stats. */
+	UPROPERTY(EditAnywhere, Category = Solver)
+	ECCDIKSolverBackend Backend;
+
+	/** Damping of the damped least squares solver, in component space units. Larger is slower but steadier. */
+	UPROPERTY(EditAnywhere, Category = Solver, meta = (ClampMin = "0.01", EditCondition = "Backend == ECCDIKSolverBackend::DampedLeastSquares"))
+	float Damping;
+
+	/** Rotation limit used for joints without an entry in RotationLimitPerJoints */
+	UPROPERTY(EditAnywhere, Category = Limits, meta = (ClampMin = "0", ClampMax = "180"))
+	float DefaultRotationLimit;
+
+	/** symmetry rotation limit per joint. Index 0 matches with root bone and last index matches with tip bone. */
+	UPROPERTY(EditAnywhere, Category = Limits)
+	TArray<float> RotationLimitPerJoints;
+
+	/** Swing and twist constraint per joint, applied when rotation limits are enabled. Index 0 matches with root bone, which never rotates. */
+	UPROPERTY(EditAnywhere, Category = Limits)
+	TArray<FCCDIKJointConstraint> JointConstraints;
+
+	/** Move the effector onto the ground below it when the node's contact stage is enabled. Meant for feet and planted hands. */
+	UPROPERTY(EditAnywhere, Category = Contact)
+	bool bGroundContact;
+
+	FCCDIKChainDescriptor()
+		: EffectorIndex(0)
+		, Backend(ECCDIKSolverBackend::CCD)
+		, Damping(1.f)
+		, DefaultRotationLimit(50.f)
+		, bGroundContact(false)
+	{
+	}
+};
+
+/** Solver cost settings for one IK level of detail */
+USTRUCT(BlueprintType)
+struct ANIMGRAPHRUNTIME_API FCCDIKLODSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** This entry applies while the mesh's predicted LOD is at or below this level... */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (ClampMin = "0"))
+	int32 MaxLODLevel;
+
+	/** ...and the node's Significance is at least this */
+	UPROPERTY(EditAnywhere, Category = LOD)
+	float MinSignificance;
+
+	/** Maximum number of iterations allowed at this level */
+	UPROPERTY(EditAnywhere, Category = Solver, meta = (ClampMin = "0"))
+	int32 MaxIterations;
+
+	/** Tolerance for final tip location delta from EffectorLocation at this level */
+	UPROPERTY(EditAnywhere, Category = Solver, meta = (ClampMin = "0.0"))
+	float Precision;
+
+	/** Indices into Chains of the chains solved at this level. Empty solves every chain. */
+	UPROPERTY(EditAnywhere, Category = Solver)
+	TArray<int32> ActiveChains;
+
+	/** Solve every Nth frame. Frames in between blend towards the latest solution. */
+	UPROPERTY(EditAnywhere, Category = Solver, meta = (ClampMin = "1"))
+	int32 UpdateInterval;
+
+	/**
+	*	Solves per second, overriding UpdateInterval when above 0. Evaluations in between blend towards the latest
+	*	solution by elapsed time, so the solve cost stays the same whatever rate the animation ticks at.
+	*/
+	UPROPERTY(EditAnywhere, Category = Solver, meta = (ClampMin = "0.0"))
+	float SolveRate;
+
+	FCCDIKLODSettings()
+		: MaxLODLevel(0)
+		, MinSignificance(0.f)
+		, MaxIterations(10)
+		, Precision(1.f)
+		, UpdateInterval(1)
+		, SolveRate(0.f)
+	{
+	}
+};
+
+/** Solves every chain of the set together, so limbs can pull on the bones they share and on the pelvis */
+USTRUCT(BlueprintType)
+struct ANIMGRAPHRUNTIME_API FCCDIKFullBodySettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	/**
+	*	Chains sharing ancestor bones (two arms rooted below spine_01 both rotating spine_02, say) are solved in turns,
+	*	each one starting from the shared bones as the others left them. Off, every chain solves on its own from its root.
+	*/
+	UPROPERTY(EditAnywhere, Category = FullBody)
+	bool bEnabled;
+
+	/** Rounds over all chains. Every round gives each chain MaxIterations / Passes iterations. */
+	UPROPERTY(EditAnywhere, Category = FullBody, meta = (ClampMin = "1", EditCondition = "bEnabled"))
+	int32 Passes;
+
+	/** Bone moved towards targets the chains below it cannot reach. None keeps the pelvis in place. */
+	UPROPERTY(EditAnywhere, Category = FullBody, meta = (EditCondition = "bEnabled"))
+	FName PelvisBone;
+
+	/** Share of the average out of reach distance the pelvis moves by. Chains that reach their target hold it back. */
+	UPROPERTY(EditAnywhere, Category = FullBody, meta = (ClampMin = "0", ClampMax = "1", EditCondition = "bEnabled"))
+	float PelvisOffsetWeight;
+
+	/** Largest distance the pelvis may move from its animated location, in component space units */
+	UPROPERTY(EditAnywhere, Category = FullBody, meta = (ClampMin = "0", EditCondition = "bEnabled"))
+	float MaxPelvisOffset;
+
+	FCCDIKFullBodySettings()
+		: bEnabled(false)
+		, Passes(2)
+		, PelvisOffsetWeight(0.5f)
+		, MaxPelvisOffset(20.f)
+	{
+	}
+};
+
+/**
+*	Chain set resolved against a reference skeleton. Bone names are looked up once, after that the node only deals with indices.
+*	Data is kept as parallel arrays so a whole chain set is a handful of contiguous buffers.
+*/
+struct ANIMGRAPHRUNTIME_API FCCDIKResolvedChainSet
+{
+	/** Reference skeleton index of the root bone of each chain */
+	TArray<FBoneIndexType> RootBones;
+
+	/** Reference skeleton index of the tip bone of each chain */
+	TArray<FBoneIndexType> TipBones;
+
+	/** Effector driving each chain */
+	TArray<int32> EffectorIndices;
+
+	/** Solver backend and damping of each chain */
+	TArray<ECCDIKSolverBackend> Backends;
+	TArray<float> Dampings;
+
+	/** Effector retargeting of each chain: Scale * Effector + Offset. Identity without a retarget table. */
+	TArray<float> RetargetScales;
+	TArray<FVector> RetargetOffsets;
+
+	/** Whether each chain's effector follows the ground, see FCCDIKChainDescriptor::bGroundContact */
+	TArray<bool> GroundContacts;
+
+	/** Default rotation limit of each chain, in degrees */
+	TArray<float> DefaultRotationLimits;
+
+	/** Start of each chain's limits in RotationLimits, with one extra entry marking the end */
+	TArray<int32> RotationLimitOffsets;
+
+	/** Authored per joint rotation limits of all chains, back to back */
+	TArray<float> RotationLimits;
+
+	/** Start of each chain's constraints in JointConstraints, with one extra entry marking the end */
+	TArray<int32> JointConstraintOffsets;
+
+	/** Authored per joint constraints of all chains, back to back */
+	TArray<FCCDIKJointConstraint> JointConstraints;
+
+	/** Index in UCCDIKChainSet::Chains of each resolved chain */
+	TArray<int32> DescriptorIndices;
+
+	/** Copy of UCCDIKChainSet::LODSettings */
+	TArray<FCCDIKLODSettings> LODSettings;
+
+	/** Copy of UCCDIKChainSet::FullBody */
+	FCCDIKFullBodySettings FullBody;
+
+	/** Reference skeleton index of FullBody.PelvisBone, INDEX_NONE when not set or not found */
+	int32 PelvisBone = INDEX_NONE;
+
+	int32 Num() const { return RootBones.Num(); }
+
+	/** First LOD entry matching the mesh LOD and significance, the last entry if none does, INDEX_NONE without a LOD table */
+	int32 FindLODSettings(int32 LODLevel, float Significance) const;
+
+	void Reset();
+
+	/** Rotation limit of a joint, falling back to the chain default when it was not authored */
+	float GetRotationLimit(int32 ChainIndex, int32 JointIndex) const;
+
+	/** Swing and twist constraint of a joint, nullptr when it was not authored */
+	const FCCDIKJointConstraint* GetJointConstraint(int32 ChainIndex, int32 JointIndex) const;
+};
+
+/**
+*	Per-character description of the chains solved by the CCDIK node.
+*	Lets one node drive any number of limbs on any skeleton without hardcoded bone names.
+*/
+UCLASS(BlueprintType)
+class ANIMGRAPHRUNTIME_API UCCDIKChainSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = Chains)
+	TArray<FCCDIKChainDescriptor> Chains;
+
+	/** IK levels of detail, most expensive first. Checked in order, the first matching entry is used. Empty runs the node settings every frame. */
+	UPROPERTY(EditAnywhere, Category = LOD)
+	TArray<FCCDIKLODSettings> LODSettings;
+
+	/** Solve all chains together instead of one by one, see FCCDIKFullBodySettings */
+	UPROPERTY(EditAnywhere, Category = FullBody)
+	FCCDIKFullBodySettings FullBody;
+
+	/** Resolve every chain against the reference skeleton of Mesh. Chains with missing bones are skipped and reported. */
+	void Resolve(const USkeletalMesh* Mesh, FCCDIKResolvedChainSet& OutResolved) const;
+
+	/**
+	*	Chains a node without a chain set solves, the two it always solved before chain sets existed: clavicle_r to hand_r
+	*	towards EffectorLocation and thigh_l to foot_l towards EffectorLocation2, CCD with 50 degree rotation limits.
+	*/
+	static const TArray<FCCDIKChainDescriptor>& GetDefaultChains();
+
+	/** Resolve GetDefaultChains against the reference skeleton of Mesh, without LOD table or full body solve */
+	static void ResolveDefaultChains(const USkeletalMesh* Mesh, FCCDIKResolvedChainSet& OutResolved);
+};
@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKChainStorage.h"
+
+void FCCDIKChainStorage::Reset()
+{
+	ChainOffsets.Reset();
+	BoneIndices.Reset();
+	ParentLinks.Reset();
+	ZeroLengthChildOffsets.Reset();
+	ZeroLengthChildren.Reset();
+	RotationLimits.Reset();
+	JointLimits.Reset();
+	LocalTransforms.Reset();
+	Scales.Reset();
+	SolverData.Reset();
+	Views.Reset();
+}
+
+int32 FCCDIKChainStorage::AddChain(int32 NumLinks)
+{
+	if (ChainOffsets.Num() == 0)
+	{
+		ChainOffsets.Add(0);
+		ZeroLengthChildOffsets.Add(0);
+	}
+
+	const int32 FirstLink = BoneIndices.Num();
+	ChainOffsets.Add(FirstLink + NumLinks);
+
+	BoneIndices.AddUninitialized(NumLinks);
+	RotationLimits.AddUninitialized(NumLinks);
+	JointLimits.AddDefaulted(NumLinks);
+	ParentLinks.AddUninitialized(NumLinks);
+	for (int32 LinkIndex = 0; LinkIndex < NumLinks; LinkIndex++)
+	{
+		ParentLinks[FirstLink + LinkIndex] = LinkIndex > 0 ? FirstLink + LinkIndex - 1 : INDEX_NONE;
+		ZeroLengthChildOffsets.Add(ZeroLengthChildren.Num());
+	}
+
+	return FirstLink;
+}
+
+void FCCDIKChainStorage::AddZeroLengthChild(int32 Link, FCompactPoseBoneIndex BoneIndex)
+{
+	checkSlow(Link >= ChainOffsets[Num() - 1] && Link < GetTotalLinks());
+	ZeroLengthChildren.Add(BoneIndex);
+
+	// Children are added in link order, so only the end of this link's range and of the links after it move
+	for (int32 NextLink = Link + 1; NextLink < ZeroLengthChildOffsets.Num(); NextLink++)
+	{
+		ZeroLengthChildOffsets[NextLink]++;
+	}
+}
+
+void FCCDIKChainStorage::Finalize()
+{
+	const int32 TotalLinks = GetTotalLinks();
+	LocalTransforms.SetNumUninitialized(TotalLinks, false);
+	Scales.SetNumUninitialized(TotalLinks, false);
+	SolverData.SetNumUninitialized(TotalLinks * 8, false);
+	Views.SetNum(Num(), false);
+
+	for (int32 ChainIndex = 0; ChainIndex < Num(); ChainIndex++)
+	{
+		const int32 FirstLink = GetFirstLink(ChainIndex);
+		const int32 NumLinks = GetNumLinks(ChainIndex);
+
+		CCDIKSolverCore::FChainView& View = Views[ChainIndex];
+		View.PosX = SolverData.GetData() + FirstLink * 8;
+		View.PosY = View.PosX + NumLinks;
+		View.PosZ = View.PosY + NumLinks;
+		View.RotX = View.PosZ + NumLinks;
+		View.RotY = View.RotX + NumLinks;
+		View.RotZ = View.RotY + NumLinks;
+		View.RotW = View.RotZ + NumLinks;
+		View.AngleDelta = View.RotW + NumLinks;
+		View.RotationLimits = RotationLimits.GetData() + FirstLink;
+		View.NumLinks = NumLinks;
+
+		// Chains without any constrained joint skip the swing-twist clamp entirely
+		View.JointLimits = nullptr;
+		for (int32 LinkIndex = 0; LinkIndex < NumLinks; LinkIndex++)
+		{
+			if (JointLimits[FirstLink + LinkIndex].IsLimited())
+			{
+				View.JointLimits = JointLimits.GetData() + FirstLink;
+				break;
+			}
+		}
+	}
+}
+
+SIZE_T FCCDIKChainStorage::GetAllocatedSize() const
+{
+	return ChainOffsets.GetAllocatedSize() + BoneIndices.GetAllocatedSize() + ParentLinks.GetAllocatedSize() + ZeroLengthChildOffsets.GetAllocatedSize()
+		+ ZeroLengthChildren.GetAllocatedSize() + RotationLimits.GetAllocatedSize()
+		+ JointLimits.GetAllocatedSize() + LocalTransforms.GetAllocatedSize() + Scales.GetAllocatedSize() + SolverData.GetAllocatedSize() + Views.GetAllocatedSize();
+}
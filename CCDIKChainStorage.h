@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoneIndices.h"
+#include "BoneControllers/CCDIKSolverCore.h"
+
+/**
+*	Every IK chain of one FAnimNode_CCDIK in a single structure of arrays.
+*
+*	Per link data of all chains is stored back to back, chain c owning links [ChainOffsets[c], ChainOffsets[c + 1]).
+*	Solver data is one buffer holding, per chain, the PosX..RotW and AngleDelta planes of its links, so refreshing,
+*	solving and writing back stream through memory instead of chasing one allocation per chain and per link.
+*/
+struct ANIMGRAPHRUNTIME_API FCCDIKChainStorage
+{
+	/** First link of each chain in the per link arrays, with one extra entry marking the end */
+	TArray<int32> ChainOffsets;
+
+	/** Compact pose bone of each link, root link of a chain first */
+	TArray<FCompactPoseBoneIndex> BoneIndices;
+
+	/** Per link index of the parent link in these arrays, INDEX_NONE for the root link of a chain */
+	TArray<int32> ParentLinks;
+
+	/** First zero length child of each link in ZeroLengthChildren, with one extra entry marking the end */
+	TArray<int32> ZeroLengthChildOffsets;
+
+	/** Zero length bones sitting on a link. They are not solved, they follow the link above them. */
+	TArray<FCompactPoseBoneIndex> ZeroLengthChildren;
+
+	/** Symmetric rotation limit of each link, in radians */
+	TArray<float> RotationLimits;
+
+	/** Precompiled swing and twist limit of each link, unlimited unless the chain set constrains the joint */
+	TArray<CCDIKSolverCore::FJointLimit> JointLimits;
+
+	/** Local space transform of each link from the input pose, refreshed every evaluate */
+	TArray<FTransform> LocalTransforms;
+
+	/** Component space scale of each link from the input pose. The solver only moves and rotates links. */
+	TArray<FVector> Scales;
+
+	/** Component space solver planes of every chain, 8 floats per link */
+	TArray<float> SolverData;
+
+	/** Solver view of each chain into SolverData, RotationLimits and JointLimits, valid after Finalize */
+	TArray<CCDIKSolverCore::FChainView> Views;
+
+	/** Remove every chain, keeping memory for the next build */
+	void Reset();
+
+	/** Append a chain of NumLinks links and return its first link. BoneIndices and RotationLimits are left for the caller to fill, JointLimits start unlimited. */
+	int32 AddChain(int32 NumLinks);
+
+	/** Attach a zero length bone to a link of the last added chain. Children must be added in link order. */
+	void AddZeroLengthChild(int32 Link, FCompactPoseBoneIndex BoneIndex);
+
+	/** Lay out the per link buffers and views once every chain was added */
+	void Finalize();
+
+	int32 Num() const { return ChainOffsets.Num() > 0 ? ChainOffsets.Num() - 1 : 0; }
+	int32 GetTotalLinks() const { return BoneIndices.Num(); }
+	int32 GetFirstLink(int32 ChainIndex) const { return ChainOffsets[ChainIndex]; }
+	int32 GetNumLinks(int32 ChainIndex) const { return ChainOffsets[ChainIndex + 1] - ChainOffsets[ChainIndex]; }
+	int32 GetTotalZeroLengthChildren() const { return ZeroLengthChildren.Num(); }
+
+	FVector GetLocation(int32 ChainIndex, int32 LinkIndex) const
+	{
+		const CCDIKSolverCore::FChainView& View = Views[ChainIndex];
+		return FVector(View.PosX[LinkIndex], View.PosY[LinkIndex], View.PosZ[LinkIndex]);
+	}
+
+	FQuat GetRotation(int32 ChainIndex, int32 LinkIndex) const
+	{
+		const CCDIKSolverCore::FChainView& View = Views[ChainIndex];
+		return FQuat(View.RotX[LinkIndex], View.RotY[LinkIndex], View.RotZ[LinkIndex], View.RotW[LinkIndex]);
+	}
+
+	/** Current component space transform of a link */
+	FTransform GetTransform(int32 ChainIndex, int32 LinkIndex) const
+	{
+		return FTransform(GetRotation(ChainIndex, LinkIndex), GetLocation(ChainIndex, LinkIndex), Scales[GetFirstLink(ChainIndex) + LinkIndex]);
+	}
+
+	/** Set the component space location and rotation of a link, scale stays the input one */
+	void SetTransform(int32 ChainIndex, int32 LinkIndex, const FTransform& Transform)
+	{
+		const CCDIKSolverCore::FChainView& View = Views[ChainIndex];
+		const FVector Location = Transform.GetLocation();
+		const FQuat Rotation = Transform.GetRotation();
+		View.PosX[LinkIndex] = Location.X;
+		View.PosY[LinkIndex] = Location.Y;
+		View.PosZ[LinkIndex] = Location.Z;
+		View.RotX[LinkIndex] = Rotation.X;
+		View.RotY[LinkIndex] = Rotation.Y;
+		View.RotZ[LinkIndex] = Rotation.Z;
+		View.RotW[LinkIndex] = Rotation.W;
+	}
+
+	SIZE_T GetAllocatedSize() const;
+};
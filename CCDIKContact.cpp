@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKContact.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+
+void FCCDIKSceneContactWorld::SetWorld(UWorld* InWorld, ECollisionChannel InTraceChannel, const FCollisionQueryParams& InQueryParams)
+{
+	World = InWorld;
+	TraceChannel = InTraceChannel;
+	QueryParams = InQueryParams;
+}
+
+void FCCDIKSceneContactWorld::SubmitRays(const FCCDIKContactRay* Rays, int32 NumRays, FCCDIKContactHandle* OutHandles)
+{
+	UWorld* TraceWorld = World.Get();
+	for (int32 RayIndex = 0; RayIndex < NumRays; RayIndex++)
+	{
+		FCCDIKContactHandle& Handle = OutHandles[RayIndex];
+		Handle = FCCDIKContactHandle();
+		if (!TraceWorld)
+		{
+			continue;
+		}
+
+		const FTraceHandle TraceHandle = TraceWorld->AsyncLineTraceByChannel(EAsyncTraceType::Single, Rays[RayIndex].Start, Rays[RayIndex].End, TraceChannel, QueryParams);
+		Handle.Frame = TraceHandle._Data.FrameNumber;
+		Handle.Index = TraceHandle._Data.Index;
+		Handle.bValid = true;
+	}
+}
+
+bool FCCDIKSceneContactWorld::FetchResult(const FCCDIKContactHandle& Handle, FCCDIKContactHit& OutHit)
+{
+	OutHit = FCCDIKContactHit();
+
+	// Rays of a world that went away, or that the world already forgot, count as misses
+	UWorld* TraceWorld = World.Get();
+	if (!Handle.bValid || !TraceWorld)
+	{
+		return true;
+	}
+
+	const FTraceHandle TraceHandle(Handle.Frame, Handle.Index);
+	FTraceDatum TraceData;
+	if (!TraceWorld->QueryTraceData(TraceHandle, TraceData))
+	{
+		return !TraceWorld->IsTraceHandleValid(TraceHandle, false);
+	}
+
+	for (const FHitResult& Hit : TraceData.OutHits)
+	{
+		if (Hit.bBlockingHit)
+		{
+			OutHit.bHit = true;
+			OutHit.Location = Hit.ImpactPoint;
+			OutHit.Normal = Hit.ImpactNormal;
+			break;
+		}
+	}
+	return true;
+}
+
+FCCDIKFlatGroundContactWorld::FCCDIKFlatGroundContactWorld(const FVector& InPlanePoint, const FVector& InPlaneNormal)
+	: PlanePoint(InPlanePoint)
+	, PlaneNormal(InPlaneNormal.GetSafeNormal(SMALL_NUMBER, FVector::UpVector))
+{
+}
+
+void FCCDIKFlatGroundContactWorld::AdvanceFrame()
+{
+	Swap(CurrentRays, PreviousRays);
+	CurrentRays.Reset();
+	Frame++;
+}
+
+void FCCDIKFlatGroundContactWorld::SubmitRays(const FCCDIKContactRay* Rays, int32 NumRays, FCCDIKContactHandle* OutHandles)
+{
+	for (int32 RayIndex = 0; RayIndex < NumRays; RayIndex++)
+	{
+		FCCDIKContactHandle& Handle = OutHandles[RayIndex];
+		Handle.Frame = Frame;
+		Handle.Index = CurrentRays.Add(Rays[RayIndex]);
+		Handle.bValid = true;
+	}
+}
+
+bool FCCDIKFlatGroundContactWorld::FetchResult(const FCCDIKContactHandle& Handle, FCCDIKContactHit& OutHit)
+{
+	OutHit = FCCDIKContactHit();
+	if (!Handle.bValid)
+	{
+		return true;
+	}
+	if (Handle.Frame == Frame)
+	{
+		return false;
+	}
+	if (Handle.Frame + 1 != Frame || !PreviousRays.IsValidIndex(Handle.Index))
+	{
+		return true;
+	}
+
+	// Segment against the plane, hit from either side
+	const FCCDIKContactRay& Ray = PreviousRays[Handle.Index];
+	const float StartDistance = (Ray.Start - PlanePoint) | PlaneNormal;
+	const float EndDistance = (Ray.End - PlanePoint) | PlaneNormal;
+	if (StartDistance * EndDistance > 0.f || StartDistance == EndDistance)
+	{
+		return true;
+	}
+
+	OutHit.bHit = true;
+	OutHit.Location = FMath::Lerp(Ray.Start, Ray.End, StartDistance / (StartDistance - EndDistance));
+	OutHit.Normal = StartDistance >= 0.f ? PlaneNormal : -PlaneNormal;
+	return true;
+}
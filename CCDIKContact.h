@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+
+class UWorld;
+
+/** One world space ray of a contact query */
+struct FCCDIKContactRay
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+};
+
+/** What a contact ray hit. bHit is false for misses and for rays the world dropped. */
+struct FCCDIKContactHit
+{
+	bool bHit = false;
+
+	/** World space surface point and normal */
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+};
+
+/** Ray submitted to an ICCDIKContactWorld, meaningful only to the world that returned it */
+struct FCCDIKContactHandle
+{
+	uint32 Frame = 0;
+	uint32 Index = 0;
+	bool bValid = false;
+};
+
+/**
+*	Collision the CCDIK contact stage queries. Rays submitted in one frame are answered from the next frame on,
+*	so nothing waits on collision. Game thread only.
+*
+*	The node uses FCCDIKSceneContactWorld by default, a stand-in world with its own geometry can be set with
+*	FAnimNode_CCDIK::SetContactWorld to run the contact stage without a level, FCCDIKFlatGroundContactWorld is the simplest.
+*/
+class ANIMGRAPHRUNTIME_API ICCDIKContactWorld
+{
+public:
+	virtual ~ICCDIKContactWorld() {}
+
+	/** Queue every ray of one character together. OutHandles receives one handle per ray. */
+	virtual void SubmitRays(const FCCDIKContactRay* Rays, int32 NumRays, FCCDIKContactHandle* OutHandles) = 0;
+
+	/** Result of a submitted ray. False while it is still pending, true once OutHit is filled. */
+	virtual bool FetchResult(const FCCDIKContactHandle& Handle, FCCDIKContactHit& OutHit) = 0;
+};
+
+/**
+*	Contact world backed by the physics scene, through the world's async line traces. Rays queued together end up in
+*	the same async trace batch, which runs alongside the rest of the frame.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKSceneContactWorld : public ICCDIKContactWorld
+{
+public:
+	/** World to trace against, channel and parameters of the next rays. Pending rays stay with the world they were submitted to. */
+	void SetWorld(UWorld* InWorld, ECollisionChannel InTraceChannel, const FCollisionQueryParams& InQueryParams);
+
+	// ICCDIKContactWorld interface
+	virtual void SubmitRays(const FCCDIKContactRay* Rays, int32 NumRays, FCCDIKContactHandle* OutHandles) override;
+	virtual bool FetchResult(const FCCDIKContactHandle& Handle, FCCDIKContactHit& OutHit) override;
+	// End of ICCDIKContactWorld interface
+
+private:
+	TWeakObjectPtr<UWorld> World;
+	ECollisionChannel TraceChannel = ECC_Visibility;
+	FCollisionQueryParams QueryParams;
+};
+
+/**
+*	Contact world made of one infinite plane, for running the contact stage without a level. Like the scene world,
+*	rays submitted in one frame are only answered once AdvanceFrame has been called, rays older than the previous frame
+*	count as misses.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKFlatGroundContactWorld : public ICCDIKContactWorld
+{
+public:
+	FCCDIKFlatGroundContactWorld(const FVector& InPlanePoint = FVector::ZeroVector, const FVector& InPlaneNormal = FVector::UpVector);
+
+	/** Start the next frame, making the rays of the current one answerable */
+	void AdvanceFrame();
+
+	// ICCDIKContactWorld interface
+	virtual void SubmitRays(const FCCDIKContactRay* Rays, int32 NumRays, FCCDIKContactHandle* OutHandles) override;
+	virtual bool FetchResult(const FCCDIKContactHandle& Handle, FCCDIKContactHit& OutHit) override;
+	// End of ICCDIKContactWorld interface
+
+private:
+	FVector PlanePoint;
+	FVector PlaneNormal;
+
+	uint32 Frame = 1;
+
+	/** Rays submitted in the current and in the previous frame */
+	TArray<FCCDIKContactRay> CurrentRays;
+	TArray<FCCDIKContactRay> PreviousRays;
+};
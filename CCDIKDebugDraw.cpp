@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKDebugDraw.h"
+
+#if CCDIK_DEBUG_DRAW
+
+#include "Engine/World.h"
+#include "Components/LineBatchComponent.h"
+
+bool FCCDIKDebugLineBuffer::Add(const FVector& Start, const FVector& End, const FColor& Color, float Thickness)
+{
+	const uint32 CurrentHead = Head.Load(EMemoryOrder::Relaxed);
+	if (CurrentHead - Tail.Load() >= Capacity)
+	{
+		return false;
+	}
+
+	FLine& Line = Lines[CurrentHead & (Capacity - 1)];
+	Line.Start = Start;
+	Line.End = End;
+	Line.Color = Color;
+	Line.Thickness = Thickness;
+
+	// Publish the line only once it is fully written
+	Head.Store(CurrentHead + 1);
+	return true;
+}
+
+void FCCDIKDebugLineBuffer::Flush(UWorld* World, const FTransform& ComponentToWorld, TArray<FVector>* OutPoints)
+{
+	const uint32 CurrentTail = Tail.Load(EMemoryOrder::Relaxed);
+	const uint32 CurrentHead = Head.Load();
+	if (CurrentHead == CurrentTail)
+	{
+		return;
+	}
+
+	ULineBatchComponent* LineBatcher = World ? World->LineBatcher : nullptr;
+
+	TArray<FBatchedLine> BatchedLines;
+	BatchedLines.Reserve(LineBatcher ? CurrentHead - CurrentTail : 0);
+	for (uint32 LineIndex = CurrentTail; LineIndex != CurrentHead; LineIndex++)
+	{
+		const FLine& Line = Lines[LineIndex & (Capacity - 1)];
+		if (LineBatcher)
+		{
+			BatchedLines.Emplace(ComponentToWorld.TransformPosition(Line.Start), ComponentToWorld.TransformPosition(Line.End), FLinearColor(Line.Color), 0.f, Line.Thickness, SDPG_World);
+		}
+		if (OutPoints)
+		{
+			OutPoints->Add(Line.Start);
+			OutPoints->Add(Line.End);
+		}
+	}
+
+	// Hand the slots back to the producer before drawing
+	Tail.Store(CurrentHead);
+
+	if (LineBatcher)
+	{
+		LineBatcher->DrawLines(BatchedLines);
+	}
+}
+
+#endif // CCDIK_DEBUG_DRAW
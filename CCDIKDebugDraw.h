@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+/** Debug drawing of CCDIK chains, compiled out of shipping and test builds */
+#define CCDIK_DEBUG_DRAW !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+#if CCDIK_DEBUG_DRAW
+
+class UWorld;
+
+/**
+*	Lines recorded by one FAnimNode_CCDIK while it evaluates on a worker thread, drawn by the game thread once per frame.
+*
+*	Single producer (the evaluating worker) and single consumer (the game thread in PreUpdate), so a fixed ring with
+*	two counters is enough: no locks, no allocations and no task per line. Lines are dropped when the ring is full.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKDebugLineBuffer
+{
+public:
+	/** Ring size, a power of two */
+	static const uint32 Capacity = 512;
+
+	/** Record a line in component space. Worker thread. Returns false if the line was dropped. */
+	bool Add(const FVector& Start, const FVector& End, const FColor& Color, float Thickness);
+
+	/**
+	*	Draw every pending line in a single batch on the world's line batcher, moved to world space by ComponentToWorld.
+	*	Game thread. Component space end points are also appended to OutPoints when given.
+	*/
+	void Flush(UWorld* World, const FTransform& ComponentToWorld, TArray<FVector>* OutPoints = nullptr);
+
+private:
+	struct FLine
+	{
+		FVector Start;
+		FVector End;
+		FColor Color;
+		float Thickness;
+	};
+
+	FLine Lines[Capacity];
+
+	/** Lines written so far, only advanced by the producer */
+	TAtomic<uint32> Head { 0 };
+
+	/** Lines drawn so far, only advanced by the consumer */
+	TAtomic<uint32> Tail { 0 };
+};
+
+#endif // CCDIK_DEBUG_DRAW
@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKFrameArena.h"
+
+FCCDIKFrameArena::~FCCDIKFrameArena()
+{
+	FreeSpilledBlocks();
+}
+
+void FCCDIKFrameArena::Reserve(int32 NumBytes)
+{
+	if (NumBytes > Memory.Num())
+	{
+		// Contents do not survive a Reset anyway, only the capacity matters
+		Memory.Empty(NumBytes);
+		Memory.AddUninitialized(NumBytes);
+	}
+}
+
+void FCCDIKFrameArena::Reset()
+{
+	FreeSpilledBlocks();
+
+	// Growing to last frame's high water mark is an allocation of this frame
+	NumHeapAllocations = HighWaterBytes > Memory.Num() ? 1 : 0;
+	Reserve(HighWaterBytes);
+
+	Offset = 0;
+	UsedBytes = 0;
+}
+
+void* FCCDIKFrameArena::Alloc(int32 NumBytes, int32 Alignment)
+{
+	UsedBytes += NumBytes + Alignment;
+	HighWaterBytes = FMath::Max(HighWaterBytes, UsedBytes);
+
+	const int32 AlignedOffset = Align(Offset, Alignment);
+	if (AlignedOffset + NumBytes <= Memory.Num())
+	{
+		Offset = AlignedOffset + NumBytes;
+		return Memory.GetData() + AlignedOffset;
+	}
+
+	NumHeapAllocations++;
+	void* Block = FMemory::Malloc(NumBytes, Alignment);
+	SpilledBlocks.Add(Block);
+	return Block;
+}
+
+void FCCDIKFrameArena::FreeSpilledBlocks()
+{
+	for (void* Block : SpilledBlocks)
+	{
+		FMemory::Free(Block);
+	}
+	SpilledBlocks.Reset();
+}
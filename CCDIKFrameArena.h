@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+*	Linear allocator for memory that only lives for one FAnimNode_CCDIK evaluation.
+*
+*	Sized when the chains are built and reset at the start of every evaluation, so the steady state makes no heap
+*	allocations. Requests that do not fit are served from the heap and counted; the arena grows to the high water
+*	mark on the next Reset so the spill does not repeat, and that growth is counted as well.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKFrameArena
+{
+public:
+	FCCDIKFrameArena() = default;
+	~FCCDIKFrameArena();
+
+	/** Node copies start with an empty arena, spilled blocks are never shared */
+	FCCDIKFrameArena(const FCCDIKFrameArena&) {}
+	FCCDIKFrameArena& operator=(const FCCDIKFrameArena&) { return *this; }
+
+	/** Make sure at least NumBytes fit without spilling. May allocate, call at init. */
+	void Reserve(int32 NumBytes);
+
+	/**
+	*	Release everything allocated since the last Reset and restart the heap allocation count. When the last frame
+	*	spilled, the arena grows here and the new count starts at one.
+	*/
+	void Reset();
+
+	/** Uninitialized storage for Num elements, valid until the next Reset */
+	template<typename T>
+	T* Alloc(int32 Num)
+	{
+		return static_cast<T*>(Alloc(Num * (int32)sizeof(T), (int32)alignof(T)));
+	}
+
+	void* Alloc(int32 NumBytes, int32 Alignment);
+
+	/** Heap allocations made by the last Reset and since, zero at steady state */
+	int32 GetNumHeapAllocations() const { return NumHeapAllocations; }
+
+	/** Capacity of the arena itself, spilled blocks excluded */
+	SIZE_T GetAllocatedSize() const { return Memory.GetAllocatedSize(); }
+
+	/** Bytes handed out since the last Reset */
+	int32 GetUsedBytes() const { return UsedBytes; }
+
+private:
+	void FreeSpilledBlocks();
+
+	TArray<uint8, TAlignedHeapAllocator<16>> Memory;
+
+	/** Blocks allocated on the heap because Memory was full */
+	TArray<void*, TInlineAllocator<4>> SpilledBlocks;
+
+	int32 Offset = 0;
+	int32 UsedBytes = 0;
+	int32 HighWaterBytes = 0;
+	int32 NumHeapAllocations = 0;
+};
@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKOpportunisticBatcher.h"
+#include "BoneControllers/AnimNode_CCDIK.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_CYCLE_STAT(TEXT("CCDIK Batch Group Solve"), STAT_CCDIK_BatchGroupSolve, STATGROUP_CCDIK);
+DECLARE_DWORD_COUNTER_STAT(TEXT("CCDIK Batch Jobs Shared"), STAT_CCDIK_BatchJobsShared, STATGROUP_CCDIK);
+
+namespace CCDIKOpportunisticBatcher
+{
+	/** How far into the queue to look for jobs that can share lanes with the leading one */
+	static const int32 MaxGroupSearch = 32;
+
+	/** Scratch kept on the stack for groups of chains up to this many links */
+	static const int32 InlineScratchLinks = 16;
+}
+
+FCCDIKOpportunisticBatcher& FCCDIKOpportunisticBatcher::Get()
+{
+	static FCCDIKOpportunisticBatcher Instance;
+	return Instance;
+}
+
+void FCCDIKOpportunisticBatcher::Solve(FCCDIKBatchOwner& Owner, FCCDIKBatchJob* Jobs, int32 NumJobs)
+{
+	using namespace CCDIKSolverCore;
+
+	// Publish every job first, so groups taken by this and other owners can mix them
+	{
+		FScopeLock Lock(&QueueLock);
+		Queue.Reserve(Queue.Num() + NumJobs);
+		for (int32 JobIndex = 0; JobIndex < NumJobs; JobIndex++)
+		{
+			Jobs[JobIndex].Owner = &Owner;
+			Queue.Add(&Jobs[JobIndex]);
+		}
+	}
+
+	FCCDIKBatchJob* Group[GroupWidth];
+	FCCDIKBatchOwner* LockedOwners[GroupWidth];
+	int32 NumLockedOwners = 0;
+	while (const int32 NumInGroup = TakeGroup(Owner, Group, LockedOwners, NumLockedOwners))
+	{
+		SolveGroup(Group, NumInGroup);
+		for (int32 OwnerIndex = 0; OwnerIndex < NumLockedOwners; OwnerIndex++)
+		{
+			LockedOwners[OwnerIndex]->SolveLock.Unlock();
+		}
+	}
+
+	// Jobs missing from the queue are solved, or in a group another owner is solving while holding our lock
+	FScopeLock Lock(&Owner.SolveLock);
+}
+
+int32 FCCDIKOpportunisticBatcher::TakeGroup(const FCCDIKBatchOwner& Owner, FCCDIKBatchJob** OutGroup, FCCDIKBatchOwner** OutLockedOwners, int32& OutNumLockedOwners)
+{
+	using namespace CCDIKSolverCore;
+
+	OutNumLockedOwners = 0;
+
+	FScopeLock Lock(&QueueLock);
+	const int32 LeaderIndex = Queue.IndexOfByPredicate([&Owner](const FCCDIKBatchJob* Job) { return Job->Owner == &Owner; });
+	if (LeaderIndex == INDEX_NONE)
+	{
+		return 0;
+	}
+
+	// Nothing below blocks while the queue is locked: other owners are only try-locked, and an owner waiting on its
+	// own lock in Solve holds nothing else.
+	const FCCDIKBatchJob* Leader = Queue[LeaderIndex];
+	OutGroup[0] = Queue[LeaderIndex];
+	int32 NumInGroup = 1;
+	const int32 SearchEnd = FMath::Min(Queue.Num(), LeaderIndex + CCDIKOpportunisticBatcher::MaxGroupSearch);
+	for (int32 QueueIndex = LeaderIndex + 1; QueueIndex < SearchEnd && NumInGroup < GroupWidth; QueueIndex++)
+	{
+		FCCDIKBatchJob* Job = Queue[QueueIndex];
+		if (Job->Chain.NumLinks != Leader->Chain.NumLinks || Job->Settings.bStartFromTail != Leader->Settings.bStartFromTail)
+		{
+			continue;
+		}
+
+		if (Job->Owner != &Owner)
+		{
+			bool bLocked = false;
+			for (int32 OwnerIndex = 0; OwnerIndex < OutNumLockedOwners && !bLocked; OwnerIndex++)
+			{
+				bLocked = OutLockedOwners[OwnerIndex] == Job->Owner;
+			}
+
+			// Another group holds some of its owner's jobs, or the owner is waiting for them. The owner solves this one itself.
+			if (!bLocked && !Job->Owner->SolveLock.TryLock())
+			{
+				continue;
+			}
+			if (!bLocked)
+			{
+				OutLockedOwners[OutNumLockedOwners++] = Job->Owner;
+			}
+			INC_DWORD_STAT(STAT_CCDIK_BatchJobsShared);
+		}
+		OutGroup[NumInGroup++] = Job;
+	}
+
+	// Queue order is kept, the oldest job of each owner leads its next group
+	for (int32 Lane = 0; Lane < NumInGroup; Lane++)
+	{
+		Queue.RemoveSingle(OutGroup[Lane]);
+	}
+	return NumInGroup;
+}
+
+void FCCDIKOpportunisticBatcher::SolveGroup(FCCDIKBatchJob* const* Group, int32 NumInGroup)
+{
+	using namespace CCDIKSolverCore;
+
+	SCOPE_CYCLE_COUNTER(STAT_CCDIK_BatchGroupSolve);
+
+	FChainView Chains[GroupWidth];
+	float Targets[GroupWidth][3];
+	FSolveSettings Settings[GroupWidth];
+	FSolveResult Results[GroupWidth];
+	for (int32 Lane = 0; Lane < NumInGroup; Lane++)
+	{
+		Chains[Lane] = Group[Lane]->Chain;
+		Targets[Lane][0] = Group[Lane]->Target[0];
+		Targets[Lane][1] = Group[Lane]->Target[1];
+		Targets[Lane][2] = Group[Lane]->Target[2];
+		Settings[Lane] = Group[Lane]->Settings;
+	}
+
+	TArray<float, TInlineAllocator<GetGroupScratchSize(CCDIKOpportunisticBatcher::InlineScratchLinks)>> Scratch;
+	Scratch.SetNumUninitialized(GetGroupScratchSize(Chains[0].NumLinks));
+
+	SolveChainGroup(Chains, Targets, Settings, Results, NumInGroup, Scratch.GetData());
+
+	for (int32 Lane = 0; Lane < NumInGroup; Lane++)
+	{
+		Group[Lane]->Result = Results[Lane];
+	}
+}
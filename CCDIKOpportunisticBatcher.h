@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "BoneControllers/CCDIKSolverCore.h"
+
+/**
+*	Per node state of FCCDIKOpportunisticBatcher. Nodes are copied around as plain data, copies start out idle.
+*/
+struct ANIMGRAPHRUNTIME_API FCCDIKBatchOwner
+{
+	FCCDIKBatchOwner() {}
+	FCCDIKBatchOwner(const FCCDIKBatchOwner&) {}
+	FCCDIKBatchOwner& operator=(const FCCDIKBatchOwner&) { return *this; }
+
+private:
+	friend class FCCDIKOpportunisticBatcher;
+
+	/** Held by another owner's thread while it solves a group holding some of this owner's jobs */
+	FCriticalSection SolveLock;
+};
+
+/** One chain solve handed to FCCDIKOpportunisticBatcher. Memory is owned by the submitting node and must stay valid until Solve returns. */
+struct ANIMGRAPHRUNTIME_API FCCDIKBatchJob
+{
+	/** Chain data, solved in place */
+	CCDIKSolverCore::FChainView Chain;
+
+	float Target[3];
+
+	CCDIKSolverCore::FSolveSettings Settings;
+
+	/** Written when the job is solved */
+	CCDIKSolverCore::FSolveResult Result;
+
+	/** Node the job belongs to, set by Solve */
+	FCCDIKBatchOwner* Owner = nullptr;
+};
+
+/**
+*	Opportunistic lane sharing between FAnimNode_CCDIK nodes in batch mode. There is no frame-wide gather phase: each
+*	node solves its own jobs as soon as it reaches them, on its own thread, several chains per SIMD lane group (see
+*	CCDIKSolverCore::SolveChainGroup). Jobs stay visible in a shared queue while they wait, so a node fills the free
+*	lanes of its groups with compatible jobs of other nodes evaluated at the same time. Chains of different characters
+*	only end up in one group when their evaluations overlap.
+*
+*	No node waits for another one to pick up its jobs. A node only blocks while another thread finishes a group it
+*	already took some of its jobs into.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKOpportunisticBatcher
+{
+public:
+	static FCCDIKOpportunisticBatcher& Get();
+
+	/** Solve every job, sharing lanes with whatever other owners have queued. Returns once every Result is written. */
+	void Solve(FCCDIKBatchOwner& Owner, FCCDIKBatchJob* Jobs, int32 NumJobs);
+
+private:
+	/**
+	*	Remove the oldest queued job of Owner and the compatible jobs that can share its lanes. Other owners' jobs are only
+	*	taken when their SolveLock could be locked without waiting, those owners are returned locked in OutLockedOwners.
+	*	Returns the number of jobs in OutGroup, 0 once none of Owner's jobs are queued.
+	*/
+	int32 TakeGroup(const FCCDIKBatchOwner& Owner, FCCDIKBatchJob** OutGroup, FCCDIKBatchOwner** OutLockedOwners, int32& OutNumLockedOwners);
+
+	static void SolveGroup(FCCDIKBatchJob* const* Group, int32 NumInGroup);
+
+	/** Jobs not picked up yet, oldest first */
+	TArray<FCCDIKBatchJob*> Queue;
+	FCriticalSection QueueLock;
+};
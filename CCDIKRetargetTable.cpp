@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKRetargetTable.h"
+#include "BoneControllers/CCDIKChainSet.h"
+#include "AnimationRuntime.h"
+#include "Engine/SkeletalMesh.h"
+#include "EngineLogs.h"
+
+namespace CCDIKRetargetTable
+{
+	/** Reference pose length of a chain root to tip and component space location of its root. False if a bone is missing. */
+	static bool GetRestChain(const USkeletalMesh* Mesh, const FCCDIKChainDescriptor& Chain, float& OutLength, FVector& OutRootLocation)
+	{
+		if (!Mesh)
+		{
+			return false;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Mesh->RefSkeleton;
+		const int32 RootIndex = RefSkeleton.FindBoneIndex(Chain.RootBone);
+		const int32 TipIndex = RefSkeleton.FindBoneIndex(Chain.TipBone);
+		if (RootIndex == INDEX_NONE || TipIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutLength = 0.f;
+		for (int32 BoneIndex = TipIndex; BoneIndex != RootIndex; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			if (BoneIndex == INDEX_NONE)
+			{
+				// Tip bone is not a child of the root bone
+				return false;
+			}
+			OutLength += RefSkeleton.GetRefBonePose()[BoneIndex].GetTranslation().Size();
+		}
+
+		OutRootLocation = FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, RootIndex).GetLocation();
+		return true;
+	}
+}
+
+void UCCDIKRetargetTable::Build()
+{
+	LengthScales.Reset();
+	RestOffsets.Reset();
+	if (!ChainSet)
+	{
+		return;
+	}
+
+	LengthScales.Reserve(ChainSet->Chains.Num());
+	RestOffsets.Reserve(ChainSet->Chains.Num());
+	for (const FCCDIKChainDescriptor& Chain : ChainSet->Chains)
+	{
+		// Chains missing on either rig keep their effectors as authored
+		float SourceLength = 0.f;
+		float TargetLength = 0.f;
+		FVector SourceRoot;
+		FVector TargetRoot;
+		if (!CCDIKRetargetTable::GetRestChain(SourceMesh, Chain, SourceLength, SourceRoot)
+			|| !CCDIKRetargetTable::GetRestChain(TargetMesh, Chain, TargetLength, TargetRoot)
+			|| SourceLength < KINDA_SMALL_NUMBER)
+		{
+			LengthScales.Add(1.f);
+			RestOffsets.Add(FVector::ZeroVector);
+			continue;
+		}
+
+		// Effector = TargetRoot + Scale * (SourceEffector - SourceRoot), folded into one multiply-add
+		const float Scale = TargetLength / SourceLength;
+		LengthScales.Add(Scale);
+		RestOffsets.Add(TargetRoot - SourceRoot * Scale);
+	}
+}
+
+bool UCCDIKRetargetTable::IsBuiltFor(const USkeletalMesh* Mesh, const UCCDIKChainSet* InChainSet) const
+{
+	return Mesh == TargetMesh && InChainSet == ChainSet && ChainSet
+		&& LengthScales.Num() == ChainSet->Chains.Num() && RestOffsets.Num() == ChainSet->Chains.Num();
+}
+
+void UCCDIKRetargetTable::Apply(FCCDIKResolvedChainSet& InOutResolved) const
+{
+	for (int32 ChainIndex = 0; ChainIndex < InOutResolved.Num(); ChainIndex++)
+	{
+		const int32 DescriptorIndex = InOutResolved.DescriptorIndices[ChainIndex];
+		InOutResolved.RetargetScales[ChainIndex] = LengthScales[DescriptorIndex];
+		InOutResolved.RetargetOffsets[ChainIndex] = RestOffsets[DescriptorIndex];
+	}
+}
+
+void UCCDIKRetargetTable::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// Cooked data is whatever was saved, rebuild in case a mesh changed since the last edit
+	Build();
+}
+
+#if WITH_EDITOR
+void UCCDIKRetargetTable::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Build();
+}
+#endif // WITH_EDITOR
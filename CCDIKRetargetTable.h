@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CCDIKRetargetTable.generated.h"
+
+class USkeletalMesh;
+class UCCDIKChainSet;
+struct FCCDIKResolvedChainSet;
+
+/**
+*	Effector retargeting of one chain set from the rig effectors were authored on to the rig solving them.
+*
+*	Limb lengths and rest pose chain roots of both rigs are compared once, when the asset is edited or saved, and
+*	stored as one scale and offset per chain. Cooked builds load the flat arrays as they are, so at runtime a
+*	retargeted effector is a multiply-add per chain, with no bone names or hierarchy walks involved.
+*/
+UCLASS(BlueprintType)
+class ANIMGRAPHRUNTIME_API UCCDIKRetargetTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Rig the effector locations were authored for */
+	UPROPERTY(EditAnywhere, Category = Retarget)
+	USkeletalMesh* SourceMesh;
+
+	/** Rig solving the chains */
+	UPROPERTY(EditAnywhere, Category = Retarget)
+	USkeletalMesh* TargetMesh;
+
+	/** Chains retargeted, bone names must exist on both rigs */
+	UPROPERTY(EditAnywhere, Category = Retarget)
+	UCCDIKChainSet* ChainSet;
+
+	/** Target over source length of each chain descriptor, root to tip in the reference pose. 1 when a rig misses the chain. */
+	UPROPERTY(VisibleAnywhere, Category = Table)
+	TArray<float> LengthScales;
+
+	/** Component space offset of each chain descriptor, added after scaling, so the source rest root lands on the target rest root */
+	UPROPERTY(VisibleAnywhere, Category = Table)
+	TArray<FVector> RestOffsets;
+
+	/** Recompute LengthScales and RestOffsets from the meshes and chain set */
+	void Build();
+
+	/** Whether the table was built for this rig and chain set */
+	bool IsBuiltFor(const USkeletalMesh* Mesh, const UCCDIKChainSet* InChainSet) const;
+
+	/** Fill the per chain retarget scales and offsets of chains resolved against TargetMesh. Game thread. */
+	void Apply(FCCDIKResolvedChainSet& InOutResolved) const;
+
+	// UObject interface
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif // WITH_EDITOR
+	// End of UObject interface
+};
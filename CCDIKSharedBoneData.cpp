@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKSharedBoneData.h"
+#include "BoneControllers/CCDIKRetargetTable.h"
+#include "Engine/SkeletalMesh.h"
+#include "Misc/ScopeLock.h"
+#include "EngineLogs.h"
+
+namespace CCDIKSharedBoneData
+{
+	typedef TTuple<FObjectKey, FObjectKey, FObjectKey> FRegistryKey;
+
+	/** Live shared data. Entries expire with the last node holding them and are purged when new data is registered. */
+	static TMap<FRegistryKey, TWeakPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe>> Registry;
+	static FCriticalSection RegistryLock;
+
+	/** Data built so far, under RegistryLock */
+	static uint32 NumCreated = 0;
+}
+
+TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> FCCDIKSharedBoneData::FindOrCreate(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable)
+{
+	using namespace CCDIKSharedBoneData;
+
+	const FRegistryKey Key(FObjectKey(Mesh), FObjectKey(ChainSet), FObjectKey(RetargetTable));
+
+	FScopeLock Lock(&RegistryLock);
+	if (const TWeakPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe>* Existing = Registry.Find(Key))
+	{
+		TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> Pinned = Existing->Pin();
+		if (Pinned.IsValid())
+		{
+			return Pinned;
+		}
+	}
+
+	for (auto It = Registry.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> Created = MakeShared<FCCDIKSharedBoneData, ESPMode::ThreadSafe>(Mesh, ChainSet, RetargetTable);
+	Registry.Add(Key, Created);
+	return Created;
+}
+
+FCCDIKSharedBoneData::FCCDIKSharedBoneData(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable)
+	: MeshKey(Mesh)
+	, ChainSetKey(ChainSet)
+	, RetargetTableKey(RetargetTable)
+{
+	SolveCacheId = ++CCDIKSharedBoneData::NumCreated;
+
+	if (!ChainSet)
+	{
+		UCCDIKChainSet::ResolveDefaultChains(Mesh, ResolvedChains);
+		if (RetargetTable)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("CCDIK retarget table %s needs a chain set, effectors of the default chains on %s are not retargeted."),
+				*RetargetTable->GetName(), *GetNameSafe(Mesh));
+		}
+	}
+	else
+	{
+		ChainSet->Resolve(Mesh, ResolvedChains);
+
+		// Table lookups happen here once, nodes only read the per chain scales and offsets
+		if (RetargetTable && RetargetTable->IsBuiltFor(Mesh, ChainSet))
+		{
+			RetargetTable->Apply(ResolvedChains);
+		}
+		else if (RetargetTable)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("CCDIK retarget table %s was not built for %s and %s, effectors are not retargeted."),
+				*RetargetTable->GetName(), *GetNameSafe(Mesh), *ChainSet->GetName());
+		}
+	}
+}
+
+bool FCCDIKSharedBoneData::Matches(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable) const
+{
+	return MeshKey == FObjectKey(Mesh) && ChainSetKey == FObjectKey(ChainSet) && RetargetTableKey == FObjectKey(RetargetTable);
+}
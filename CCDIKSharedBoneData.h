@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "BoneControllers/CCDIKChainSet.h"
+
+class USkeletalMesh;
+class UCCDIKRetargetTable;
+
+/**
+*	Bone resolution shared by every FAnimNode_CCDIK using the same skeletal mesh, chain set and retarget table.
+*
+*	Built once on the game thread by the first node that needs it and reference counted by the nodes holding it, so
+*	spawning more characters of the same kind costs a map lookup. Nothing changes after construction, so any thread
+*	may read it.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKSharedBoneData
+{
+public:
+	/** Existing data for this combination, or newly built data. Game thread. */
+	static TSharedPtr<const FCCDIKSharedBoneData, ESPMode::ThreadSafe> FindOrCreate(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable);
+
+	/** Whether this data was built for these assets */
+	bool Matches(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable) const;
+
+	/** Chain set resolved against the mesh, with the retarget table's scales and offsets. UCCDIKChainSet::GetDefaultChains without a chain set. */
+	FCCDIKResolvedChainSet ResolvedChains;
+
+	/** Unique among all data ever built, keys FCCDIKSolveCache entries so they never match chains of other assets */
+	uint32 SolveCacheId = 0;
+
+	FCCDIKSharedBoneData(const USkeletalMesh* Mesh, const UCCDIKChainSet* ChainSet, const UCCDIKRetargetTable* RetargetTable);
+
+private:
+	FObjectKey MeshKey;
+	FObjectKey ChainSetKey;
+	FObjectKey RetargetTableKey;
+};
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKSolveCache.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "EngineLogs.h"
+
+namespace CCDIKSolveCache
+{
+	static int32 MaxEntries = 4096;
+	static FAutoConsoleVariableRef CVarMaxEntries(
+		TEXT("a.CCDIK.SolveCache.MaxEntries"),
+		MaxEntries,
+		TEXT("Most chain solutions kept by the shared CCDIK solve cache, least recently used ones are dropped first. 0 stops storing new ones."));
+
+	static const int32 FloatsPerLink = 7;
+
+	/** Root link of a chain as a rotation and translation. Scale is already in the component space link positions. */
+	static FTransform GetRootTransform(const CCDIKSolverCore::FChainView& Chain)
+	{
+		return FTransform(FQuat(Chain.RotX[0], Chain.RotY[0], Chain.RotZ[0], Chain.RotW[0]), FVector(Chain.PosX[0], Chain.PosY[0], Chain.PosZ[0]));
+	}
+}
+
+FCCDIKSolveCache& FCCDIKSolveCache::Get()
+{
+	static FCCDIKSolveCache Instance;
+	return Instance;
+}
+
+bool FCCDIKSolveCache::Find(uint64 Key, uint32 SolveCacheId, const CCDIKSolverCore::FChainView& Chain, bool& bOutUpdated)
+{
+	using namespace CCDIKSolveCache;
+
+	FScopeLock ScopeLock(&Lock);
+	const int32* EntryIndex = EntryIndices.Find(Key);
+	if (!EntryIndex || Entries[*EntryIndex].SolveCacheId != SolveCacheId || Entries[*EntryIndex].NumLinks != Chain.NumLinks)
+	{
+		Misses++;
+		return false;
+	}
+
+	Hits++;
+	Unlink(*EntryIndex);
+	LinkAsNewest(*EntryIndex);
+
+	const FEntry& Entry = Entries[*EntryIndex];
+	const FTransform RootTransform = GetRootTransform(Chain);
+	const float* Link = Entry.Links.GetData();
+	for (int32 LinkIndex = 1; LinkIndex < Chain.NumLinks; LinkIndex++, Link += FloatsPerLink)
+	{
+		const FVector Location = RootTransform.TransformPositionNoScale(FVector(Link[0], Link[1], Link[2]));
+		const FQuat Rotation = RootTransform.GetRotation() * FQuat(Link[3], Link[4], Link[5], Link[6]);
+		Chain.PosX[LinkIndex] = Location.X;
+		Chain.PosY[LinkIndex] = Location.Y;
+		Chain.PosZ[LinkIndex] = Location.Z;
+		Chain.RotX[LinkIndex] = Rotation.X;
+		Chain.RotY[LinkIndex] = Rotation.Y;
+		Chain.RotZ[LinkIndex] = Rotation.Z;
+		Chain.RotW[LinkIndex] = Rotation.W;
+	}
+
+	bOutUpdated = Entry.bUpdated;
+	return true;
+}
+
+void FCCDIKSolveCache::Add(uint64 Key, uint32 SolveCacheId, const CCDIKSolverCore::FChainView& Chain, bool bUpdated)
+{
+	using namespace CCDIKSolveCache;
+
+	if (Chain.NumLinks < 2)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	int32 EntryIndex = INDEX_NONE;
+	if (const int32* ExistingIndex = EntryIndices.Find(Key))
+	{
+		// Another character solved the same input meanwhile, refresh it
+		EntryIndex = *ExistingIndex;
+		Unlink(EntryIndex);
+	}
+	else
+	{
+		if (MaxEntries <= 0)
+		{
+			return;
+		}
+
+		// Evict down to the cap, which may have been lowered since the last add
+		while (EntryIndices.Num() >= MaxEntries && Oldest != INDEX_NONE)
+		{
+			const int32 Evicted = Oldest;
+			Unlink(Evicted);
+			EntryIndices.Remove(Entries[Evicted].Key);
+			FreeEntries.Add(Evicted);
+			Evictions++;
+		}
+
+		EntryIndex = FreeEntries.Num() > 0 ? FreeEntries.Pop(false) : Entries.AddDefaulted();
+		EntryIndices.Add(Key, EntryIndex);
+	}
+
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Key = Key;
+	Entry.SolveCacheId = SolveCacheId;
+	Entry.NumLinks = Chain.NumLinks;
+	Entry.bUpdated = bUpdated;
+	Entry.Links.SetNumUninitialized((Chain.NumLinks - 1) * FloatsPerLink, false);
+
+	const FTransform RootTransform = GetRootTransform(Chain);
+	const FQuat InvRootRotation = RootTransform.GetRotation().Inverse();
+	float* Link = Entry.Links.GetData();
+	for (int32 LinkIndex = 1; LinkIndex < Chain.NumLinks; LinkIndex++, Link += FloatsPerLink)
+	{
+		const FVector Location = RootTransform.InverseTransformPositionNoScale(FVector(Chain.PosX[LinkIndex], Chain.PosY[LinkIndex], Chain.PosZ[LinkIndex]));
+		const FQuat Rotation = InvRootRotation * FQuat(Chain.RotX[LinkIndex], Chain.RotY[LinkIndex], Chain.RotZ[LinkIndex], Chain.RotW[LinkIndex]);
+		Link[0] = Location.X;
+		Link[1] = Location.Y;
+		Link[2] = Location.Z;
+		Link[3] = Rotation.X;
+		Link[4] = Rotation.Y;
+		Link[5] = Rotation.Z;
+		Link[6] = Rotation.W;
+	}
+
+	LinkAsNewest(EntryIndex);
+}
+
+void FCCDIKSolveCache::Flush()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Reset();
+	EntryIndices.Reset();
+	FreeEntries.Reset();
+	Newest = INDEX_NONE;
+	Oldest = INDEX_NONE;
+	Hits = 0;
+	Misses = 0;
+	Evictions = 0;
+}
+
+FCCDIKSolveCache::FStats FCCDIKSolveCache::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+	FStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Evictions = Evictions;
+	Stats.Entries = EntryIndices.Num();
+	Stats.MaxEntries = CCDIKSolveCache::MaxEntries;
+	return Stats;
+}
+
+void FCCDIKSolveCache::Unlink(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.Newer != INDEX_NONE)
+	{
+		Entries[Entry.Newer].Older = Entry.Older;
+	}
+	else if (Newest == EntryIndex)
+	{
+		Newest = Entry.Older;
+	}
+
+	if (Entry.Older != INDEX_NONE)
+	{
+		Entries[Entry.Older].Newer = Entry.Newer;
+	}
+	else if (Oldest == EntryIndex)
+	{
+		Oldest = Entry.Newer;
+	}
+
+	Entry.Newer = INDEX_NONE;
+	Entry.Older = INDEX_NONE;
+}
+
+void FCCDIKSolveCache::LinkAsNewest(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Newer = INDEX_NONE;
+	Entry.Older = Newest;
+	if (Newest != INDEX_NONE)
+	{
+		Entries[Newest].Newer = EntryIndex;
+	}
+	Newest = EntryIndex;
+	if (Oldest == INDEX_NONE)
+	{
+		Oldest = EntryIndex;
+	}
+}
+
+/////////////////////////////////////////////////////
+// Console commands
+
+static FAutoConsoleCommand CCDIKSolveCacheStatsCommand(
+	TEXT("a.CCDIK.SolveCache.Stats"),
+	TEXT("Log hits, misses, hit rate and size of the shared CCDIK solve cache."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FCCDIKSolveCache::FStats Stats = FCCDIKSolveCache::Get().GetStats();
+		UE_LOG(LogAnimation, Display, TEXT("CCDIK solve cache: %lld hits, %lld misses, %.1f%% hit rate, %d/%d entries, %lld evicted"),
+			Stats.Hits, Stats.Misses, Stats.GetHitRate() * 100.f, Stats.Entries, Stats.MaxEntries, Stats.Evictions);
+	}));
+
+static FAutoConsoleCommand CCDIKSolveCacheFlushCommand(
+	TEXT("a.CCDIK.SolveCache.Flush"),
+	TEXT("Drop every entry of the shared CCDIK solve cache and reset its counters."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FCCDIKSolveCache::Get().Flush();
+	}));
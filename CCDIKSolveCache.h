@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoneControllers/CCDIKSolverCore.h"
+
+/**
+*	Chain solutions shared by every FAnimNode_CCDIK that opts in, so a crowd playing the same animations towards the same
+*	effectors solves each distinct chain input once instead of once per character.
+*
+*	Callers key entries on everything the solve depends on, quantized: the chain, its settings, its input pose relative to
+*	its root link and the effector relative to the root link. Solutions are stored relative to the root link as well, so a
+*	character anywhere in the world reuses them. Least recently used entries are dropped beyond a.CCDIK.SolveCache.MaxEntries.
+*	Safe to call from any thread.
+*/
+class ANIMGRAPHRUNTIME_API FCCDIKSolveCache
+{
+public:
+	static FCCDIKSolveCache& Get();
+
+	/**
+	*	Overwrite every link of Chain after its root link with the solution stored under Key, placed on Chain's root link.
+	*	Returns false and leaves Chain untouched when there is none, or when the entry was stored for other assets
+	*	(FCCDIKSharedBoneData::SolveCacheId) or another chain length, which only a key collision can cause.
+	*/
+	bool Find(uint64 Key, uint32 SolveCacheId, const CCDIKSolverCore::FChainView& Chain, bool& bOutUpdated);
+
+	/** Store solved Chain under Key, making it the most recently used entry */
+	void Add(uint64 Key, uint32 SolveCacheId, const CCDIKSolverCore::FChainView& Chain, bool bUpdated);
+
+	/** Drop every entry and reset the counters */
+	void Flush();
+
+	struct FStats
+	{
+		int64 Hits = 0;
+		int64 Misses = 0;
+
+		/** Entries dropped to stay within MaxEntries */
+		int64 Evictions = 0;
+
+		int32 Entries = 0;
+		int32 MaxEntries = 0;
+
+		float GetHitRate() const { return Hits + Misses > 0 ? float(double(Hits) / double(Hits + Misses)) : 0.f; }
+	};
+
+	/** Counters since the last Flush */
+	FStats GetStats() const;
+
+private:
+	struct FEntry
+	{
+		uint64 Key = 0;
+
+		/** What the entry was solved for, checked on every hit since keys are hashes */
+		uint32 SolveCacheId = 0;
+		int32 NumLinks = 0;
+
+		/** Neighbours in recency order, INDEX_NONE past either end */
+		int32 Newer = INDEX_NONE;
+		int32 Older = INDEX_NONE;
+
+		bool bUpdated = false;
+
+		/** Per link after the root link: position then rotation relative to the root link, 7 floats. Kept when the entry is reused. */
+		TArray<float> Links;
+	};
+
+	void Unlink(int32 EntryIndex);
+	void LinkAsNewest(int32 EntryIndex);
+
+	TArray<FEntry> Entries;
+	TMap<uint64, int32> EntryIndices;
+
+	/** Evicted entries waiting for reuse */
+	TArray<int32> FreeEntries;
+
+	int32 Newest = INDEX_NONE;
+	int32 Oldest = INDEX_NONE;
+
+	int64 Hits = 0;
+	int64 Misses = 0;
+	int64 Evictions = 0;
+
+	mutable FCriticalSection Lock;
+};
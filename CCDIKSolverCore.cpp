@@ -0,0 +1,1124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BoneControllers/CCDIKSolverCore.h"
+
+#include <cmath>
+
+#if CCDIK_WITH_SSE
+	#include <immintrin.h>
+#endif
+
+// Deterministic solves need the same rounding from every compiler, so no multiply-add is fused into one instruction in here
+#if defined(_MSC_VER) && !defined(__clang__)
+	#pragma fp_contract(off)
+#elif defined(__clang__)
+	#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace CCDIKSolverCore
+{
+	namespace
+	{
+		/** Same thresholds as KINDA_SMALL_NUMBER and SMALL_NUMBER */
+		constexpr float KindaSmallNumber = 1.e-4f;
+		constexpr float SmallNumber = 1.e-8f;
+
+		/**
+		*	Lane abstraction so the rotate/normalize loop is written once for every vector width.
+		*	FScalarLanes is the reference, the wide variants must produce the same values per lane.
+		*/
+		struct FScalarLanes
+		{
+			typedef float Type;
+			static constexpr int32_t Width = 1;
+
+			static Type Load(const float* Ptr) { return *Ptr; }
+			static void Store(float* Ptr, Type Value) { *Ptr = Value; }
+			static Type Set(float Value) { return Value; }
+			static Type Add(Type A, Type B) { return A + B; }
+			static Type Sub(Type A, Type B) { return A - B; }
+			static Type Mul(Type A, Type B) { return A * B; }
+			static Type Div(Type A, Type B) { return A / B; }
+			static Type Sqrt(Type A) { return std::sqrt(A); }
+			/** A >= B ? IfTrue : IfFalse */
+			static Type SelectGE(Type A, Type B, Type IfTrue, Type IfFalse) { return A >= B ? IfTrue : IfFalse; }
+		};
+
+#if CCDIK_WITH_SSE
+		struct FSSELanes
+		{
+			typedef __m128 Type;
+			static constexpr int32_t Width = 4;
+
+			static Type Load(const float* Ptr) { return _mm_loadu_ps(Ptr); }
+			static void Store(float* Ptr, Type Value) { _mm_storeu_ps(Ptr, Value); }
+			static Type Set(float Value) { return _mm_set1_ps(Value); }
+			static Type Add(Type A, Type B) { return _mm_add_ps(A, B); }
+			static Type Sub(Type A, Type B) { return _mm_sub_ps(A, B); }
+			static Type Mul(Type A, Type B) { return _mm_mul_ps(A, B); }
+			static Type Div(Type A, Type B) { return _mm_div_ps(A, B); }
+			static Type Sqrt(Type A) { return _mm_sqrt_ps(A); }
+			static Type SelectGE(Type A, Type B, Type IfTrue, Type IfFalse)
+			{
+				const Type Mask = _mm_cmpge_ps(A, B);
+				return _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+			}
+		};
+#endif
+
+#if CCDIK_WITH_AVX2
+		struct FAVX2Lanes
+		{
+			typedef __m256 Type;
+			static constexpr int32_t Width = 8;
+
+			static Type Load(const float* Ptr) { return _mm256_loadu_ps(Ptr); }
+			static void Store(float* Ptr, Type Value) { _mm256_storeu_ps(Ptr, Value); }
+			static Type Set(float Value) { return _mm256_set1_ps(Value); }
+			static Type Add(Type A, Type B) { return _mm256_add_ps(A, B); }
+			static Type Sub(Type A, Type B) { return _mm256_sub_ps(A, B); }
+			static Type Mul(Type A, Type B) { return _mm256_mul_ps(A, B); }
+			static Type Div(Type A, Type B) { return _mm256_div_ps(A, B); }
+			static Type Sqrt(Type A) { return _mm256_sqrt_ps(A); }
+			static Type SelectGE(Type A, Type B, Type IfTrue, Type IfFalse) { return _mm256_blendv_ps(IfFalse, IfTrue, _mm256_cmp_ps(A, B, _CMP_GE_OQ)); }
+		};
+#endif
+
+		/** Rigid rotation of chain data around a pivot, LaneType::Width values at a time */
+		template<typename LaneType>
+		struct TRigidRotation
+		{
+			typedef typename LaneType::Type T;
+
+			T PX, PY, PZ;
+			T DX, DY, DZ, DW;
+
+			/** Same pivot and delta in every lane */
+			TRigidRotation(const float Pivot[3], const float Delta[4])
+				: PX(LaneType::Set(Pivot[0])), PY(LaneType::Set(Pivot[1])), PZ(LaneType::Set(Pivot[2]))
+				, DX(LaneType::Set(Delta[0])), DY(LaneType::Set(Delta[1])), DZ(LaneType::Set(Delta[2])), DW(LaneType::Set(Delta[3]))
+			{
+			}
+
+			/** One pivot and delta per lane, read from Width wide arrays */
+			TRigidRotation(const float* PivotX, const float* PivotY, const float* PivotZ, const float* DeltaX, const float* DeltaY, const float* DeltaZ, const float* DeltaW)
+				: PX(LaneType::Load(PivotX)), PY(LaneType::Load(PivotY)), PZ(LaneType::Load(PivotZ))
+				, DX(LaneType::Load(DeltaX)), DY(LaneType::Load(DeltaY)), DZ(LaneType::Load(DeltaZ)), DW(LaneType::Load(DeltaW))
+			{
+			}
+
+			/** Rotate the Width values starting at Index. Lanes where Mask is below 0.5 keep their old values when bMasked. */
+			template<bool bMasked>
+			void Apply(const FChainView& Data, int32_t Index, T Mask) const
+			{
+				const T Two = LaneType::Set(2.f);
+				const T One = LaneType::Set(1.f);
+				const T Zero = LaneType::Set(0.f);
+				const T Half = LaneType::Set(0.5f);
+				const T Tolerance = LaneType::Set(SmallNumber);
+
+				// Position: v' = v + w * t + cross(q, t), with t = 2 * cross(q, v) and v the offset from the pivot
+				const T OldPX = LaneType::Load(Data.PosX + Index);
+				const T OldPY = LaneType::Load(Data.PosY + Index);
+				const T OldPZ = LaneType::Load(Data.PosZ + Index);
+				const T VX = LaneType::Sub(OldPX, PX);
+				const T VY = LaneType::Sub(OldPY, PY);
+				const T VZ = LaneType::Sub(OldPZ, PZ);
+
+				const T TX = LaneType::Mul(Two, LaneType::Sub(LaneType::Mul(DY, VZ), LaneType::Mul(DZ, VY)));
+				const T TY = LaneType::Mul(Two, LaneType::Sub(LaneType::Mul(DZ, VX), LaneType::Mul(DX, VZ)));
+				const T TZ = LaneType::Mul(Two, LaneType::Sub(LaneType::Mul(DX, VY), LaneType::Mul(DY, VX)));
+
+				T NewPX = LaneType::Add(PX, LaneType::Add(LaneType::Add(VX, LaneType::Mul(DW, TX)), LaneType::Sub(LaneType::Mul(DY, TZ), LaneType::Mul(DZ, TY))));
+				T NewPY = LaneType::Add(PY, LaneType::Add(LaneType::Add(VY, LaneType::Mul(DW, TY)), LaneType::Sub(LaneType::Mul(DZ, TX), LaneType::Mul(DX, TZ))));
+				T NewPZ = LaneType::Add(PZ, LaneType::Add(LaneType::Add(VZ, LaneType::Mul(DW, TZ)), LaneType::Sub(LaneType::Mul(DX, TY), LaneType::Mul(DY, TX))));
+
+				// Rotation: Delta * Rot
+				const T BX = LaneType::Load(Data.RotX + Index);
+				const T BY = LaneType::Load(Data.RotY + Index);
+				const T BZ = LaneType::Load(Data.RotZ + Index);
+				const T BW = LaneType::Load(Data.RotW + Index);
+
+				const T QX = LaneType::Sub(LaneType::Add(LaneType::Add(LaneType::Mul(DW, BX), LaneType::Mul(DX, BW)), LaneType::Mul(DY, BZ)), LaneType::Mul(DZ, BY));
+				const T QY = LaneType::Add(LaneType::Add(LaneType::Sub(LaneType::Mul(DW, BY), LaneType::Mul(DX, BZ)), LaneType::Mul(DY, BW)), LaneType::Mul(DZ, BX));
+				const T QZ = LaneType::Add(LaneType::Sub(LaneType::Add(LaneType::Mul(DW, BZ), LaneType::Mul(DX, BY)), LaneType::Mul(DY, BX)), LaneType::Mul(DZ, BW));
+				const T QW = LaneType::Sub(LaneType::Sub(LaneType::Sub(LaneType::Mul(DW, BW), LaneType::Mul(DX, BX)), LaneType::Mul(DY, BY)), LaneType::Mul(DZ, BZ));
+
+				// Normalize like FQuat::Normalize, degenerate quaternions become identity
+				const T SizeSquared = LaneType::Add(LaneType::Add(LaneType::Mul(QX, QX), LaneType::Mul(QY, QY)), LaneType::Add(LaneType::Mul(QZ, QZ), LaneType::Mul(QW, QW)));
+				const T InvSize = LaneType::Div(One, LaneType::Sqrt(LaneType::SelectGE(SizeSquared, Tolerance, SizeSquared, One)));
+
+				T NewRX = LaneType::SelectGE(SizeSquared, Tolerance, LaneType::Mul(QX, InvSize), Zero);
+				T NewRY = LaneType::SelectGE(SizeSquared, Tolerance, LaneType::Mul(QY, InvSize), Zero);
+				T NewRZ = LaneType::SelectGE(SizeSquared, Tolerance, LaneType::Mul(QZ, InvSize), Zero);
+				T NewRW = LaneType::SelectGE(SizeSquared, Tolerance, LaneType::Mul(QW, InvSize), One);
+
+				if (bMasked)
+				{
+					NewPX = LaneType::SelectGE(Mask, Half, NewPX, OldPX);
+					NewPY = LaneType::SelectGE(Mask, Half, NewPY, OldPY);
+					NewPZ = LaneType::SelectGE(Mask, Half, NewPZ, OldPZ);
+					NewRX = LaneType::SelectGE(Mask, Half, NewRX, BX);
+					NewRY = LaneType::SelectGE(Mask, Half, NewRY, BY);
+					NewRZ = LaneType::SelectGE(Mask, Half, NewRZ, BZ);
+					NewRW = LaneType::SelectGE(Mask, Half, NewRW, BW);
+				}
+
+				LaneType::Store(Data.PosX + Index, NewPX);
+				LaneType::Store(Data.PosY + Index, NewPY);
+				LaneType::Store(Data.PosZ + Index, NewPZ);
+				LaneType::Store(Data.RotX + Index, NewRX);
+				LaneType::Store(Data.RotY + Index, NewRY);
+				LaneType::Store(Data.RotZ + Index, NewRZ);
+				LaneType::Store(Data.RotW + Index, NewRW);
+			}
+		};
+
+		/** Rotate links [First, Last) rigidly around Pivot by Delta, LaneType::Width links at a time. Returns the first link not processed. */
+		template<typename LaneType>
+		int32_t RotateLinksLanes(const FChainView& Chain, int32_t First, int32_t Last, const float Pivot[3], const float Delta[4])
+		{
+			const TRigidRotation<LaneType> Rotation(Pivot, Delta);
+			const typename LaneType::Type NoMask = LaneType::Set(1.f);
+
+			int32_t Link = First;
+			for (; Link + LaneType::Width <= Last; Link += LaneType::Width)
+			{
+				Rotation.template Apply<false>(Chain, Link, NoMask);
+			}
+
+			return Link;
+		}
+
+		inline float Distance(const FChainView& Chain, int32_t Link, const float Target[3])
+		{
+			const float X = Target[0] - Chain.PosX[Link];
+			const float Y = Target[1] - Chain.PosY[Link];
+			const float Z = Target[2] - Chain.PosZ[Link];
+			return std::sqrt(X * X + Y * Y + Z * Z);
+		}
+
+		/** Same as FVector::Normalize, leaves the vector untouched when it is too small */
+		inline bool Normalize(float& X, float& Y, float& Z)
+		{
+			const float SizeSquared = X * X + Y * Y + Z * Z;
+			if (SizeSquared > SmallNumber)
+			{
+				const float InvSize = 1.f / std::sqrt(SizeSquared);
+				X *= InvSize;
+				Y *= InvSize;
+				Z *= InvSize;
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		*	Arc cosine of Dot clamped to [-1, 1]. The deterministic variant is a fixed polynomial (Abramowitz and Stegun 4.4.46)
+		*	built from multiplies, adds and a square root, which round the same everywhere unlike std::acos. Within 5e-7 of it.
+		*/
+		inline float ClampedAcos(float Dot, bool bDeterministic)
+		{
+			Dot = Dot < -1.f ? -1.f : (Dot > 1.f ? 1.f : Dot);
+			if (!bDeterministic)
+			{
+				return std::acos(Dot);
+			}
+
+			const float X = std::fabs(Dot);
+			float Poly = -0.0012624911f;
+			Poly = Poly * X + 0.0066700901f;
+			Poly = Poly * X - 0.0170881256f;
+			Poly = Poly * X + 0.0308918810f;
+			Poly = Poly * X - 0.0501743046f;
+			Poly = Poly * X + 0.0889789874f;
+			Poly = Poly * X - 0.2145988016f;
+			Poly = Poly * X + 1.5707963050f;
+			const float Angle = Poly * std::sqrt(1.f - X);
+			return Dot < 0.f ? 3.14159265f - Angle : Angle;
+		}
+
+		/** Sine and cosine of half of Angle, in [0, PI]. The deterministic variant uses Taylor polynomials, within 3e-7 over that range. */
+		inline void HalfAngleSinCos(float Angle, bool bDeterministic, float& OutSin, float& OutCos)
+		{
+			const float X = 0.5f * Angle;
+			if (!bDeterministic)
+			{
+				OutSin = std::sin(X);
+				OutCos = std::cos(X);
+				return;
+			}
+
+			const float X2 = X * X;
+			OutSin = X * (1.f + X2 * (-1.f / 6.f + X2 * (1.f / 120.f + X2 * (-1.f / 5040.f + X2 * (1.f / 362880.f + X2 * (-1.f / 39916800.f))))));
+			OutCos = 1.f + X2 * (-0.5f + X2 * (1.f / 24.f + X2 * (-1.f / 720.f + X2 * (1.f / 40320.f + X2 * (-1.f / 3628800.f + X2 * (1.f / 479001600.f))))));
+		}
+
+		/**
+		*	Delta rotation that turns a link at Pivot so the tip points at the target, the front half of UpdateChainLink
+		*	in AnimationCore::SolveCCDIK. Returns false when the link should not move.
+		*/
+		bool ComputeLinkDelta(const float Pivot[3], const float Tip[3], const float Target[3], float RotationLimit, float& AngleDelta, bool bEnableRotationLimit, bool bDeterministic, float OutDelta[4])
+		{
+			float ToEndX = Tip[0] - Pivot[0];
+			float ToEndY = Tip[1] - Pivot[1];
+			float ToEndZ = Tip[2] - Pivot[2];
+			float ToTargetX = Target[0] - Pivot[0];
+			float ToTargetY = Target[1] - Pivot[1];
+			float ToTargetZ = Target[2] - Pivot[2];
+			Normalize(ToEndX, ToEndY, ToEndZ);
+			Normalize(ToTargetX, ToTargetY, ToTargetZ);
+
+			const float Dot = ToEndX * ToTargetX + ToEndY * ToTargetY + ToEndZ * ToTargetZ;
+			float Angle = ClampedAcos(Dot, bDeterministic);
+			Angle = Angle < -RotationLimit ? -RotationLimit : (Angle > RotationLimit ? RotationLimit : Angle);
+
+			const bool bCanRotate = (std::fabs(Angle) > KindaSmallNumber) && (!bEnableRotationLimit || RotationLimit > AngleDelta);
+			if (!bCanRotate)
+			{
+				return false;
+			}
+
+			// check rotation limit first, if fails, just abort
+			if (bEnableRotationLimit)
+			{
+				if (RotationLimit < AngleDelta + Angle)
+				{
+					Angle = RotationLimit - AngleDelta;
+					if (Angle <= KindaSmallNumber)
+					{
+						return false;
+					}
+				}
+				AngleDelta += Angle;
+			}
+
+			float AxisX = ToEndY * ToTargetZ - ToEndZ * ToTargetY;
+			float AxisY = ToEndZ * ToTargetX - ToEndX * ToTargetZ;
+			float AxisZ = ToEndX * ToTargetY - ToEndY * ToTargetX;
+			if (AxisX * AxisX + AxisY * AxisY + AxisZ * AxisZ <= 0.f)
+			{
+				return false;
+			}
+			Normalize(AxisX, AxisY, AxisZ);
+
+			float HalfSin, HalfCos;
+			HalfAngleSinCos(Angle, bDeterministic, HalfSin, HalfCos);
+			OutDelta[0] = AxisX * HalfSin;
+			OutDelta[1] = AxisY * HalfSin;
+			OutDelta[2] = AxisZ * HalfSin;
+			OutDelta[3] = HalfCos;
+			return true;
+		}
+
+		inline float GetRotationLimit(const FChainView& Chain, int32_t LinkIndex)
+		{
+			return Chain.RotationLimits ? Chain.RotationLimits[LinkIndex] : 3.14159265f;
+		}
+
+		/** A * B, same convention as FQuat */
+		inline void QuatMultiply(const float A[4], const float B[4], float Out[4])
+		{
+			const float X = A[3] * B[0] + A[0] * B[3] + A[1] * B[2] - A[2] * B[1];
+			const float Y = A[3] * B[1] - A[0] * B[2] + A[1] * B[3] + A[2] * B[0];
+			const float Z = A[3] * B[2] + A[0] * B[1] - A[1] * B[0] + A[2] * B[3];
+			const float W = A[3] * B[3] - A[0] * B[0] - A[1] * B[1] - A[2] * B[2];
+			Out[0] = X;
+			Out[1] = Y;
+			Out[2] = Z;
+			Out[3] = W;
+		}
+
+		inline void QuatInverse(const float Q[4], float Out[4])
+		{
+			Out[0] = -Q[0];
+			Out[1] = -Q[1];
+			Out[2] = -Q[2];
+			Out[3] = Q[3];
+		}
+
+		/**
+		*	Delta rotation bringing a link back inside its swing cone and twist range, given its own and its parent's
+		*	component space rotations. Returns false when the link is already within its limit.
+		*/
+		bool ComputeJointLimitDelta(const float ParentRotation[4], const float Rotation[4], const FJointLimit& Limit, float OutDelta[4])
+		{
+			// Rotation away from the reference: Rel = inv(Ref) * inv(Parent) * Rotation
+			float Inverse[4];
+			float Local[4];
+			float Rel[4];
+			QuatInverse(ParentRotation, Inverse);
+			QuatMultiply(Inverse, Rotation, Local);
+			QuatInverse(Limit.RefRotation, Inverse);
+			QuatMultiply(Inverse, Local, Rel);
+			if (Rel[3] < 0.f)
+			{
+				Rel[0] = -Rel[0];
+				Rel[1] = -Rel[1];
+				Rel[2] = -Rel[2];
+				Rel[3] = -Rel[3];
+			}
+
+			// Swing-twist split: twist is Rel projected on the twist axis, swing is what is left
+			const float* Axis = Limit.TwistAxis;
+			const float Projection = Rel[0] * Axis[0] + Rel[1] * Axis[1] + Rel[2] * Axis[2];
+			const float TwistSize = std::sqrt(Projection * Projection + Rel[3] * Rel[3]);
+			float SinHalfTwist = TwistSize > SmallNumber ? Projection / TwistSize : 0.f;
+			float CosHalfTwist = TwistSize > SmallNumber ? Rel[3] / TwistSize : 1.f;
+
+			float Twist[4] = { Axis[0] * SinHalfTwist, Axis[1] * SinHalfTwist, Axis[2] * SinHalfTwist, CosHalfTwist };
+			float Swing[4];
+			QuatInverse(Twist, Inverse);
+			QuatMultiply(Rel, Inverse, Swing);
+
+			// Half angles stay within [0, 90] degrees for swing and [-90, 90] for twist, where comparing sines and cosines is comparing angles
+			const bool bClampSwing = Swing[3] < Limit.CosHalfSwingLimit;
+			const bool bClampTwist = SinHalfTwist < Limit.SinHalfMinTwist || SinHalfTwist > Limit.SinHalfMaxTwist;
+			if (!bClampSwing && !bClampTwist)
+			{
+				return false;
+			}
+
+			if (bClampTwist)
+			{
+				SinHalfTwist = SinHalfTwist < Limit.SinHalfMinTwist ? Limit.SinHalfMinTwist : Limit.SinHalfMaxTwist;
+				CosHalfTwist = std::sqrt(std::fmax(0.f, 1.f - SinHalfTwist * SinHalfTwist));
+				Twist[0] = Axis[0] * SinHalfTwist;
+				Twist[1] = Axis[1] * SinHalfTwist;
+				Twist[2] = Axis[2] * SinHalfTwist;
+				Twist[3] = CosHalfTwist;
+			}
+
+			if (bClampSwing)
+			{
+				const float SwingAxisSize = std::sqrt(Swing[0] * Swing[0] + Swing[1] * Swing[1] + Swing[2] * Swing[2]);
+				const float Scale = SwingAxisSize > SmallNumber ? Limit.SinHalfSwingLimit / SwingAxisSize : 0.f;
+				Swing[0] *= Scale;
+				Swing[1] *= Scale;
+				Swing[2] *= Scale;
+				Swing[3] = SwingAxisSize > SmallNumber ? Limit.CosHalfSwingLimit : 1.f;
+			}
+
+			// Clamped rotation is Parent * Ref * Swing * Twist, turned into a delta applied on top of the current rotation
+			float Clamped[4];
+			QuatMultiply(Swing, Twist, Clamped);
+			QuatMultiply(Limit.RefRotation, Clamped, Clamped);
+			QuatMultiply(ParentRotation, Clamped, Clamped);
+			QuatInverse(Rotation, Inverse);
+			QuatMultiply(Clamped, Inverse, OutDelta);
+
+			const float DeltaSize = std::sqrt(OutDelta[0] * OutDelta[0] + OutDelta[1] * OutDelta[1] + OutDelta[2] * OutDelta[2] + OutDelta[3] * OutDelta[3]);
+			if (DeltaSize <= SmallNumber)
+			{
+				return false;
+			}
+			OutDelta[0] /= DeltaSize;
+			OutDelta[1] /= DeltaSize;
+			OutDelta[2] /= DeltaSize;
+			OutDelta[3] /= DeltaSize;
+			return true;
+		}
+
+		/** Clamp a link that just rotated to its joint limit, carrying the links below it along */
+		template<typename RotateFunction>
+		inline void ApplyJointLimit(const FChainView& Chain, int32_t LinkIndex, RotateFunction&& Rotate)
+		{
+			const float ParentRotation[4] = { Chain.RotX[LinkIndex - 1], Chain.RotY[LinkIndex - 1], Chain.RotZ[LinkIndex - 1], Chain.RotW[LinkIndex - 1] };
+			const float Rotation[4] = { Chain.RotX[LinkIndex], Chain.RotY[LinkIndex], Chain.RotZ[LinkIndex], Chain.RotW[LinkIndex] };
+
+			float Delta[4];
+			if (ComputeJointLimitDelta(ParentRotation, Rotation, Chain.JointLimits[LinkIndex], Delta))
+			{
+				const float Pivot[3] = { Chain.PosX[LinkIndex], Chain.PosY[LinkIndex], Chain.PosZ[LinkIndex] };
+				Rotate(Pivot, Delta);
+			}
+		}
+
+		/** One CCD step on a link, the equivalent of UpdateChainLink in AnimationCore::SolveCCDIK */
+		bool UpdateChainLink(const FChainView& Chain, int32_t LinkIndex, const float Target[3], const FSolveSettings& Settings, EKernelPath Path)
+		{
+			const int32_t TipLinkIndex = Chain.NumLinks - 1;
+			const float Pivot[3] = { Chain.PosX[LinkIndex], Chain.PosY[LinkIndex], Chain.PosZ[LinkIndex] };
+			const float Tip[3] = { Chain.PosX[TipLinkIndex], Chain.PosY[TipLinkIndex], Chain.PosZ[TipLinkIndex] };
+
+			float Delta[4];
+			if (!ComputeLinkDelta(Pivot, Tip, Target, GetRotationLimit(Chain, LinkIndex), Chain.AngleDelta[LinkIndex], Settings.bEnableRotationLimit, Settings.bDeterministic, Delta))
+			{
+				return false;
+			}
+
+			// The link itself keeps its position, everything below it follows rigidly
+			RotateLinks(Chain, LinkIndex, Chain.NumLinks, Pivot, Delta, Path);
+
+			if (Settings.bEnableRotationLimit && Chain.JointLimits)
+			{
+				ApplyJointLimit(Chain, LinkIndex, [&Chain, LinkIndex, Path](const float LimitPivot[3], const float LimitDelta[4])
+				{
+					RotateLinks(Chain, LinkIndex, Chain.NumLinks, LimitPivot, LimitDelta, Path);
+				});
+			}
+			return true;
+		}
+	}
+
+	void RotateLinks(const FChainView& Chain, int32_t FirstLink, int32_t LastLink, const float Pivot[3], const float Delta[4], EKernelPath Path)
+	{
+		int32_t Link = FirstLink;
+
+		if (Path == EKernelPath::SIMD)
+		{
+#if CCDIK_WITH_AVX2
+			Link = RotateLinksLanes<FAVX2Lanes>(Chain, Link, LastLink, Pivot, Delta);
+#endif
+#if CCDIK_WITH_SSE
+			Link = RotateLinksLanes<FSSELanes>(Chain, Link, LastLink, Pivot, Delta);
+#endif
+		}
+
+		// Remainder, or everything on the scalar path
+		RotateLinksLanes<FScalarLanes>(Chain, Link, LastLink, Pivot, Delta);
+	}
+
+	FSolveResult SolveChain(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings, EKernelPath Path)
+	{
+		FSolveResult Result;
+		if (Chain.NumLinks <= 0)
+		{
+			return Result;
+		}
+
+		const int32_t TipLinkIndex = Chain.NumLinks - 1;
+		Result.TipError = Distance(Chain, TipLinkIndex, Target);
+
+		while ((Settings.bDeterministic || Result.TipError > Settings.Precision) && Result.Iterations < Settings.MaxIterations)
+		{
+			++Result.Iterations;
+
+			// Unlike AnimationCore::SolveCCDIK this flag is per iteration, so a pass that moves nothing ends the solve
+			bool bLocalUpdated = false;
+			if (Settings.bStartFromTail)
+			{
+				for (int32_t LinkIndex = TipLinkIndex - 1; LinkIndex > 0; --LinkIndex)
+				{
+					bLocalUpdated |= UpdateChainLink(Chain, LinkIndex, Target, Settings, Path);
+				}
+			}
+			else
+			{
+				for (int32_t LinkIndex = 1; LinkIndex < TipLinkIndex; ++LinkIndex)
+				{
+					bLocalUpdated |= UpdateChainLink(Chain, LinkIndex, Target, Settings, Path);
+				}
+			}
+
+			Result.TipError = Distance(Chain, TipLinkIndex, Target);
+			Result.bUpdated |= bLocalUpdated;
+
+			// no more update in this iteration
+			if (!bLocalUpdated)
+			{
+				break;
+			}
+		}
+
+		return Result;
+	}
+
+	namespace
+	{
+		/** SolveChain for a fixed chain length and flags. Loops have constant bounds so the compiler can unroll them. */
+		template<int32_t NumLinks, bool bStartFromTail, bool bEnableRotationLimit>
+		FSolveResult SolveChainFixed(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+		{
+			constexpr int32_t TipLinkIndex = NumLinks - 1;
+
+			// Solved in place: chains already live in contiguous planes, and a copy to the stack costs more than it saves
+			float RotationLimits[NumLinks];
+			for (int32_t Link = 0; Link < NumLinks; ++Link)
+			{
+				RotationLimits[Link] = GetRotationLimit(Chain, Link);
+			}
+
+			FSolveResult Result;
+			Result.TipError = Distance(Chain, TipLinkIndex, Target);
+
+			while ((Settings.bDeterministic || Result.TipError > Settings.Precision) && Result.Iterations < Settings.MaxIterations)
+			{
+				++Result.Iterations;
+
+				bool bLocalUpdated = false;
+				for (int32_t Step = 1; Step < TipLinkIndex; ++Step)
+				{
+					const int32_t LinkIndex = bStartFromTail ? TipLinkIndex - Step : Step;
+					const float Pivot[3] = { Chain.PosX[LinkIndex], Chain.PosY[LinkIndex], Chain.PosZ[LinkIndex] };
+					const float Tip[3] = { Chain.PosX[TipLinkIndex], Chain.PosY[TipLinkIndex], Chain.PosZ[TipLinkIndex] };
+
+					float Delta[4];
+					if (!ComputeLinkDelta(Pivot, Tip, Target, RotationLimits[LinkIndex], Chain.AngleDelta[LinkIndex], bEnableRotationLimit, Settings.bDeterministic, Delta))
+					{
+						continue;
+					}
+
+					// Same rotation as SolveChain, so both give the same bits
+					auto RotateSubtree = [&Chain, LinkIndex](const float SubtreePivot[3], const float SubtreeDelta[4])
+					{
+						RotateLinks(Chain, LinkIndex, NumLinks, SubtreePivot, SubtreeDelta, DefaultKernelPath);
+					};
+					RotateSubtree(Pivot, Delta);
+
+					if (bEnableRotationLimit && Chain.JointLimits)
+					{
+						ApplyJointLimit(Chain, LinkIndex, RotateSubtree);
+					}
+					bLocalUpdated = true;
+				}
+
+				Result.TipError = Distance(Chain, TipLinkIndex, Target);
+				Result.bUpdated |= bLocalUpdated;
+
+				if (!bLocalUpdated)
+				{
+					break;
+				}
+			}
+
+			return Result;
+		}
+
+		template<int32_t NumLinks>
+		FSolveChainFunction GetFixedSolver(bool bStartFromTail, bool bEnableRotationLimit)
+		{
+			static const FSolveChainFunction Solvers[2][2] =
+			{
+				{ &SolveChainFixed<NumLinks, false, false>, &SolveChainFixed<NumLinks, false, true> },
+				{ &SolveChainFixed<NumLinks, true, false>, &SolveChainFixed<NumLinks, true, true> },
+			};
+			return Solvers[bStartFromTail ? 1 : 0][bEnableRotationLimit ? 1 : 0];
+		}
+	}
+
+	FSolveChainFunction GetSpecializedSolver(int32_t NumLinks, bool bStartFromTail, bool bEnableRotationLimit)
+	{
+		static_assert(MinSpecializedLinks == 3 && MaxSpecializedLinks == 6, "Update the switch below with the specialized range");
+		switch (NumLinks)
+		{
+		case 3: return GetFixedSolver<3>(bStartFromTail, bEnableRotationLimit);
+		case 4: return GetFixedSolver<4>(bStartFromTail, bEnableRotationLimit);
+		case 5: return GetFixedSolver<5>(bStartFromTail, bEnableRotationLimit);
+		case 6: return GetFixedSolver<6>(bStartFromTail, bEnableRotationLimit);
+		default: return nullptr;
+		}
+	}
+
+	namespace
+	{
+		/** SolveChain with the default path, as a FSolveChainFunction */
+		FSolveResult SolveChainCCD(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+		{
+			return SolveChain(Chain, Target, Settings);
+		}
+
+		/**
+		*	Rotate a link and the links below it by Angle around a unit Axis, honoring the symmetric limit the same way
+		*	ComputeLinkDelta does, then the link's joint limit. Shared by the backends that compute their own rotations.
+		*/
+		bool RotateLinkLimited(const FChainView& Chain, int32_t LinkIndex, const float Axis[3], float Angle, const FSolveSettings& Settings)
+		{
+			const float RotationLimit = GetRotationLimit(Chain, LinkIndex);
+			Angle = Angle > RotationLimit ? RotationLimit : Angle;
+			if (Angle <= KindaSmallNumber)
+			{
+				return false;
+			}
+
+			if (Settings.bEnableRotationLimit)
+			{
+				float& AngleDelta = Chain.AngleDelta[LinkIndex];
+				if (RotationLimit < AngleDelta + Angle)
+				{
+					Angle = RotationLimit - AngleDelta;
+					if (Angle <= KindaSmallNumber)
+					{
+						return false;
+					}
+				}
+				AngleDelta += Angle;
+			}
+
+			float HalfSin, HalfCos;
+			HalfAngleSinCos(Angle, Settings.bDeterministic, HalfSin, HalfCos);
+			const float Delta[4] = { Axis[0] * HalfSin, Axis[1] * HalfSin, Axis[2] * HalfSin, HalfCos };
+			const float Pivot[3] = { Chain.PosX[LinkIndex], Chain.PosY[LinkIndex], Chain.PosZ[LinkIndex] };
+			const EKernelPath Path = Settings.bDeterministic ? EKernelPath::Scalar : DefaultKernelPath;
+			RotateLinks(Chain, LinkIndex, Chain.NumLinks, Pivot, Delta, Path);
+
+			if (Settings.bEnableRotationLimit && Chain.JointLimits)
+			{
+				ApplyJointLimit(Chain, LinkIndex, [&Chain, LinkIndex, Path](const float LimitPivot[3], const float LimitDelta[4])
+				{
+					RotateLinks(Chain, LinkIndex, Chain.NumLinks, LimitPivot, LimitDelta, Path);
+				});
+			}
+			return true;
+		}
+
+		/** Turn a link so the direction towards its child becomes Desired. Returns false if it did not move. */
+		bool AimLink(const FChainView& Chain, int32_t LinkIndex, float DesiredX, float DesiredY, float DesiredZ, const FSolveSettings& Settings)
+		{
+			float CurrentX = Chain.PosX[LinkIndex + 1] - Chain.PosX[LinkIndex];
+			float CurrentY = Chain.PosY[LinkIndex + 1] - Chain.PosY[LinkIndex];
+			float CurrentZ = Chain.PosZ[LinkIndex + 1] - Chain.PosZ[LinkIndex];
+			if (!Normalize(CurrentX, CurrentY, CurrentZ) || !Normalize(DesiredX, DesiredY, DesiredZ))
+			{
+				return false;
+			}
+
+			float Axis[3] = { CurrentY * DesiredZ - CurrentZ * DesiredY, CurrentZ * DesiredX - CurrentX * DesiredZ, CurrentX * DesiredY - CurrentY * DesiredX };
+			if (!Normalize(Axis[0], Axis[1], Axis[2]))
+			{
+				return false;
+			}
+
+			const float Dot = CurrentX * DesiredX + CurrentY * DesiredY + CurrentZ * DesiredZ;
+			return RotateLinkLimited(Chain, LinkIndex, Axis, ClampedAcos(Dot, Settings.bDeterministic), Settings);
+		}
+	}
+
+	FSolveResult SolveChainFABRIK(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+	{
+		const int32_t NumLinks = Chain.NumLinks;
+		if (NumLinks > MaxBackendLinks)
+		{
+			return SolveChain(Chain, Target, Settings);
+		}
+
+		FSolveResult Result;
+		if (NumLinks <= 0)
+		{
+			return Result;
+		}
+
+		const int32_t TipLinkIndex = NumLinks - 1;
+		Result.TipError = Distance(Chain, TipLinkIndex, Target);
+
+		// Link 1 is the base: the root never rotates, so it never moves. Lengths[i] is the bone from link i to link i + 1.
+		float PosX[MaxBackendLinks], PosY[MaxBackendLinks], PosZ[MaxBackendLinks], Lengths[MaxBackendLinks];
+		for (int32_t Link = 0; Link < NumLinks; ++Link)
+		{
+			PosX[Link] = Chain.PosX[Link];
+			PosY[Link] = Chain.PosY[Link];
+			PosZ[Link] = Chain.PosZ[Link];
+		}
+		for (int32_t Link = 1; Link < TipLinkIndex; ++Link)
+		{
+			const float X = PosX[Link + 1] - PosX[Link];
+			const float Y = PosY[Link + 1] - PosY[Link];
+			const float Z = PosZ[Link + 1] - PosZ[Link];
+			Lengths[Link] = std::sqrt(X * X + Y * Y + Z * Z);
+		}
+
+		// Place each link at its bone length from the previous one, along the line to where it currently is
+		auto Reach = [&PosX, &PosY, &PosZ](int32_t Link, int32_t From, float Length)
+		{
+			float X = PosX[Link] - PosX[From];
+			float Y = PosY[Link] - PosY[From];
+			float Z = PosZ[Link] - PosZ[From];
+			Normalize(X, Y, Z);
+			PosX[Link] = PosX[From] + X * Length;
+			PosY[Link] = PosY[From] + Y * Length;
+			PosZ[Link] = PosZ[From] + Z * Length;
+		};
+
+		float PositionError = Result.TipError;
+		while ((Settings.bDeterministic || PositionError > Settings.Precision) && Result.Iterations < Settings.MaxIterations)
+		{
+			++Result.Iterations;
+
+			// Backward: tip onto the target, every link pulled after it
+			PosX[TipLinkIndex] = Target[0];
+			PosY[TipLinkIndex] = Target[1];
+			PosZ[TipLinkIndex] = Target[2];
+			for (int32_t Link = TipLinkIndex - 1; Link > 1; --Link)
+			{
+				Reach(Link, Link + 1, Lengths[Link]);
+			}
+
+			// Forward: base back in place, every link pushed after it
+			for (int32_t Link = 2; Link < NumLinks; ++Link)
+			{
+				Reach(Link, Link - 1, Lengths[Link - 1]);
+			}
+
+			const float X = Target[0] - PosX[TipLinkIndex];
+			const float Y = Target[1] - PosY[TipLinkIndex];
+			const float Z = Target[2] - PosZ[TipLinkIndex];
+			const float NewError = std::sqrt(X * X + Y * Y + Z * Z);
+
+			// Out of reach, the chain is already stretched towards the target. A deterministic solve runs every iteration.
+			const bool bStalled = std::fabs(PositionError - NewError) <= KindaSmallNumber;
+			PositionError = NewError;
+			if (bStalled && !Settings.bDeterministic)
+			{
+				break;
+			}
+		}
+
+		// Turn the links root to tip so each bone points where FABRIK placed it. Limits may keep a link short of it.
+		for (int32_t Link = 1; Link < TipLinkIndex; ++Link)
+		{
+			Result.bUpdated |= AimLink(Chain, Link, PosX[Link + 1] - PosX[Link], PosY[Link + 1] - PosY[Link], PosZ[Link + 1] - PosZ[Link], Settings);
+		}
+
+		Result.TipError = Distance(Chain, TipLinkIndex, Target);
+		return Result;
+	}
+
+	FSolveResult SolveChainDampedLeastSquares(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+	{
+		const int32_t NumLinks = Chain.NumLinks;
+		if (NumLinks > MaxBackendLinks)
+		{
+			return SolveChain(Chain, Target, Settings);
+		}
+
+		FSolveResult Result;
+		if (NumLinks <= 0)
+		{
+			return Result;
+		}
+
+		const int32_t TipLinkIndex = NumLinks - 1;
+		const float DampingSquared = Settings.Damping * Settings.Damping;
+		Result.TipError = Distance(Chain, TipLinkIndex, Target);
+
+		float LeverX[MaxBackendLinks], LeverY[MaxBackendLinks], LeverZ[MaxBackendLinks];
+		while ((Settings.bDeterministic || Result.TipError > Settings.Precision) && Result.Iterations < Settings.MaxIterations)
+		{
+			++Result.Iterations;
+
+			// Each movable link is a ball joint: angular velocity w moves the tip by w x r, with r the lever from link to tip.
+			// J * J^T sums |r|^2 I - r r^T over the links, damped: A = J * J^T + Damping^2 I.
+			const float TipX = Chain.PosX[TipLinkIndex];
+			const float TipY = Chain.PosY[TipLinkIndex];
+			const float TipZ = Chain.PosZ[TipLinkIndex];
+			float A00 = DampingSquared, A01 = 0.f, A02 = 0.f, A11 = DampingSquared, A12 = 0.f, A22 = DampingSquared;
+			for (int32_t Link = 1; Link < TipLinkIndex; ++Link)
+			{
+				const float RX = TipX - Chain.PosX[Link];
+				const float RY = TipY - Chain.PosY[Link];
+				const float RZ = TipZ - Chain.PosZ[Link];
+				const float LengthSquared = RX * RX + RY * RY + RZ * RZ;
+				A00 += LengthSquared - RX * RX;
+				A11 += LengthSquared - RY * RY;
+				A22 += LengthSquared - RZ * RZ;
+				A01 -= RX * RY;
+				A02 -= RX * RZ;
+				A12 -= RY * RZ;
+				LeverX[Link] = RX;
+				LeverY[Link] = RY;
+				LeverZ[Link] = RZ;
+			}
+
+			// Solve A y = e for the tip error e, A is symmetric 3x3
+			const float C00 = A11 * A22 - A12 * A12;
+			const float C01 = A02 * A12 - A01 * A22;
+			const float C02 = A01 * A12 - A02 * A11;
+			const float Determinant = A00 * C00 + A01 * C01 + A02 * C02;
+			if (std::fabs(Determinant) <= SmallNumber)
+			{
+				break;
+			}
+			const float C11 = A00 * A22 - A02 * A02;
+			const float C12 = A01 * A02 - A00 * A12;
+			const float C22 = A00 * A11 - A01 * A01;
+			const float EX = Target[0] - TipX;
+			const float EY = Target[1] - TipY;
+			const float EZ = Target[2] - TipZ;
+			const float InvDeterminant = 1.f / Determinant;
+			const float YX = (C00 * EX + C01 * EY + C02 * EZ) * InvDeterminant;
+			const float YY = (C01 * EX + C11 * EY + C12 * EZ) * InvDeterminant;
+			const float YZ = (C02 * EX + C12 * EY + C22 * EZ) * InvDeterminant;
+
+			// w = J^T y = r x y per link. Applied tip side first, so the pivots of the links still to rotate have not moved.
+			bool bLocalUpdated = false;
+			for (int32_t Link = TipLinkIndex - 1; Link > 0; --Link)
+			{
+				float Axis[3] = { LeverY[Link] * YZ - LeverZ[Link] * YY, LeverZ[Link] * YX - LeverX[Link] * YZ, LeverX[Link] * YY - LeverY[Link] * YX };
+				const float Angle = std::sqrt(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+				if (Angle > KindaSmallNumber)
+				{
+					Axis[0] /= Angle;
+					Axis[1] /= Angle;
+					Axis[2] /= Angle;
+					bLocalUpdated |= RotateLinkLimited(Chain, Link, Axis, Angle, Settings);
+				}
+			}
+
+			Result.TipError = Distance(Chain, TipLinkIndex, Target);
+			Result.bUpdated |= bLocalUpdated;
+			if (!bLocalUpdated)
+			{
+				break;
+			}
+		}
+
+		return Result;
+	}
+
+	namespace
+	{
+		/** SolveChain on the scalar path, as a FSolveChainFunction */
+		FSolveResult SolveChainCCDScalar(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+		{
+			return SolveChain(Chain, Target, Settings, EKernelPath::Scalar);
+		}
+
+		/**
+		*	Solve, then renormalize every rotation and keep its W positive. Q and -Q are the same rotation, the canonical
+		*	one is what both ends of a replay compare and blend from.
+		*/
+		template<FSolveChainFunction Solve>
+		FSolveResult SolveChainDeterministic(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings)
+		{
+			const FSolveResult Result = Solve(Chain, Target, Settings);
+			for (int32_t Link = 0; Link < Chain.NumLinks; ++Link)
+			{
+				float X = Chain.RotX[Link], Y = Chain.RotY[Link], Z = Chain.RotZ[Link], W = Chain.RotW[Link];
+				const float SizeSquared = X * X + Y * Y + Z * Z + W * W;
+				if (SizeSquared > SmallNumber)
+				{
+					const float Scale = (W < 0.f ? -1.f : 1.f) / std::sqrt(SizeSquared);
+					Chain.RotX[Link] = X * Scale;
+					Chain.RotY[Link] = Y * Scale;
+					Chain.RotZ[Link] = Z * Scale;
+					Chain.RotW[Link] = W * Scale;
+				}
+			}
+			return Result;
+		}
+	}
+
+	FSolveChainFunction GetSolveFunction(int32_t NumLinks, const FSolveSettings& Settings)
+	{
+		if (Settings.bDeterministic)
+		{
+			switch (Settings.Backend)
+			{
+			case ESolverBackend::FABRIK:
+				return &SolveChainDeterministic<&SolveChainFABRIK>;
+			case ESolverBackend::DampedLeastSquares:
+				return &SolveChainDeterministic<&SolveChainDampedLeastSquares>;
+			default:
+				return &SolveChainDeterministic<&SolveChainCCDScalar>;
+			}
+		}
+
+		switch (Settings.Backend)
+		{
+		case ESolverBackend::FABRIK:
+			return &SolveChainFABRIK;
+		case ESolverBackend::DampedLeastSquares:
+			return &SolveChainDampedLeastSquares;
+		default:
+		{
+			const FSolveChainFunction Specialized = GetSpecializedSolver(NumLinks, Settings.bStartFromTail, Settings.bEnableRotationLimit);
+			return Specialized ? Specialized : &SolveChainCCD;
+		}
+		}
+	}
+
+	void SolveChainGroup(const FChainView* Chains, const float (*Targets)[3], const FSolveSettings* Settings, FSolveResult* Results, int32_t NumChains, float* Scratch)
+	{
+#if CCDIK_WITH_SSE
+		typedef FSSELanes LaneType;
+#else
+		typedef FScalarLanes LaneType;
+#endif
+		constexpr int32_t Width = LaneType::Width;
+		static_assert(Width == GroupWidth, "GroupWidth has to match the lane type used here");
+
+		if (NumChains <= 0)
+		{
+			return;
+		}
+
+		const int32_t NumLinks = Chains[0].NumLinks;
+		const int32_t TipLinkIndex = NumLinks - 1;
+		const bool bStartFromTail = Settings[0].bStartFromTail;
+
+		// Interleave the chains: element (Link, Lane) lives at Link * Width + Lane
+		const int32_t NumElements = NumLinks * Width;
+		FChainView Group;
+		Group.PosX = Scratch;
+		Group.PosY = Group.PosX + NumElements;
+		Group.PosZ = Group.PosY + NumElements;
+		Group.RotX = Group.PosZ + NumElements;
+		Group.RotY = Group.RotX + NumElements;
+		Group.RotZ = Group.RotY + NumElements;
+		Group.RotW = Group.RotZ + NumElements;
+		Group.AngleDelta = Group.RotW + NumElements;
+		float* GroupLimits = Group.AngleDelta + NumElements;
+		Group.RotationLimits = GroupLimits;
+		Group.NumLinks = NumLinks;
+
+		for (int32_t Lane = 0; Lane < Width; ++Lane)
+		{
+			// Unused lanes solve nothing, but still need sane data for the vector math
+			const FChainView& Source = Chains[Lane < NumChains ? Lane : 0];
+			for (int32_t Link = 0; Link < NumLinks; ++Link)
+			{
+				const int32_t Index = Link * Width + Lane;
+				Group.PosX[Index] = Source.PosX[Link];
+				Group.PosY[Index] = Source.PosY[Link];
+				Group.PosZ[Index] = Source.PosZ[Link];
+				Group.RotX[Index] = Source.RotX[Link];
+				Group.RotY[Index] = Source.RotY[Link];
+				Group.RotZ[Index] = Source.RotZ[Link];
+				Group.RotW[Index] = Source.RotW[Link];
+				Group.AngleDelta[Index] = Source.AngleDelta[Link];
+				GroupLimits[Index] = GetRotationLimit(Source, Link);
+			}
+		}
+
+		// Per lane state, same loop conditions as SolveChain
+		bool bRunning[Width];
+		bool bAnyRunning = false;
+		for (int32_t Lane = 0; Lane < Width; ++Lane)
+		{
+			if (Lane < NumChains)
+			{
+				Results[Lane] = FSolveResult();
+				const float Tip[3] = { Group.PosX[TipLinkIndex * Width + Lane], Group.PosY[TipLinkIndex * Width + Lane], Group.PosZ[TipLinkIndex * Width + Lane] };
+				const float X = Targets[Lane][0] - Tip[0];
+				const float Y = Targets[Lane][1] - Tip[1];
+				const float Z = Targets[Lane][2] - Tip[2];
+				Results[Lane].TipError = std::sqrt(X * X + Y * Y + Z * Z);
+			}
+			bRunning[Lane] = Lane < NumChains && (Settings[Lane].bDeterministic || Results[Lane].TipError > Settings[Lane].Precision) && Settings[Lane].MaxIterations > 0;
+			bAnyRunning |= bRunning[Lane];
+		}
+
+		while (bAnyRunning)
+		{
+			bool bLocalUpdated[Width] = {};
+			for (int32_t Lane = 0; Lane < NumChains && Lane < Width; ++Lane)
+			{
+				Results[Lane].Iterations += bRunning[Lane] ? 1 : 0;
+			}
+
+			for (int32_t Step = 1; Step < TipLinkIndex; ++Step)
+			{
+				const int32_t LinkIndex = bStartFromTail ? TipLinkIndex - Step : Step;
+
+				// Trig is done per lane, the subtree rotation for all lanes at once
+				float PivotX[Width], PivotY[Width], PivotZ[Width];
+				float DeltaX[Width], DeltaY[Width], DeltaZ[Width], DeltaW[Width];
+				float Mask[Width];
+				bool bAnyMoved = false;
+				for (int32_t Lane = 0; Lane < Width; ++Lane)
+				{
+					const int32_t Index = LinkIndex * Width + Lane;
+					const int32_t TipIndex = TipLinkIndex * Width + Lane;
+					const float Pivot[3] = { Group.PosX[Index], Group.PosY[Index], Group.PosZ[Index] };
+					const float Tip[3] = { Group.PosX[TipIndex], Group.PosY[TipIndex], Group.PosZ[TipIndex] };
+					float Delta[4] = { 0.f, 0.f, 0.f, 1.f };
+
+					const bool bMoved = bRunning[Lane] && ComputeLinkDelta(Pivot, Tip, Targets[Lane], GroupLimits[Index], Group.AngleDelta[Index], Settings[Lane].bEnableRotationLimit, Settings[Lane].bDeterministic, Delta);
+					PivotX[Lane] = Pivot[0];
+					PivotY[Lane] = Pivot[1];
+					PivotZ[Lane] = Pivot[2];
+					DeltaX[Lane] = Delta[0];
+					DeltaY[Lane] = Delta[1];
+					DeltaZ[Lane] = Delta[2];
+					DeltaW[Lane] = Delta[3];
+					Mask[Lane] = bMoved ? 1.f : 0.f;
+					bLocalUpdated[Lane] |= bMoved;
+					bAnyMoved |= bMoved;
+				}
+
+				if (bAnyMoved)
+				{
+					const TRigidRotation<LaneType> Rotation(PivotX, PivotY, PivotZ, DeltaX, DeltaY, DeltaZ, DeltaW);
+					const LaneType::Type LaneMask = LaneType::Load(Mask);
+					for (int32_t Link = LinkIndex; Link < NumLinks; ++Link)
+					{
+						Rotation.Apply<true>(Group, Link * Width, LaneMask);
+					}
+
+					// Joint limits of the lanes that moved, clamped by a second masked rotation around the same pivots
+					bool bAnyClamped = false;
+					for (int32_t Lane = 0; Lane < Width; ++Lane)
+					{
+						bool bClamped = false;
+						if (Mask[Lane] > 0.5f && Settings[Lane].bEnableRotationLimit && Chains[Lane].JointLimits)
+						{
+							const int32_t Index = LinkIndex * Width + Lane;
+							const int32_t ParentIndex = Index - Width;
+							const float ParentRotation[4] = { Group.RotX[ParentIndex], Group.RotY[ParentIndex], Group.RotZ[ParentIndex], Group.RotW[ParentIndex] };
+							const float Rotation[4] = { Group.RotX[Index], Group.RotY[Index], Group.RotZ[Index], Group.RotW[Index] };
+							float Delta[4];
+							bClamped = ComputeJointLimitDelta(ParentRotation, Rotation, Chains[Lane].JointLimits[LinkIndex], Delta);
+							if (bClamped)
+							{
+								DeltaX[Lane] = Delta[0];
+								DeltaY[Lane] = Delta[1];
+								DeltaZ[Lane] = Delta[2];
+								DeltaW[Lane] = Delta[3];
+							}
+						}
+						Mask[Lane] = bClamped ? 1.f : 0.f;
+						bAnyClamped |= bClamped;
+					}
+
+					if (bAnyClamped)
+					{
+						const TRigidRotation<LaneType> LimitRotation(PivotX, PivotY, PivotZ, DeltaX, DeltaY, DeltaZ, DeltaW);
+						const LaneType::Type LimitMask = LaneType::Load(Mask);
+						for (int32_t Link = LinkIndex; Link < NumLinks; ++Link)
+						{
+							LimitRotation.Apply<true>(Group, Link * Width, LimitMask);
+						}
+					}
+				}
+			}
+
+			bAnyRunning = false;
+			for (int32_t Lane = 0; Lane < NumChains && Lane < Width; ++Lane)
+			{
+				if (!bRunning[Lane])
+				{
+					continue;
+				}
+
+				const int32_t TipIndex = TipLinkIndex * Width + Lane;
+				const float X = Targets[Lane][0] - Group.PosX[TipIndex];
+				const float Y = Targets[Lane][1] - Group.PosY[TipIndex];
+				const float Z = Targets[Lane][2] - Group.PosZ[TipIndex];
+				Results[Lane].TipError = std::sqrt(X * X + Y * Y + Z * Z);
+				Results[Lane].bUpdated |= bLocalUpdated[Lane];
+
+				bRunning[Lane] = bLocalUpdated[Lane] && (Settings[Lane].bDeterministic || Results[Lane].TipError > Settings[Lane].Precision) && Results[Lane].Iterations < Settings[Lane].MaxIterations;
+				bAnyRunning |= bRunning[Lane];
+			}
+		}
+
+		for (int32_t Lane = 0; Lane < NumChains && Lane < Width; ++Lane)
+		{
+			const FChainView& Target = Chains[Lane];
+			for (int32_t Link = 0; Link < NumLinks; ++Link)
+			{
+				const int32_t Index = Link * Width + Lane;
+				Target.PosX[Link] = Group.PosX[Index];
+				Target.PosY[Link] = Group.PosY[Index];
+				Target.PosZ[Link] = Group.PosZ[Index];
+				Target.RotX[Link] = Group.RotX[Index];
+				Target.RotY[Link] = Group.RotY[Index];
+				Target.RotZ[Link] = Group.RotZ[Index];
+				Target.RotW[Link] = Group.RotW[Index];
+				Target.AngleDelta[Link] = Group.AngleDelta[Index];
+			}
+		}
+	}
+}
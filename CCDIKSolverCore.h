@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+*	Engine independent CCDIK chain solver.
+*
+*	Works on structure-of-arrays chain data (one float array per position/rotation component) so it can be
+*	built and exercised without the engine. FAnimNode_CCDIK fills the arrays from the pose and writes the
+*	result back. Only standard C++ and SSE/AVX intrinsics are used in here.
+*/
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CCDIK_WITH_SSE 1
+#else
+	#define CCDIK_WITH_SSE 0
+#endif
+
+#if CCDIK_WITH_SSE && defined(__AVX2__)
+	#define CCDIK_WITH_AVX2 1
+#else
+	#define CCDIK_WITH_AVX2 0
+#endif
+
+namespace CCDIKSolverCore
+{
+	/**
+	*	Swing cone and twist range of one link, precompiled so clamping needs no trigonometry.
+	*	Angles are stored as sines and cosines of half angles, which is what the quaternion components hold.
+	*/
+	struct FJointLimit
+	{
+		/** Reference rotation of the link relative to its parent link, the constraint is centered on it */
+		float RefRotation[4] = { 0.f, 0.f, 0.f, 1.f };
+
+		/** Unit twist axis, in the link's local space */
+		float TwistAxis[3] = { 1.f, 0.f, 0.f };
+
+		/** Cosine and sine of half the swing limit. A cosine of zero allows any swing. */
+		float CosHalfSwingLimit = 0.f;
+		float SinHalfSwingLimit = 1.f;
+
+		/** Sines of half the twist range */
+		float SinHalfMinTwist = -1.f;
+		float SinHalfMaxTwist = 1.f;
+
+		bool IsLimited() const { return CosHalfSwingLimit > 0.f || SinHalfMinTwist > -1.f || SinHalfMaxTwist < 1.f; }
+	};
+
+	/** Mutable view over the SoA data of one chain, root link first. Positions and rotations are in component space. */
+	struct FChainView
+	{
+		float* PosX = nullptr;
+		float* PosY = nullptr;
+		float* PosZ = nullptr;
+
+		float* RotX = nullptr;
+		float* RotY = nullptr;
+		float* RotZ = nullptr;
+		float* RotW = nullptr;
+
+		/** Rotation accumulated by each link during the solve, used by rotation limits. Reset to zero before solving. */
+		float* AngleDelta = nullptr;
+
+		/** Symmetric rotation limit per link, in radians */
+		const float* RotationLimits = nullptr;
+
+		/** Swing and twist limit per link, nullptr when no link of the chain is constrained */
+		const FJointLimit* JointLimits = nullptr;
+
+		int32_t NumLinks = 0;
+	};
+
+	/** Algorithms available to solve a chain. Every one works on the same FChainView. */
+	enum class ESolverBackend : uint8_t
+	{
+		/** Cyclic coordinate descent, one link at a time. Cheap iterations, slow to converge on long chains. */
+		CCD,
+
+		/** Forward and backward reaching on link positions, turned back into link rotations root to tip. Few iterations on long chains. */
+		FABRIK,
+
+		/** Damped least squares on the tip position Jacobian. Every link moves a little each iteration, stable near full extension. */
+		DampedLeastSquares,
+
+		Num
+	};
+
+	struct FSolveSettings
+	{
+		/** Tolerance for final tip location delta from the target */
+		float Precision = 1.f;
+
+		/** Maximum number of iterations allowed */
+		int32_t MaxIterations = 10;
+
+		/** Iterate from tip to root instead of root to tip */
+		bool bStartFromTail = true;
+
+		/** Apply RotationLimits, and JointLimits when the chain has them */
+		bool bEnableRotationLimit = false;
+
+		ESolverBackend Backend = ESolverBackend::CCD;
+
+		/** Damping of DampedLeastSquares, in component space units. Larger is slower but steadier. */
+		float Damping = 1.f;
+
+		/**
+		*	Same output bits for the same input on any platform, compiler and thread, for server and client replay. Iterations
+		*	run with no Precision or stall early-out, trigonometry comes from fixed polynomials instead of the C runtime, and
+		*	GetSolveFunction picks scalar kernels and hands back canonical rotations. Costs MaxIterations unless an iteration
+		*	moves no link.
+		*/
+		bool bDeterministic = false;
+	};
+
+	struct FSolveResult
+	{
+		/** Iterations actually run */
+		int32_t Iterations = 0;
+
+		/** Distance between tip and target after the solve */
+		float TipError = 0.f;
+
+		/** Whether any link moved */
+		bool bUpdated = false;
+	};
+
+	enum class EKernelPath : uint8_t
+	{
+		/** Plain scalar code. Reference for every other path. */
+		Scalar,
+
+		/** Widest vector path compiled in: AVX2 when available, SSE otherwise. Falls back to Scalar without SIMD support. */
+		SIMD,
+	};
+
+	/** Best path available in this build */
+	constexpr EKernelPath DefaultKernelPath = CCDIK_WITH_SSE ? EKernelPath::SIMD : EKernelPath::Scalar;
+
+	/**
+	*	Run CCDIK on a chain so its tip reaches Target. Root link never rotates.
+	*	Matches AnimationCore::SolveCCDIK, except children follow their rotated parent rigidly instead of being
+	*	recomposed from local transforms, which is the same result without keeping local transforms around.
+	*/
+	FSolveResult SolveChain(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings, EKernelPath Path = DefaultKernelPath);
+
+	/**
+	*	Rotate links [FirstLink, LastLink) of a chain around Pivot by quaternion Delta, then renormalize their rotations.
+	*	This is the inner loop of SolveChain, exposed so each path can be checked against Scalar.
+	*/
+	void RotateLinks(const FChainView& Chain, int32_t FirstLink, int32_t LastLink, const float Pivot[3], const float Delta[4], EKernelPath Path = DefaultKernelPath);
+
+	/** Solver specialized for one chain length and set of flags, see GetSpecializedSolver */
+	typedef FSolveResult (*FSolveChainFunction)(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings);
+
+	/** Chain lengths, in links, with a specialized solver. Arms and legs fall in this range. */
+	constexpr int32_t MinSpecializedLinks = 3;
+	constexpr int32_t MaxSpecializedLinks = 6;
+
+	/**
+	*	Solver compiled for chains of exactly NumLinks links with the given direction and rotation limit flags, or nullptr
+	*	if there is none. Every loop has a compile time bound and the flag branches are gone from the inner loop. Gives the
+	*	same result as SolveChain. Pick it once, then call it every solve. See Tests/CCDIKSpecializedSolverBenchmark.cpp.
+	*/
+	FSolveChainFunction GetSpecializedSolver(int32_t NumLinks, bool bStartFromTail, bool bEnableRotationLimit);
+
+	/** Longest chain FABRIK and DampedLeastSquares solve, their scratch lives on the stack. Longer chains fall back to CCD. */
+	constexpr int32_t MaxBackendLinks = 64;
+
+	/** Settings.Backend is ignored, the chain is solved with FABRIK */
+	FSolveResult SolveChainFABRIK(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings);
+
+	/** Settings.Backend is ignored, the chain is solved with damped least squares */
+	FSolveResult SolveChainDampedLeastSquares(const FChainView& Chain, const float Target[3], const FSolveSettings& Settings);
+
+	/**
+	*	Solver for Settings.Backend and a chain of NumLinks links, a specialized CCD kernel when there is one. Never nullptr.
+	*	With Settings.bDeterministic it is the scalar kernel of the backend followed by rotation canonicalization.
+	*/
+	FSolveChainFunction GetSolveFunction(int32_t NumLinks, const FSolveSettings& Settings);
+
+	/** Number of chains SolveChainGroup solves side by side, one per SIMD lane */
+	constexpr int32_t GroupWidth = CCDIK_WITH_SSE ? 4 : 1;
+
+	/** Floats of scratch SolveChainGroup needs for chains of NumLinks links */
+	constexpr int32_t GetGroupScratchSize(int32_t NumLinks)
+	{
+		return NumLinks * GroupWidth * 9;
+	}
+
+	/**
+	*	Solve up to GroupWidth chains together, typically from different characters, one chain per SIMD lane.
+	*	All chains need the same NumLinks and bStartFromTail, everything else can differ per chain.
+	*	Each chain gets the same result SolveChain would give it. Scratch must hold GetGroupScratchSize(NumLinks) floats.
+	*/
+	void SolveChainGroup(const FChainView* Chains, const float (*Targets)[3], const FSolveSettings* Settings, FSolveResult* Results, int32_t NumChains, float* Scratch);
+}
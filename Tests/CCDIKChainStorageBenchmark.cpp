@@ -0,0 +1,531 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/**
+*	Cache behaviour of the two chain layouts FAnimNode_CCDIK has used, on a crowd of 60 bone full body rigs.
+*
+*	Legacy: one heap array of FCCDIKChainLink per chain, full transforms and a child index array per link, gathered
+*	into solver planes before every solve and scattered back after it. SoA: every chain of a character in one
+*	FCCDIKChainStorage style buffer, the pose written straight into the solver planes and read straight back out.
+*
+*	Both refresh the chains from the pose, solve every chain and write the solved bones out, on enough characters
+*	that their data does not fit in the last level cache. Each layout runs once with full solves and once with
+*	MaxIterations at zero, which leaves only the data movement the layouts differ in. Reports ns per character and,
+*	on Linux when perf events are allowed, cache misses per character. Pass --quick for a short smoke run.
+*/
+
+#include "BoneControllers/CCDIKSolverCore.h"
+#include "CCDIKTestChains.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+using namespace CCDIKSolverCore;
+using namespace CCDIKTest;
+
+namespace
+{
+	/** FTransform as the vectorized engine build lays it out, 48 bytes */
+	struct alignas(16) FBenchTransform
+	{
+		float Rotation[4] = { 0.f, 0.f, 0.f, 1.f };
+		float Translation[4] = { 0.f, 0.f, 0.f, 0.f };
+		float Scale3D[4] = { 1.f, 1.f, 1.f, 0.f };
+	};
+
+	/** AnimationCore's FCCDIKChainLink */
+	struct FLegacyChainLink
+	{
+		FBenchTransform Transform;
+		FBenchTransform LocalTransform;
+		int32_t TransformIndex = 0;
+		std::vector<int32_t> ChildZeroLengthTransformIndices;
+		float CurrentAngleDelta = 0.f;
+	};
+
+	/**
+	*	60 bones: pelvis, spine, neck and head, two arms and two legs, three bones on each of ten fingers and eight
+	*	twist bones riding on the limbs with no length of their own. Chains are the spine to the head, each arm from
+	*	the last spine bone, each leg from the pelvis, and each finger from its hand. 15 chains, 66 links.
+	*/
+	struct FBenchRig
+	{
+		std::vector<int32_t> ParentIndices;
+		std::vector<std::vector<int32_t>> Chains;
+
+		/** Twist bone and the chain link bone it rides on */
+		std::vector<std::pair<int32_t, int32_t>> ZeroLengthBones;
+
+		FBenchRig()
+		{
+			auto AddBone = [this](int32_t Parent)
+			{
+				ParentIndices.push_back(Parent);
+				return int32_t(ParentIndices.size()) - 1;
+			};
+
+			std::vector<int32_t> Spine = { AddBone(-1) };
+			for (int32_t Bone = 0; Bone < 5; Bone++)
+			{
+				Spine.push_back(AddBone(Spine.back()));
+			}
+			Chains.push_back(Spine);
+
+			std::vector<int32_t> Hands;
+			for (int32_t Side = 0; Side < 2; Side++)
+			{
+				std::vector<int32_t> Arm = { Spine[3] };
+				for (int32_t Bone = 0; Bone < 4; Bone++)
+				{
+					Arm.push_back(AddBone(Arm.back()));
+				}
+				Chains.push_back(Arm);
+				Hands.push_back(Arm.back());
+				ZeroLengthBones.push_back({ AddBone(Arm[2]), Arm[2] });
+				ZeroLengthBones.push_back({ AddBone(Arm[3]), Arm[3] });
+
+				std::vector<int32_t> Leg = { Spine[0] };
+				for (int32_t Bone = 0; Bone < 4; Bone++)
+				{
+					Leg.push_back(AddBone(Leg.back()));
+				}
+				Chains.push_back(Leg);
+				ZeroLengthBones.push_back({ AddBone(Leg[1]), Leg[1] });
+				ZeroLengthBones.push_back({ AddBone(Leg[2]), Leg[2] });
+			}
+
+			for (int32_t Hand : Hands)
+			{
+				for (int32_t Finger = 0; Finger < 5; Finger++)
+				{
+					std::vector<int32_t> FingerChain = { Hand };
+					for (int32_t Bone = 0; Bone < 3; Bone++)
+					{
+						FingerChain.push_back(AddBone(FingerChain.back()));
+					}
+					Chains.push_back(FingerChain);
+				}
+			}
+		}
+
+		int32_t GetNumBones() const { return int32_t(ParentIndices.size()); }
+	};
+
+	/** Component space pose of one character, read by the refresh and written by the write back */
+	struct FBenchPose
+	{
+		std::vector<FBenchTransform> Input;
+		std::vector<FBenchTransform> Output;
+	};
+
+	void MakePose(const FBenchRig& Rig, std::mt19937& Random, FBenchPose& OutPose)
+	{
+		OutPose.Input.resize(Rig.GetNumBones());
+		OutPose.Output.resize(Rig.GetNumBones());
+		for (int32_t Bone = 0; Bone < Rig.GetNumBones(); Bone++)
+		{
+			FBenchTransform& Transform = OutPose.Input[Bone];
+			const int32_t Parent = Rig.ParentIndices[Bone];
+			RandRotation(Random, 1.f, Transform.Rotation);
+			if (Parent >= 0)
+			{
+				const float Offset[3] = { RandRange(Random, 5.f, 30.f), RandRange(Random, -5.f, 5.f), RandRange(Random, -5.f, 5.f) };
+				float Rotated[3];
+				RotateVector(OutPose.Input[Parent].Rotation, Offset, Rotated);
+				for (int32_t Axis = 0; Axis < 3; Axis++)
+				{
+					Transform.Translation[Axis] = OutPose.Input[Parent].Translation[Axis] + Rotated[Axis];
+				}
+			}
+		}
+	}
+
+	/** Effector of a chain this frame: its input tip, swept around so every frame solves */
+	void GetTarget(const FBenchPose& Pose, int32_t TipBone, int32_t Frame, float OutTarget[3])
+	{
+		const float* Tip = Pose.Input[TipBone].Translation;
+		OutTarget[0] = Tip[0] + float((Frame * 7) % 11) - 5.f;
+		OutTarget[1] = Tip[1] + float((Frame * 5) % 9) - 4.f;
+		OutTarget[2] = Tip[2] + float((Frame * 3) % 7) - 3.f;
+	}
+
+	/** Zero leaves only the refresh, the distance check and the write back */
+	int32_t MaxIterations = 10;
+
+	FSolveSettings GetSettings()
+	{
+		FSolveSettings Settings;
+		Settings.Precision = 0.5f;
+		Settings.MaxIterations = MaxIterations;
+		return Settings;
+	}
+
+	/** Chains of one character in the layout before FCCDIKChainStorage */
+	struct FLegacyCharacter
+	{
+		std::vector<std::vector<FLegacyChainLink>> IKChainList;
+		std::vector<std::vector<float>> RotationLimits;
+		FBenchPose Pose;
+	};
+
+	/** Chains of one character in FCCDIKChainStorage's layout */
+	struct FSoACharacter
+	{
+		std::vector<int32_t> FirstLinks;
+		std::vector<int32_t> BoneIndices;
+		std::vector<int32_t> ZeroLengthChildOffsets;
+		std::vector<int32_t> ZeroLengthChildren;
+
+		/** PosX, PosY, PosZ, RotX, RotY, RotZ, RotW, AngleDelta and RotationLimits, one plane after the other */
+		std::vector<float> Planes;
+		std::vector<FChainView> Views;
+
+		FBenchPose Pose;
+	};
+
+	/**
+	*	Legacy chains are built one chain of every character at a time, the way a level streaming characters in over
+	*	many frames leaves them interleaved with everything else on the heap
+	*/
+	void BuildLegacyCharacters(const FBenchRig& Rig, std::vector<std::unique_ptr<FLegacyCharacter>>& Characters)
+	{
+		for (std::unique_ptr<FLegacyCharacter>& Character : Characters)
+		{
+			Character->IKChainList.resize(Rig.Chains.size());
+			Character->RotationLimits.resize(Rig.Chains.size());
+		}
+
+		for (size_t ChainIndex = 0; ChainIndex < Rig.Chains.size(); ChainIndex++)
+		{
+			const std::vector<int32_t>& Bones = Rig.Chains[ChainIndex];
+			for (std::unique_ptr<FLegacyCharacter>& Character : Characters)
+			{
+				std::vector<FLegacyChainLink>& Chain = Character->IKChainList[ChainIndex];
+				Chain.resize(Bones.size());
+				for (size_t Link = 0; Link < Bones.size(); Link++)
+				{
+					Chain[Link].TransformIndex = Bones[Link];
+					for (const std::pair<int32_t, int32_t>& ZeroLengthBone : Rig.ZeroLengthBones)
+					{
+						if (ZeroLengthBone.second == Bones[Link])
+						{
+							Chain[Link].ChildZeroLengthTransformIndices.push_back(ZeroLengthBone.first);
+						}
+					}
+				}
+				Character->RotationLimits[ChainIndex].assign(Bones.size(), 3.14159265f);
+			}
+		}
+	}
+
+	void BuildSoACharacter(const FBenchRig& Rig, FSoACharacter& Character)
+	{
+		for (const std::vector<int32_t>& Bones : Rig.Chains)
+		{
+			Character.FirstLinks.push_back(int32_t(Character.BoneIndices.size()));
+			for (int32_t Bone : Bones)
+			{
+				Character.ZeroLengthChildOffsets.push_back(int32_t(Character.ZeroLengthChildren.size()));
+				Character.BoneIndices.push_back(Bone);
+				for (const std::pair<int32_t, int32_t>& ZeroLengthBone : Rig.ZeroLengthBones)
+				{
+					if (ZeroLengthBone.second == Bone)
+					{
+						Character.ZeroLengthChildren.push_back(ZeroLengthBone.first);
+					}
+				}
+			}
+		}
+		Character.ZeroLengthChildOffsets.push_back(int32_t(Character.ZeroLengthChildren.size()));
+
+		const int32_t TotalLinks = int32_t(Character.BoneIndices.size());
+		Character.Planes.assign(size_t(TotalLinks) * 9, 0.f);
+		std::fill(Character.Planes.begin() + size_t(TotalLinks) * 8, Character.Planes.end(), 3.14159265f);
+		for (size_t ChainIndex = 0; ChainIndex < Rig.Chains.size(); ChainIndex++)
+		{
+			float* Plane = Character.Planes.data() + Character.FirstLinks[ChainIndex];
+			FChainView View;
+			View.PosX = Plane;
+			View.PosY = Plane + TotalLinks;
+			View.PosZ = Plane + TotalLinks * 2;
+			View.RotX = Plane + TotalLinks * 3;
+			View.RotY = Plane + TotalLinks * 4;
+			View.RotZ = Plane + TotalLinks * 5;
+			View.RotW = Plane + TotalLinks * 6;
+			View.AngleDelta = Plane + TotalLinks * 7;
+			View.RotationLimits = Plane + TotalLinks * 8;
+			View.NumLinks = int32_t(Rig.Chains[ChainIndex].size());
+			Character.Views.push_back(View);
+		}
+	}
+
+	/** Refresh, gather, solve, scatter and write back, as FAnimNode_CCDIK did before FCCDIKChainStorage */
+	void EvaluateLegacy(FLegacyCharacter& Character, int32_t Frame, FTestChain& Scratch)
+	{
+		const FSolveSettings Settings = GetSettings();
+		for (size_t ChainIndex = 0; ChainIndex < Character.IKChainList.size(); ChainIndex++)
+		{
+			std::vector<FLegacyChainLink>& Chain = Character.IKChainList[ChainIndex];
+			const int32_t NumLinks = int32_t(Chain.size());
+			for (FLegacyChainLink& Link : Chain)
+			{
+				Link.Transform = Character.Pose.Input[Link.TransformIndex];
+				Link.CurrentAngleDelta = 0.f;
+			}
+
+			Scratch.Resize(NumLinks);
+			for (int32_t Link = 0; Link < NumLinks; Link++)
+			{
+				const FBenchTransform& Transform = Chain[Link].Transform;
+				Scratch.PosX[Link] = Transform.Translation[0];
+				Scratch.PosY[Link] = Transform.Translation[1];
+				Scratch.PosZ[Link] = Transform.Translation[2];
+				Scratch.RotX[Link] = Transform.Rotation[0];
+				Scratch.RotY[Link] = Transform.Rotation[1];
+				Scratch.RotZ[Link] = Transform.Rotation[2];
+				Scratch.RotW[Link] = Transform.Rotation[3];
+				Scratch.RotationLimits[Link] = Character.RotationLimits[ChainIndex][Link];
+			}
+
+			float Target[3];
+			GetTarget(Character.Pose, Chain.back().TransformIndex, Frame, Target);
+			SolveChain(Scratch.GetView(), Target, Settings);
+
+			for (int32_t Link = 0; Link < NumLinks; Link++)
+			{
+				FBenchTransform& Transform = Chain[Link].Transform;
+				Transform.Translation[0] = Scratch.PosX[Link];
+				Transform.Translation[1] = Scratch.PosY[Link];
+				Transform.Translation[2] = Scratch.PosZ[Link];
+				Transform.Rotation[0] = Scratch.RotX[Link];
+				Transform.Rotation[1] = Scratch.RotY[Link];
+				Transform.Rotation[2] = Scratch.RotZ[Link];
+				Transform.Rotation[3] = Scratch.RotW[Link];
+				Chain[Link].CurrentAngleDelta = Scratch.AngleDelta[Link];
+			}
+
+			for (int32_t Link = 1; Link < NumLinks; Link++)
+			{
+				Character.Pose.Output[Chain[Link].TransformIndex] = Chain[Link].Transform;
+				for (int32_t Child : Chain[Link].ChildZeroLengthTransformIndices)
+				{
+					Character.Pose.Output[Child] = Chain[Link].Transform;
+				}
+			}
+		}
+	}
+
+	/** Refresh into the solver planes, solve in place and write back, as FAnimNode_CCDIK does now */
+	void EvaluateSoA(FSoACharacter& Character, int32_t Frame)
+	{
+		const FSolveSettings Settings = GetSettings();
+		const int32_t TotalLinks = int32_t(Character.BoneIndices.size());
+		float* const PosX = Character.Planes.data();
+		float* const AngleDelta = PosX + TotalLinks * 7;
+		for (int32_t Link = 0; Link < TotalLinks; Link++)
+		{
+			const FBenchTransform& Transform = Character.Pose.Input[Character.BoneIndices[Link]];
+			for (int32_t Component = 0; Component < 3; Component++)
+			{
+				PosX[Link + TotalLinks * Component] = Transform.Translation[Component];
+			}
+			for (int32_t Component = 0; Component < 4; Component++)
+			{
+				PosX[Link + TotalLinks * (3 + Component)] = Transform.Rotation[Component];
+			}
+			AngleDelta[Link] = 0.f;
+		}
+
+		for (size_t ChainIndex = 0; ChainIndex < Character.Views.size(); ChainIndex++)
+		{
+			const FChainView& View = Character.Views[ChainIndex];
+			float Target[3];
+			GetTarget(Character.Pose, Character.BoneIndices[Character.FirstLinks[ChainIndex] + View.NumLinks - 1], Frame, Target);
+			SolveChain(View, Target, Settings);
+		}
+
+		for (size_t ChainIndex = 0; ChainIndex < Character.Views.size(); ChainIndex++)
+		{
+			const int32_t FirstLink = Character.FirstLinks[ChainIndex];
+			for (int32_t Link = FirstLink + 1; Link < FirstLink + Character.Views[ChainIndex].NumLinks; Link++)
+			{
+				FBenchTransform Transform;
+				for (int32_t Component = 0; Component < 3; Component++)
+				{
+					Transform.Translation[Component] = PosX[Link + TotalLinks * Component];
+				}
+				for (int32_t Component = 0; Component < 4; Component++)
+				{
+					Transform.Rotation[Component] = PosX[Link + TotalLinks * (3 + Component)];
+				}
+
+				Character.Pose.Output[Character.BoneIndices[Link]] = Transform;
+				for (int32_t Child = Character.ZeroLengthChildOffsets[Link]; Child < Character.ZeroLengthChildOffsets[Link + 1]; Child++)
+				{
+					Character.Pose.Output[Character.ZeroLengthChildren[Child]] = Transform;
+				}
+			}
+		}
+	}
+
+	/** Last level cache misses of this thread, -1 where perf events are not available */
+	class FCacheMissCounter
+	{
+	public:
+		FCacheMissCounter()
+		{
+#if defined(__linux__)
+			perf_event_attr Attributes;
+			std::memset(&Attributes, 0, sizeof(Attributes));
+			Attributes.type = PERF_TYPE_HARDWARE;
+			Attributes.size = sizeof(Attributes);
+			Attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+			Attributes.disabled = 1;
+			Attributes.exclude_kernel = 1;
+			Attributes.exclude_hv = 1;
+			FileDescriptor = int(syscall(__NR_perf_event_open, &Attributes, 0, -1, -1, 0));
+#endif
+		}
+
+		~FCacheMissCounter()
+		{
+#if defined(__linux__)
+			if (FileDescriptor >= 0)
+			{
+				close(FileDescriptor);
+			}
+#endif
+		}
+
+		void Start()
+		{
+#if defined(__linux__)
+			if (FileDescriptor >= 0)
+			{
+				ioctl(FileDescriptor, PERF_EVENT_IOC_RESET, 0);
+				ioctl(FileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		int64_t Stop()
+		{
+#if defined(__linux__)
+			int64_t Count = 0;
+			if (FileDescriptor >= 0)
+			{
+				ioctl(FileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+				if (read(FileDescriptor, &Count, sizeof(Count)) == sizeof(Count))
+				{
+					return Count;
+				}
+			}
+#endif
+			return -1;
+		}
+
+	private:
+		int FileDescriptor = -1;
+	};
+
+	/** Checksum of every written bone, printed so the work cannot be optimized out */
+	template<typename CharacterType>
+	float SumOutput(const std::vector<std::unique_ptr<CharacterType>>& Characters)
+	{
+		float Sum = 0.f;
+		for (const std::unique_ptr<CharacterType>& Character : Characters)
+		{
+			for (const FBenchTransform& Transform : Character->Pose.Output)
+			{
+				Sum += Transform.Translation[0] + Transform.Translation[1] + Transform.Translation[2];
+			}
+		}
+		return Sum;
+	}
+
+	template<typename CharacterType, typename EvaluateType>
+	void Run(const char* Name, std::vector<std::unique_ptr<CharacterType>>& Characters, int32_t NumFrames, EvaluateType&& Evaluate)
+	{
+		// One untimed frame so both layouts start from a warmed up allocator and branch predictor
+		for (std::unique_ptr<CharacterType>& Character : Characters)
+		{
+			Evaluate(*Character, 0);
+		}
+
+		FCacheMissCounter CacheMisses;
+		CacheMisses.Start();
+		const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		for (int32_t Frame = 1; Frame <= NumFrames; Frame++)
+		{
+			for (std::unique_ptr<CharacterType>& Character : Characters)
+			{
+				Evaluate(*Character, Frame);
+			}
+		}
+		const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		const int64_t Misses = CacheMisses.Stop();
+
+		const double Evaluations = double(NumFrames) * double(Characters.size());
+		std::printf("%-8s %10.1f ns/character", Name, Seconds * 1.e9 / Evaluations);
+		if (Misses >= 0)
+		{
+			std::printf(" %10.1f cache misses/character", double(Misses) / Evaluations);
+		}
+		else
+		{
+			std::printf("      cache misses n/a");
+		}
+		std::printf("   (checksum %g)\n", SumOutput(Characters));
+	}
+}
+
+int main(int ArgC, char** ArgV)
+{
+	const bool bQuick = ArgC > 1 && std::strcmp(ArgV[1], "--quick") == 0;
+	const int32_t NumCharacters = bQuick ? 64 : 4096;
+	const int32_t NumFrames = bQuick ? 2 : 30;
+
+	const FBenchRig Rig;
+	int32_t TotalLinks = 0;
+	for (const std::vector<int32_t>& Chain : Rig.Chains)
+	{
+		TotalLinks += int32_t(Chain.size());
+	}
+	std::printf("%d characters of %d bones, %d chains, %d links, %d frames\n", NumCharacters, Rig.GetNumBones(), int32_t(Rig.Chains.size()), TotalLinks, NumFrames);
+
+	std::mt19937 Random(0x43434449);
+	std::vector<std::unique_ptr<FLegacyCharacter>> LegacyCharacters(NumCharacters);
+	std::vector<std::unique_ptr<FSoACharacter>> SoACharacters(NumCharacters);
+	for (int32_t CharacterIndex = 0; CharacterIndex < NumCharacters; CharacterIndex++)
+	{
+		LegacyCharacters[CharacterIndex].reset(new FLegacyCharacter);
+		MakePose(Rig, Random, LegacyCharacters[CharacterIndex]->Pose);
+
+		SoACharacters[CharacterIndex].reset(new FSoACharacter);
+		SoACharacters[CharacterIndex]->Pose = LegacyCharacters[CharacterIndex]->Pose;
+		BuildSoACharacter(Rig, *SoACharacters[CharacterIndex]);
+	}
+	BuildLegacyCharacters(Rig, LegacyCharacters);
+
+	FTestChain Scratch;
+	for (const int32_t Iterations : { 10, 0 })
+	{
+		MaxIterations = Iterations;
+		std::printf("MaxIterations %d\n", MaxIterations);
+		Run("Legacy", LegacyCharacters, NumFrames, [&Scratch](FLegacyCharacter& Character, int32_t Frame) { EvaluateLegacy(Character, Frame, Scratch); });
+		Run("SoA", SoACharacters, NumFrames, [](FSoACharacter& Character, int32_t Frame) { EvaluateSoA(Character, Frame); });
+	}
+	return 0;
+}
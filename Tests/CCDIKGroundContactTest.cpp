@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "BoneControllers/AnimNode_CCDIK.h"
+#include "BoneControllers/CCDIKContact.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCCDIKGroundContactTest, "System.Animation.CCDIK.GroundContact", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+*	Contact stage of FAnimNode_CCDIK against a flat ground 20 units above the component origin. A ground contact effector
+*	keeps its animated target until the ray cast below it is answered a frame later, then rises onto the ground. Effectors
+*	whose ray misses the ground and chains without ground contact are never moved.
+*/
+bool FCCDIKGroundContactTest::RunTest(const FString& Parameters)
+{
+	const float GroundHeight = 20.f;
+	TSharedPtr<FCCDIKFlatGroundContactWorld> ContactWorld = MakeShared<FCCDIKFlatGroundContactWorld>(FVector(0.f, 0.f, GroundHeight));
+
+	// Three chains without LOD tables, only the contact stage's inputs are set up
+	FAnimNode_CCDIK Node;
+	Node.bEnableGroundContact = true;
+	Node.ContactTraceUp = 50.f;
+	Node.ContactTraceDown = 75.f;
+	Node.ContactOffset = 0.f;
+	Node.SetContactWorld(ContactWorld);
+
+	const int32 NumChains = 3;
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		Node.m_IKChains.AddChain(2);
+	}
+	Node.m_IKChains.Finalize();
+	Node.m_IKChainEffectorIndex = { 0, 1, 0 };
+	Node.m_IKChainGroundContact = { true, true, false };
+	Node.m_CurrentIKLOD = INDEX_NONE;
+
+	// Chain 0 stands on the ground, chain 1 is lifted so high its ray ends above the ground, chain 2 never casts
+	const FVector AnimatedTargets[NumChains] = { FVector(10.f, 5.f, 2.f), FVector(-10.f, 5.f, 200.f), FVector(30.f, 0.f, 2.f) };
+	const FVector ExpectedTargets[NumChains] = { FVector(10.f, 5.f, 2.f + GroundHeight), AnimatedTargets[1], AnimatedTargets[2] };
+	const int32 NumEffectors = 2;
+
+	FVector Targets[NumChains];
+	auto RunFrame = [&Node, &ContactWorld, &Targets, &AnimatedTargets, NumEffectors]()
+	{
+		// PreUpdate on the game thread, then evaluation
+		ContactWorld->AdvanceFrame();
+		Node.UpdateGroundContacts();
+		FMemory::Memcpy(Targets, AnimatedTargets, sizeof(Targets));
+		Node.ApplyGroundContacts(FTransform::Identity, Targets, NumEffectors);
+	};
+
+	// The first evaluation publishes where to cast, the next PreUpdate casts below those effectors. Nothing is known about the ground yet.
+	RunFrame();
+	RunFrame();
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		TestEqual(FString::Printf(TEXT("Chain %d before its ray is answered"), iChain), Targets[iChain], AnimatedTargets[iChain]);
+	}
+	TestEqual(TEXT("Rays cast"), Node.m_GameThreadSnapshot.ContactRays, 2);
+
+	// A frame later the ground is known
+	RunFrame();
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		TestEqual(FString::Printf(TEXT("Chain %d once its ray is answered"), iChain), Targets[iChain], ExpectedTargets[iChain]);
+	}
+
+	// Effectors standing still reuse their hits instead of casting again
+	RunFrame();
+	TestEqual(TEXT("Rays cast while standing still"), Node.m_GameThreadSnapshot.ContactRays, 0);
+	for (int32 iChain = 0; iChain < NumChains; iChain++)
+	{
+		TestEqual(FString::Printf(TEXT("Chain %d while standing still"), iChain), Targets[iChain], ExpectedTargets[iChain]);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
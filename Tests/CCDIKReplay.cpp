@@ -0,0 +1,673 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/**
+*	Standalone replay of .ccdik solve captures, the engine independent counterpart of a.CCDIK.Capture.Replay.
+*
+*	Reads the capture format FCCDIKCapture writes (version 3), solves every recorded chain through the same
+*	CCDIKSolverCore kernels FAnimNode_CCDIK picks, and prints per character ns/solve, iterations, tip error and the
+*	CRC of every solved pose, which matches FCrc::MemCrc32. With --expected the results are checked against a text
+*	file written by --write-expected: solve counts and hashes of deterministic characters must match exactly, iterations
+*	and tip errors within a small tolerance. --write-sample writes the synthetic capture Tests/Data holds.
+*
+*	Usage: CCDIKReplay <Capture.ccdik> [--repeats N] [--backend 0|1|2] [--expected File] [--write-expected File]
+*	       CCDIKReplay --write-sample <Capture.ccdik>
+*/
+
+#include "BoneControllers/CCDIKSolverCore.h"
+#include "CCDIKTestChains.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CCDIKSolverCore;
+
+namespace
+{
+	const uint32_t CaptureMagic = 0x43444343; // 'CCDC'
+	const int32_t FileVersion = 3;
+
+	/** Floats per link of the recorded pose: PosX, PosY, PosZ, RotX, RotY, RotZ, RotW, then the rotation limit */
+	const int32_t FloatsPerLink = 8;
+
+	const int32_t FloatsPerJointLimit = int32_t(sizeof(FJointLimit) / sizeof(float));
+	static_assert(sizeof(FJointLimit) % sizeof(float) == 0, "Joint limits are stored as floats");
+
+	/** Mirrors FCCDIKCapturedSolve */
+	struct FCapturedSolve
+	{
+		int32_t CharacterIndex = 0;
+		uint32_t Frame = 0;
+		int32_t NumLinks = 0;
+		int32_t DataOffset = 0;
+		bool bHasJointLimits = false;
+		float Target[3] = { 0.f, 0.f, 0.f };
+		FSolveSettings Settings;
+	};
+
+	/** Mirrors FCCDIKCapture */
+	struct FCapture
+	{
+		std::vector<std::string> Characters;
+		std::vector<FCapturedSolve> Solves;
+		std::vector<float> Data;
+	};
+
+	/** Little endian FArchive layout: bools as 32 bits, strings with their length including the terminator, bulk arrays with their element size first */
+	class FArchiveReader
+	{
+	public:
+		explicit FArchiveReader(std::vector<uint8_t>&& InBytes)
+			: Bytes(std::move(InBytes))
+		{
+		}
+
+		bool IsError() const { return bError; }
+
+		void Serialize(void* Out, size_t Size)
+		{
+			if (bError || Offset + Size > Bytes.size())
+			{
+				bError = true;
+				std::memset(Out, 0, Size);
+				return;
+			}
+			std::memcpy(Out, Bytes.data() + Offset, Size);
+			Offset += Size;
+		}
+
+		template<typename T>
+		T Read()
+		{
+			T Value;
+			Serialize(&Value, sizeof(Value));
+			return Value;
+		}
+
+		bool ReadBool()
+		{
+			return Read<uint32_t>() != 0;
+		}
+
+		std::string ReadString()
+		{
+			const int32_t SaveNum = Read<int32_t>();
+			std::string Result;
+			if (SaveNum > 0)
+			{
+				Result.resize(size_t(SaveNum));
+				Serialize(&Result[0], size_t(SaveNum));
+				Result.resize(size_t(SaveNum) - 1);
+			}
+			else if (SaveNum < 0)
+			{
+				// UTF-16, only ASCII is kept
+				for (int32_t Index = 0; Index < -SaveNum; Index++)
+				{
+					const uint16_t Char = Read<uint16_t>();
+					if (Char != 0)
+					{
+						Result.push_back(Char < 128 ? char(Char) : '?');
+					}
+				}
+			}
+			return Result;
+		}
+
+	private:
+		std::vector<uint8_t> Bytes;
+		size_t Offset = 0;
+		bool bError = false;
+	};
+
+	class FArchiveWriter
+	{
+	public:
+		std::vector<uint8_t> Bytes;
+
+		void Serialize(const void* Data, size_t Size)
+		{
+			Bytes.insert(Bytes.end(), static_cast<const uint8_t*>(Data), static_cast<const uint8_t*>(Data) + Size);
+		}
+
+		template<typename T>
+		void Write(T Value)
+		{
+			Serialize(&Value, sizeof(Value));
+		}
+
+		void WriteBool(bool bValue)
+		{
+			Write<uint32_t>(bValue ? 1u : 0u);
+		}
+
+		void WriteString(const std::string& Value)
+		{
+			if (Value.empty())
+			{
+				Write<int32_t>(0);
+				return;
+			}
+			Write<int32_t>(int32_t(Value.size() + 1));
+			Serialize(Value.c_str(), Value.size() + 1);
+		}
+	};
+
+	bool ReadFile(const char* Filename, std::vector<uint8_t>& OutBytes)
+	{
+		FILE* File = std::fopen(Filename, "rb");
+		if (!File)
+		{
+			return false;
+		}
+
+		uint8_t Buffer[65536];
+		size_t Read = 0;
+		while ((Read = std::fread(Buffer, 1, sizeof(Buffer), File)) > 0)
+		{
+			OutBytes.insert(OutBytes.end(), Buffer, Buffer + Read);
+		}
+		std::fclose(File);
+		return true;
+	}
+
+	bool WriteFile(const char* Filename, const void* Data, size_t Size)
+	{
+		FILE* File = std::fopen(Filename, "wb");
+		if (!File)
+		{
+			return false;
+		}
+		const bool bWritten = std::fwrite(Data, 1, Size, File) == Size;
+		return std::fclose(File) == 0 && bWritten;
+	}
+
+	/** Same layout as operator<<(FArchive&, FCCDIKCapture&) behind the file magic and version */
+	bool LoadCapture(const char* Filename, FCapture& OutCapture)
+	{
+		std::vector<uint8_t> Bytes;
+		if (!ReadFile(Filename, Bytes))
+		{
+			std::fprintf(stderr, "Could not read %s\n", Filename);
+			return false;
+		}
+
+		FArchiveReader Reader(std::move(Bytes));
+		const uint32_t Magic = Reader.Read<uint32_t>();
+		const int32_t Version = Reader.Read<int32_t>();
+		if (Magic != CaptureMagic || Version != FileVersion)
+		{
+			std::fprintf(stderr, "%s is not a version %d capture file\n", Filename, FileVersion);
+			return false;
+		}
+
+		const int32_t NumCharacters = Reader.Read<int32_t>();
+		for (int32_t Index = 0; Index < NumCharacters && !Reader.IsError(); Index++)
+		{
+			OutCapture.Characters.push_back(Reader.ReadString());
+		}
+
+		const int32_t NumSolves = Reader.Read<int32_t>();
+		for (int32_t Index = 0; Index < NumSolves && !Reader.IsError(); Index++)
+		{
+			FCapturedSolve Solve;
+			Solve.CharacterIndex = Reader.Read<int32_t>();
+			Solve.Frame = Reader.Read<uint32_t>();
+			Solve.NumLinks = Reader.Read<int32_t>();
+			Solve.DataOffset = Reader.Read<int32_t>();
+			Solve.bHasJointLimits = Reader.ReadBool();
+			Solve.Target[0] = Reader.Read<float>();
+			Solve.Target[1] = Reader.Read<float>();
+			Solve.Target[2] = Reader.Read<float>();
+			Solve.Settings.Precision = Reader.Read<float>();
+			Solve.Settings.MaxIterations = Reader.Read<int32_t>();
+			Solve.Settings.bStartFromTail = Reader.ReadBool();
+			Solve.Settings.bEnableRotationLimit = Reader.ReadBool();
+			const uint8_t Backend = Reader.Read<uint8_t>();
+			Solve.Settings.Backend = ESolverBackend(Backend < uint8_t(ESolverBackend::Num) ? Backend : uint8_t(ESolverBackend::Num) - 1);
+			Solve.Settings.Damping = Reader.Read<float>();
+			Solve.Settings.bDeterministic = Reader.ReadBool();
+			OutCapture.Solves.push_back(Solve);
+		}
+
+		const int32_t ElementSize = Reader.Read<int32_t>();
+		const int32_t NumFloats = Reader.Read<int32_t>();
+		if (ElementSize != int32_t(sizeof(float)) || NumFloats < 0)
+		{
+			std::fprintf(stderr, "%s has a corrupt float block\n", Filename);
+			return false;
+		}
+		OutCapture.Data.resize(size_t(NumFloats));
+		Reader.Serialize(OutCapture.Data.data(), OutCapture.Data.size() * sizeof(float));
+		if (Reader.IsError())
+		{
+			std::fprintf(stderr, "%s is truncated\n", Filename);
+			return false;
+		}
+
+		// Everything the replay dereferences has to be in range, captures come from disk
+		for (const FCapturedSolve& Solve : OutCapture.Solves)
+		{
+			const int64_t NumSolveFloats = int64_t(Solve.NumLinks) * (FloatsPerLink + (Solve.bHasJointLimits ? FloatsPerJointLimit : 0));
+			if (Solve.CharacterIndex < 0 || Solve.CharacterIndex >= int32_t(OutCapture.Characters.size())
+				|| Solve.NumLinks <= 0 || Solve.DataOffset < 0 || int64_t(Solve.DataOffset) + NumSolveFloats > int64_t(OutCapture.Data.size()))
+			{
+				std::fprintf(stderr, "%s has a solve out of range\n", Filename);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool SaveCapture(const char* Filename, const FCapture& Capture)
+	{
+		FArchiveWriter Writer;
+		Writer.Write<uint32_t>(CaptureMagic);
+		Writer.Write<int32_t>(FileVersion);
+
+		Writer.Write<int32_t>(int32_t(Capture.Characters.size()));
+		for (const std::string& Character : Capture.Characters)
+		{
+			Writer.WriteString(Character);
+		}
+
+		Writer.Write<int32_t>(int32_t(Capture.Solves.size()));
+		for (const FCapturedSolve& Solve : Capture.Solves)
+		{
+			Writer.Write<int32_t>(Solve.CharacterIndex);
+			Writer.Write<uint32_t>(Solve.Frame);
+			Writer.Write<int32_t>(Solve.NumLinks);
+			Writer.Write<int32_t>(Solve.DataOffset);
+			Writer.WriteBool(Solve.bHasJointLimits);
+			Writer.Write<float>(Solve.Target[0]);
+			Writer.Write<float>(Solve.Target[1]);
+			Writer.Write<float>(Solve.Target[2]);
+			Writer.Write<float>(Solve.Settings.Precision);
+			Writer.Write<int32_t>(Solve.Settings.MaxIterations);
+			Writer.WriteBool(Solve.Settings.bStartFromTail);
+			Writer.WriteBool(Solve.Settings.bEnableRotationLimit);
+			Writer.Write<uint8_t>(uint8_t(Solve.Settings.Backend));
+			Writer.Write<float>(Solve.Settings.Damping);
+			Writer.WriteBool(Solve.Settings.bDeterministic);
+		}
+
+		Writer.Write<int32_t>(int32_t(sizeof(float)));
+		Writer.Write<int32_t>(int32_t(Capture.Data.size()));
+		Writer.Serialize(Capture.Data.data(), Capture.Data.size() * sizeof(float));
+		return WriteFile(Filename, Writer.Bytes.data(), Writer.Bytes.size());
+	}
+
+	/** zlib's CRC-32, which is what FCrc::MemCrc32 computes */
+	uint32_t MemCrc32(const void* Data, size_t Length, uint32_t Crc)
+	{
+		static uint32_t Table[256];
+		static bool bTableBuilt = false;
+		if (!bTableBuilt)
+		{
+			for (uint32_t Index = 0; Index < 256; Index++)
+			{
+				uint32_t Value = Index;
+				for (int32_t Bit = 0; Bit < 8; Bit++)
+				{
+					Value = (Value & 1) ? (Value >> 1) ^ 0xEDB88320u : Value >> 1;
+				}
+				Table[Index] = Value;
+			}
+			bTableBuilt = true;
+		}
+
+		Crc = ~Crc;
+		const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+		for (size_t Index = 0; Index < Length; Index++)
+		{
+			Crc = Table[(Crc ^ Bytes[Index]) & 0xFF] ^ (Crc >> 8);
+		}
+		return ~Crc;
+	}
+
+	/** Mirrors FCCDIKReplayStats */
+	struct FReplayStats
+	{
+		std::string Character;
+		int32_t Solves = 0;
+		double NanosecondsPerSolve = 0.0;
+		double IterationsPerSolve = 0.0;
+		float MeanTipError = 0.f;
+		float MaxTipError = 0.f;
+		uint32_t OutputHash = 0;
+
+		/** Every solve of the character was deterministic, so OutputHash is the same on any machine */
+		bool bDeterministic = true;
+	};
+
+	/** Same loop as FCCDIKReplayReport::Run */
+	std::vector<FReplayStats> Run(const FCapture& Capture, int32_t NumRepeats, int32_t BackendOverride)
+	{
+		const size_t NumCharacters = Capture.Characters.size();
+		std::vector<FReplayStats> Characters(NumCharacters);
+		std::vector<double> Seconds(NumCharacters, 0.0);
+		std::vector<int64_t> Iterations(NumCharacters, 0);
+		std::vector<double> TipErrors(NumCharacters, 0.0);
+
+		std::vector<float> Scratch;
+		for (const FCapturedSolve& Solve : Capture.Solves)
+		{
+			const int32_t NumLinks = Solve.NumLinks;
+			const float* SolveData = Capture.Data.data() + Solve.DataOffset;
+			Scratch.resize(size_t(NumLinks) * 8);
+
+			FChainView Chain;
+			Chain.PosX = Scratch.data();
+			Chain.PosY = Chain.PosX + NumLinks;
+			Chain.PosZ = Chain.PosY + NumLinks;
+			Chain.RotX = Chain.PosZ + NumLinks;
+			Chain.RotY = Chain.RotX + NumLinks;
+			Chain.RotZ = Chain.RotY + NumLinks;
+			Chain.RotW = Chain.RotZ + NumLinks;
+			Chain.AngleDelta = Chain.RotW + NumLinks;
+			Chain.RotationLimits = SolveData + NumLinks * 7;
+			Chain.JointLimits = Solve.bHasJointLimits ? reinterpret_cast<const FJointLimit*>(SolveData + NumLinks * FloatsPerLink) : nullptr;
+			Chain.NumLinks = NumLinks;
+
+			FSolveSettings Settings = Solve.Settings;
+			if (BackendOverride >= 0 && BackendOverride < int32_t(ESolverBackend::Num))
+			{
+				Settings.Backend = ESolverBackend(BackendOverride);
+			}
+
+			const FSolveChainFunction SolveFunction = GetSolveFunction(NumLinks, Settings);
+
+			FSolveResult Result;
+			for (int32_t Repeat = 0; Repeat < NumRepeats; Repeat++)
+			{
+				std::memcpy(Chain.PosX, SolveData, size_t(NumLinks) * 7 * sizeof(float));
+				std::memset(Chain.AngleDelta, 0, size_t(NumLinks) * sizeof(float));
+
+				const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+				Result = SolveFunction(Chain, Solve.Target, Settings);
+				Seconds[Solve.CharacterIndex] += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+			}
+
+			FReplayStats& Stats = Characters[Solve.CharacterIndex];
+			Stats.Solves++;
+			Stats.MaxTipError = std::fmax(Stats.MaxTipError, Result.TipError);
+			Stats.OutputHash = MemCrc32(Chain.PosX, size_t(NumLinks) * 7 * sizeof(float), Stats.OutputHash);
+			Stats.bDeterministic &= Settings.bDeterministic;
+			Iterations[Solve.CharacterIndex] += Result.Iterations;
+			TipErrors[Solve.CharacterIndex] += Result.TipError;
+		}
+
+		for (size_t Index = 0; Index < NumCharacters; Index++)
+		{
+			FReplayStats& Stats = Characters[Index];
+			Stats.Character = Capture.Characters[Index];
+			if (Stats.Solves > 0)
+			{
+				Stats.NanosecondsPerSolve = Seconds[Index] * 1.e9 / (double(Stats.Solves) * NumRepeats);
+				Stats.IterationsPerSolve = double(Iterations[Index]) / Stats.Solves;
+				Stats.MeanTipError = float(TipErrors[Index] / Stats.Solves);
+			}
+		}
+		return Characters;
+	}
+
+	/** One line per character, without timings so the file is the same on every machine */
+	bool WriteExpected(const char* Filename, const std::vector<FReplayStats>& Characters)
+	{
+		std::string Text = "# Character Solves IterationsPerSolve MeanTipError MaxTipError OutputHash (- unless every solve is deterministic)\n";
+		for (const FReplayStats& Stats : Characters)
+		{
+			char Line[512];
+			char Hash[16] = "-";
+			if (Stats.bDeterministic)
+			{
+				std::snprintf(Hash, sizeof(Hash), "%08x", Stats.OutputHash);
+			}
+			std::snprintf(Line, sizeof(Line), "%s %d %.4f %.6f %.6f %s\n", Stats.Character.c_str(), Stats.Solves, Stats.IterationsPerSolve, Stats.MeanTipError, Stats.MaxTipError, Hash);
+			Text += Line;
+		}
+		return WriteFile(Filename, Text.data(), Text.size());
+	}
+
+	bool CheckExpected(const char* Filename, const std::vector<FReplayStats>& Characters)
+	{
+		std::vector<uint8_t> Bytes;
+		if (!ReadFile(Filename, Bytes))
+		{
+			std::fprintf(stderr, "Could not read %s\n", Filename);
+			return false;
+		}
+		Bytes.push_back(0);
+
+		bool bPassed = true;
+		size_t NumChecked = 0;
+		const char* Cursor = reinterpret_cast<const char*>(Bytes.data());
+		while (*Cursor)
+		{
+			const char* LineEnd = std::strchr(Cursor, '\n');
+			const std::string Line(Cursor, LineEnd ? LineEnd : Cursor + std::strlen(Cursor));
+			Cursor = LineEnd ? LineEnd + 1 : Cursor + Line.size();
+			if (Line.empty() || Line[0] == '#')
+			{
+				continue;
+			}
+
+			char Character[256];
+			int32_t Solves = 0;
+			double IterationsPerSolve = 0.0, MeanTipError = 0.0, MaxTipError = 0.0;
+			char Hash[16];
+			if (std::sscanf(Line.c_str(), "%255s %d %lf %lf %lf %15s", Character, &Solves, &IterationsPerSolve, &MeanTipError, &MaxTipError, Hash) != 6)
+			{
+				std::printf("FAILED: cannot parse \"%s\"\n", Line.c_str());
+				bPassed = false;
+				continue;
+			}
+
+			const FReplayStats* Stats = nullptr;
+			for (const FReplayStats& Candidate : Characters)
+			{
+				Stats = Candidate.Character == Character ? &Candidate : Stats;
+			}
+			if (!Stats)
+			{
+				std::printf("FAILED: %s is not in the capture\n", Character);
+				bPassed = false;
+				continue;
+			}
+			NumChecked++;
+
+			// Non deterministic solves may round differently per build, their averages only have to stay close
+			auto Near = [](double Value, double Expected) { return std::fabs(Value - Expected) <= 1.e-3 + 1.e-2 * std::fabs(Expected); };
+			const bool bHashMatches = std::strcmp(Hash, "-") == 0 || std::strtoul(Hash, nullptr, 16) == Stats->OutputHash;
+			if (Stats->Solves != Solves || !Near(Stats->IterationsPerSolve, IterationsPerSolve) || !Near(Stats->MeanTipError, MeanTipError) || !Near(Stats->MaxTipError, MaxTipError) || !bHashMatches)
+			{
+				std::printf("FAILED: %s expected %d solves, %.4f iterations/solve, tip error mean %.6f max %.6f, output %s\n", Character, Solves, IterationsPerSolve, MeanTipError, MaxTipError, Hash);
+				bPassed = false;
+			}
+		}
+
+		if (NumChecked != Characters.size())
+		{
+			std::printf("FAILED: %s covers %d of %d characters\n", Filename, int32_t(NumChecked), int32_t(Characters.size()));
+			bPassed = false;
+		}
+		return bPassed;
+	}
+
+	/** Append one solve the way FCCDIKCapture::AddSolve records it */
+	void AddSolve(FCapture& Capture, int32_t CharacterIndex, uint32_t Frame, CCDIKTest::FTestChain& Chain, const float Target[3], const FSolveSettings& Settings)
+	{
+		FCapturedSolve Solve;
+		Solve.CharacterIndex = CharacterIndex;
+		Solve.Frame = Frame;
+		Solve.NumLinks = Chain.Num();
+		Solve.DataOffset = int32_t(Capture.Data.size());
+		Solve.bHasJointLimits = !Chain.JointLimits.empty();
+		std::memcpy(Solve.Target, Target, sizeof(Solve.Target));
+		Solve.Settings = Settings;
+		Capture.Solves.push_back(Solve);
+
+		for (const std::vector<float>* Plane : { &Chain.PosX, &Chain.PosY, &Chain.PosZ, &Chain.RotX, &Chain.RotY, &Chain.RotZ, &Chain.RotW, &Chain.RotationLimits })
+		{
+			Capture.Data.insert(Capture.Data.end(), Plane->begin(), Plane->end());
+		}
+		if (Solve.bHasJointLimits)
+		{
+			const float* Limits = reinterpret_cast<const float*>(Chain.JointLimits.data());
+			Capture.Data.insert(Capture.Data.end(), Limits, Limits + Chain.Num() * FloatsPerJointLimit);
+		}
+	}
+
+	/**
+	*	Small synthetic capture standing in for one recorded in the editor: a biped stepping with two CCD legs and a
+	*	joint limited FABRIK arm reaching around, both deterministic, and a non deterministic damped least squares tail
+	*	swaying. Chains keep their random rest pose, effectors follow smooth tracks around the rest pose tips.
+	*/
+	FCapture MakeSampleCapture()
+	{
+		FCapture Capture;
+		Capture.Characters = { "Synthetic_Biped", "Synthetic_Arm", "Synthetic_Tail" };
+
+		std::mt19937 Random(0x43434449);
+		CCDIKTest::FTestChain Legs[2];
+		CCDIKTest::MakeRandomChain(Random, 4, false, Legs[0]);
+		CCDIKTest::MakeRandomChain(Random, 4, false, Legs[1]);
+		CCDIKTest::FTestChain Arm;
+		CCDIKTest::MakeRandomChain(Random, 5, true, Arm);
+		CCDIKTest::FTestChain Tail;
+		CCDIKTest::MakeRandomChain(Random, 8, false, Tail);
+
+		FSolveSettings LegSettings;
+		LegSettings.Precision = 0.1f;
+		LegSettings.MaxIterations = 10;
+		LegSettings.bDeterministic = true;
+
+		FSolveSettings ArmSettings = LegSettings;
+		ArmSettings.Backend = ESolverBackend::FABRIK;
+		ArmSettings.bEnableRotationLimit = true;
+
+		FSolveSettings TailSettings;
+		TailSettings.Precision = 0.5f;
+		TailSettings.MaxIterations = 16;
+		TailSettings.Backend = ESolverBackend::DampedLeastSquares;
+		TailSettings.Damping = 4.f;
+
+		const int32_t NumFrames = 24;
+		for (int32_t Frame = 0; Frame < NumFrames; Frame++)
+		{
+			const float Phase = 6.2831853f * float(Frame) / float(NumFrames);
+			for (int32_t Side = 0; Side < 2; Side++)
+			{
+				CCDIKTest::FTestChain& Leg = Legs[Side];
+				const float Step = Phase + 3.14159265f * float(Side);
+				const float Target[3] = { Leg.PosX[3] + 15.f * std::cos(Step), Leg.PosY[3], Leg.PosZ[3] + std::fmax(0.f, 8.f * std::sin(Step)) };
+				AddSolve(Capture, 0, uint32_t(Frame), Leg, Target, LegSettings);
+			}
+
+			const float ArmTarget[3] = { Arm.PosX[4] + 20.f * std::cos(Phase), Arm.PosY[4] + 20.f * std::sin(Phase), Arm.PosZ[4] + 10.f * std::sin(2.f * Phase) };
+			AddSolve(Capture, 1, uint32_t(Frame), Arm, ArmTarget, ArmSettings);
+
+			const float TailTarget[3] = { Tail.PosX[7] + 30.f * std::sin(Phase), Tail.PosY[7] + 10.f * std::cos(Phase), Tail.PosZ[7] };
+			AddSolve(Capture, 2, uint32_t(Frame), Tail, TailTarget, TailSettings);
+		}
+		return Capture;
+	}
+}
+
+int main(int ArgC, char** ArgV)
+{
+	if (ArgC == 3 && std::strcmp(ArgV[1], "--write-sample") == 0)
+	{
+		const FCapture Capture = MakeSampleCapture();
+		if (!SaveCapture(ArgV[2], Capture))
+		{
+			std::fprintf(stderr, "Could not write %s\n", ArgV[2]);
+			return 1;
+		}
+		std::printf("%d solves of %d characters written to %s\n", int32_t(Capture.Solves.size()), int32_t(Capture.Characters.size()), ArgV[2]);
+		return 0;
+	}
+
+	const char* CaptureFile = nullptr;
+	const char* ExpectedFile = nullptr;
+	const char* WriteExpectedFile = nullptr;
+	int32_t NumRepeats = 16;
+	int32_t BackendOverride = -1;
+	for (int32_t ArgIndex = 1; ArgIndex < ArgC; ArgIndex++)
+	{
+		const bool bHasValue = ArgIndex + 1 < ArgC;
+		if (std::strcmp(ArgV[ArgIndex], "--repeats") == 0 && bHasValue)
+		{
+			NumRepeats = std::max(std::atoi(ArgV[++ArgIndex]), 1);
+		}
+		else if (std::strcmp(ArgV[ArgIndex], "--backend") == 0 && bHasValue)
+		{
+			BackendOverride = std::atoi(ArgV[++ArgIndex]);
+		}
+		else if (std::strcmp(ArgV[ArgIndex], "--expected") == 0 && bHasValue)
+		{
+			ExpectedFile = ArgV[++ArgIndex];
+		}
+		else if (std::strcmp(ArgV[ArgIndex], "--write-expected") == 0 && bHasValue)
+		{
+			WriteExpectedFile = ArgV[++ArgIndex];
+		}
+		else if (!CaptureFile && ArgV[ArgIndex][0] != '-')
+		{
+			CaptureFile = ArgV[ArgIndex];
+		}
+		else
+		{
+			CaptureFile = nullptr;
+			break;
+		}
+	}
+
+	if (!CaptureFile)
+	{
+		std::fprintf(stderr, "Usage: CCDIKReplay <Capture.ccdik> [--repeats N] [--backend 0|1|2] [--expected File] [--write-expected File]\n");
+		std::fprintf(stderr, "       CCDIKReplay --write-sample <Capture.ccdik>\n");
+		return 2;
+	}
+
+	FCapture Capture;
+	if (!LoadCapture(CaptureFile, Capture))
+	{
+		return 1;
+	}
+
+	const std::vector<FReplayStats> Characters = Run(Capture, NumRepeats, BackendOverride);
+	for (const FReplayStats& Stats : Characters)
+	{
+		std::printf("CCDIK replay %s: %d solves, %.1f ns/solve, %.2f iterations/solve, tip error mean %.3f max %.3f, output %08x%s\n",
+			Stats.Character.c_str(), Stats.Solves, Stats.NanosecondsPerSolve, Stats.IterationsPerSolve, Stats.MeanTipError, Stats.MaxTipError,
+			Stats.OutputHash, Stats.bDeterministic ? " (deterministic)" : "");
+	}
+
+	if (WriteExpectedFile && !WriteExpected(WriteExpectedFile, Characters))
+	{
+		std::fprintf(stderr, "Could not write %s\n", WriteExpectedFile);
+		return 1;
+	}
+
+	if (ExpectedFile)
+	{
+		if (BackendOverride >= 0)
+		{
+			std::fprintf(stderr, "--expected results were recorded with the captured backends, --backend does not apply\n");
+			return 2;
+		}
+		if (!CheckExpected(ExpectedFile, Characters))
+		{
+			return 1;
+		}
+		std::printf("Matches %s\n", ExpectedFile);
+	}
+	return 0;
+}
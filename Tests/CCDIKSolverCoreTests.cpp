@@ -0,0 +1,435 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/**
+*	Engine independent checks of CCDIKSolverCore: every kernel path, specialized solver and chain group must give
+*	the result of the scalar SolveChain, and deterministic solves must give the checked in output bits.
+*	Returns non zero when any check fails. Run with --print-deterministic to print new expected bits.
+*/
+
+#include "BoneControllers/CCDIKSolverCore.h"
+#include "CCDIKTestChains.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace CCDIKSolverCore;
+using namespace CCDIKTest;
+
+namespace
+{
+	/** Scalar and vector paths round differently in renormalization, chains drift apart by a few ulps per iteration */
+	constexpr float PositionTolerance = 1.e-3f;
+	constexpr float RotationTolerance = 1.e-4f;
+
+	constexpr int32_t NumRandomChains = 2000;
+
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	void Check(bool bCondition, const char* What, int32_t Case)
+	{
+		NumChecks++;
+		if (!bCondition)
+		{
+			NumFailures++;
+			if (NumFailures <= 20)
+			{
+				std::printf("FAILED: %s (case %d)\n", What, Case);
+			}
+		}
+	}
+
+	bool ChainsMatch(const FTestChain& A, const FTestChain& B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return false;
+		}
+
+		for (int32_t Link = 0; Link < A.Num(); Link++)
+		{
+			if (std::fabs(A.PosX[Link] - B.PosX[Link]) > PositionTolerance
+				|| std::fabs(A.PosY[Link] - B.PosY[Link]) > PositionTolerance
+				|| std::fabs(A.PosZ[Link] - B.PosZ[Link]) > PositionTolerance
+				|| std::fabs(A.RotX[Link] - B.RotX[Link]) > RotationTolerance
+				|| std::fabs(A.RotY[Link] - B.RotY[Link]) > RotationTolerance
+				|| std::fabs(A.RotZ[Link] - B.RotZ[Link]) > RotationTolerance
+				|| std::fabs(A.RotW[Link] - B.RotW[Link]) > RotationTolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ResultsMatch(const FSolveResult& A, const FSolveResult& B)
+	{
+		return A.Iterations == B.Iterations && A.bUpdated == B.bUpdated && std::fabs(A.TipError - B.TipError) <= PositionTolerance;
+	}
+
+	/** Random settings, with rotation limits on about half the chains and joint limits on some of those */
+	FSolveSettings MakeRandomSettings(std::mt19937& Random)
+	{
+		FSolveSettings Settings;
+		Settings.Precision = RandRange(Random, 0.01f, 1.f);
+		Settings.MaxIterations = 1 + int32_t(Random() % 20);
+		Settings.bStartFromTail = (Random() & 1) != 0;
+		Settings.bEnableRotationLimit = (Random() & 1) != 0;
+		return Settings;
+	}
+
+	void TestRotateLinks(std::mt19937& Random)
+	{
+		for (int32_t Case = 0; Case < NumRandomChains; Case++)
+		{
+			const int32_t NumLinks = 2 + int32_t(Random() % 31);
+			FTestChain Scalar;
+			MakeRandomChain(Random, NumLinks, false, Scalar);
+			FTestChain Wide = Scalar;
+
+			const int32_t FirstLink = int32_t(Random() % NumLinks);
+			const int32_t LastLink = FirstLink + int32_t(Random() % (NumLinks - FirstLink + 1));
+			const float Pivot[3] = { Scalar.PosX[FirstLink], Scalar.PosY[FirstLink], Scalar.PosZ[FirstLink] };
+			float Delta[4];
+			RandRotation(Random, 3.f, Delta);
+
+			RotateLinks(Scalar.GetView(), FirstLink, LastLink, Pivot, Delta, EKernelPath::Scalar);
+			RotateLinks(Wide.GetView(), FirstLink, LastLink, Pivot, Delta, EKernelPath::SIMD);
+			Check(ChainsMatch(Scalar, Wide), "RotateLinks SIMD matches Scalar", Case);
+		}
+	}
+
+	void TestSolveChainPaths(std::mt19937& Random)
+	{
+		for (int32_t Case = 0; Case < NumRandomChains; Case++)
+		{
+			const int32_t NumLinks = 2 + int32_t(Random() % 31);
+			const FSolveSettings Settings = MakeRandomSettings(Random);
+			FTestChain Scalar;
+			MakeRandomChain(Random, NumLinks, Settings.bEnableRotationLimit && (Random() & 1) != 0, Scalar);
+			FTestChain Wide = Scalar;
+			float Target[3];
+			MakeRandomTarget(Random, Scalar, Target);
+
+			const FSolveResult ScalarResult = SolveChain(Scalar.GetView(), Target, Settings, EKernelPath::Scalar);
+			const FSolveResult WideResult = SolveChain(Wide.GetView(), Target, Settings, EKernelPath::SIMD);
+			Check(ResultsMatch(ScalarResult, WideResult), "SolveChain SIMD result matches Scalar", Case);
+			Check(ChainsMatch(Scalar, Wide), "SolveChain SIMD pose matches Scalar", Case);
+		}
+	}
+
+	void TestSpecializedSolvers(std::mt19937& Random)
+	{
+		Check(GetSpecializedSolver(MinSpecializedLinks - 1, true, false) == nullptr, "No specialized solver below MinSpecializedLinks", 0);
+		Check(GetSpecializedSolver(MaxSpecializedLinks + 1, true, false) == nullptr, "No specialized solver above MaxSpecializedLinks", 0);
+
+		for (int32_t Case = 0; Case < NumRandomChains; Case++)
+		{
+			const int32_t NumLinks = MinSpecializedLinks + int32_t(Random() % (MaxSpecializedLinks - MinSpecializedLinks + 1));
+			const FSolveSettings Settings = MakeRandomSettings(Random);
+			const FSolveChainFunction Solver = GetSpecializedSolver(NumLinks, Settings.bStartFromTail, Settings.bEnableRotationLimit);
+			Check(Solver != nullptr, "Specialized solver exists", Case);
+			if (!Solver)
+			{
+				continue;
+			}
+
+			FTestChain Generic;
+			MakeRandomChain(Random, NumLinks, Settings.bEnableRotationLimit && (Random() & 1) != 0, Generic);
+			FTestChain Specialized = Generic;
+			float Target[3];
+			MakeRandomTarget(Random, Generic, Target);
+
+			const FSolveResult GenericResult = SolveChain(Generic.GetView(), Target, Settings);
+			const FSolveResult SpecializedResult = Solver(Specialized.GetView(), Target, Settings);
+			Check(ResultsMatch(GenericResult, SpecializedResult), "Specialized solver result matches SolveChain", Case);
+			Check(ChainsMatch(Generic, Specialized), "Specialized solver pose matches SolveChain", Case);
+		}
+	}
+
+	void TestSolveChainGroup(std::mt19937& Random)
+	{
+		std::vector<float> Scratch;
+		for (int32_t Case = 0; Case < NumRandomChains / GroupWidth; Case++)
+		{
+			// Lanes share the link count and direction, everything else differs per lane
+			const int32_t NumLinks = 2 + int32_t(Random() % 15);
+			const bool bStartFromTail = (Random() & 1) != 0;
+			const int32_t NumChains = 1 + int32_t(Random() % GroupWidth);
+
+			FTestChain Expected[GroupWidth];
+			FTestChain Grouped[GroupWidth];
+			FChainView Views[GroupWidth];
+			float Targets[GroupWidth][3];
+			FSolveSettings Settings[GroupWidth];
+			FSolveResult ExpectedResults[GroupWidth];
+			FSolveResult GroupedResults[GroupWidth];
+			for (int32_t Lane = 0; Lane < NumChains; Lane++)
+			{
+				Settings[Lane] = MakeRandomSettings(Random);
+				Settings[Lane].bStartFromTail = bStartFromTail;
+				MakeRandomChain(Random, NumLinks, Settings[Lane].bEnableRotationLimit && (Random() & 1) != 0, Expected[Lane]);
+				MakeRandomTarget(Random, Expected[Lane], Targets[Lane]);
+				Grouped[Lane] = Expected[Lane];
+				Views[Lane] = Grouped[Lane].GetView();
+				ExpectedResults[Lane] = SolveChain(Expected[Lane].GetView(), Targets[Lane], Settings[Lane]);
+			}
+
+			Scratch.assign(GetGroupScratchSize(NumLinks), 0.f);
+			SolveChainGroup(Views, Targets, Settings, GroupedResults, NumChains, Scratch.data());
+			for (int32_t Lane = 0; Lane < NumChains; Lane++)
+			{
+				Check(ResultsMatch(ExpectedResults[Lane], GroupedResults[Lane]), "SolveChainGroup result matches SolveChain", Case);
+				Check(ChainsMatch(Expected[Lane], Grouped[Lane]), "SolveChainGroup pose matches SolveChain", Case);
+			}
+		}
+	}
+
+	/** Fixed input of a deterministic solve, written out as literals so no runtime math is involved in building it */
+	struct FDeterministicCase
+	{
+		const char* Name;
+		int32_t NumLinks;
+		float Pos[5][3];
+		float Rot[5][4];
+		float Target[3];
+
+		/** Per link, also caps every single step of FABRIK and CCD when rotation limits are off */
+		float RotationLimit;
+
+		bool bStartFromTail;
+		bool bEnableRotationLimit;
+		bool bJointLimits;
+
+		/** Joint limit reference of each link, its input rotation relative to its parent's */
+		float LimitRef[5][4];
+	};
+
+	/** Half of sqrt(2), cos and sin of 22.5, 11.25 and 56.25 degrees */
+	constexpr float HalfSqrt2 = 0.70710678f;
+	constexpr float Cos22 = 0.92387953f;
+	constexpr float Sin22 = 0.38268343f;
+	constexpr float Cos11 = 0.98078528f;
+	constexpr float Sin11 = 0.19509032f;
+	constexpr float Cos56 = 0.55557023f;
+	constexpr float Sin56 = 0.83146961f;
+
+	const FDeterministicCase DeterministicCases[] =
+	{
+		{
+			"Bent arm", 4,
+			{ { 0.f, 0.f, 100.f }, { 30.f, 0.f, 100.f }, { 51.2132f, 21.2132f, 100.f }, { 51.2132f, 51.2132f, 100.f } },
+			{ { 0.f, 0.f, 0.f, 1.f }, { 0.f, 0.f, Sin22, Cos22 }, { 0.f, 0.f, HalfSqrt2, HalfSqrt2 }, { 0.f, 0.f, HalfSqrt2, HalfSqrt2 } },
+			{ 40.f, -20.f, 80.f }, 3.14159265f, true, false, false, {}
+		},
+		{
+			"Leg with rotation limits", 5,
+			{ { 0.f, 0.f, 90.f }, { 0.f, 0.f, 45.f }, { 0.f, 5.f, 2.f }, { 0.f, 17.f, 0.f }, { 0.f, 22.f, 0.f } },
+			{ { 0.f, HalfSqrt2, 0.f, HalfSqrt2 }, { 0.f, HalfSqrt2, 0.f, HalfSqrt2 }, { -Sin22, 0.f, 0.f, Cos22 }, { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 }, { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 } },
+			{ 25.f, 30.f, 15.f }, 0.5f, false, true, false, {}
+		},
+		{
+			"Spine with joint limits", 5,
+			{ { 0.f, 0.f, 100.f }, { 0.f, 0.f, 115.f }, { 0.f, 0.f, 130.f }, { 0.f, 5.74025f, 143.85819f }, { 0.f, 5.74025f, 158.85819f } },
+			{ { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 }, { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 }, { -Sin56, 0.f, 0.f, Cos56 }, { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 }, { -HalfSqrt2, 0.f, 0.f, HalfSqrt2 } },
+			{ 35.f, 40.f, 140.f }, 1.f, true, true, true,
+			{ { 0.f, 0.f, 0.f, 1.f }, { 0.f, 0.f, 0.f, 1.f }, { -Sin11, 0.f, 0.f, Cos11 }, { Sin11, 0.f, 0.f, Cos11 }, { 0.f, 0.f, 0.f, 1.f } }
+		},
+	};
+
+	const char* const BackendNames[(int32_t)ESolverBackend::Num] = { "CCD", "FABRIK", "DampedLeastSquares" };
+
+	/** Output of one deterministic solve as raw bits: iterations, tip error and every plane, link by link */
+	std::vector<uint32_t> SolveDeterministic(const FDeterministicCase& Case, ESolverBackend Backend)
+	{
+		FTestChain Chain(Case.NumLinks);
+		for (int32_t Link = 0; Link < Case.NumLinks; Link++)
+		{
+			Chain.PosX[Link] = Case.Pos[Link][0];
+			Chain.PosY[Link] = Case.Pos[Link][1];
+			Chain.PosZ[Link] = Case.Pos[Link][2];
+			Chain.RotX[Link] = Case.Rot[Link][0];
+			Chain.RotY[Link] = Case.Rot[Link][1];
+			Chain.RotZ[Link] = Case.Rot[Link][2];
+			Chain.RotW[Link] = Case.Rot[Link][3];
+			Chain.RotationLimits[Link] = Case.RotationLimit;
+		}
+
+		if (Case.bJointLimits)
+		{
+			// Each link may swing 45 degrees and twist 22.5 degrees either way from its input pose
+			Chain.JointLimits.resize(Case.NumLinks);
+			for (int32_t Link = 1; Link < Case.NumLinks; Link++)
+			{
+				std::memcpy(Chain.JointLimits[Link].RefRotation, Case.LimitRef[Link], sizeof(Case.LimitRef[Link]));
+				Chain.JointLimits[Link].CosHalfSwingLimit = Cos22;
+				Chain.JointLimits[Link].SinHalfSwingLimit = Sin22;
+				Chain.JointLimits[Link].SinHalfMinTwist = -Sin11;
+				Chain.JointLimits[Link].SinHalfMaxTwist = Sin11;
+			}
+		}
+
+		FSolveSettings Settings;
+		Settings.Precision = 0.01f;
+		Settings.MaxIterations = 12;
+		Settings.bStartFromTail = Case.bStartFromTail;
+		Settings.bEnableRotationLimit = Case.bEnableRotationLimit;
+		Settings.Backend = Backend;
+		Settings.Damping = 2.f;
+		Settings.bDeterministic = true;
+
+		const FSolveResult Result = GetSolveFunction(Case.NumLinks, Settings)(Chain.GetView(), Case.Target, Settings);
+
+		std::vector<uint32_t> Bits;
+		auto AddBits = [&Bits](float Value)
+		{
+			uint32_t ValueBits;
+			std::memcpy(&ValueBits, &Value, sizeof(ValueBits));
+			Bits.push_back(ValueBits);
+		};
+
+		Bits.push_back((uint32_t)Result.Iterations);
+		AddBits(Result.TipError);
+		for (int32_t Link = 0; Link < Case.NumLinks; Link++)
+		{
+			for (const std::vector<float>* Plane : { &Chain.PosX, &Chain.PosY, &Chain.PosZ, &Chain.RotX, &Chain.RotY, &Chain.RotZ, &Chain.RotW })
+			{
+				AddBits((*Plane)[Link]);
+			}
+		}
+		return Bits;
+	}
+
+	constexpr int32_t NumDeterministicCases = int32_t(sizeof(DeterministicCases) / sizeof(DeterministicCases[0]));
+
+	/**
+	*	Expected output bits per case and backend, see SolveDeterministic. Any change here means clients and servers built
+	*	before and after it no longer agree on deterministic solves, so only update them together with a replay version bump.
+	*/
+	const std::vector<uint32_t> ExpectedDeterministicBits[NumDeterministicCases][(int32_t)ESolverBackend::Num] =
+	{
+		// Bent arm
+		{
+			{ 0x0000000a, 0x3bd991b3,
+				0x00000000, 0x00000000, 0x42c80000, 0x00000000, 0x00000000, 0x00000000, 0x3f800000,
+				0x41f00000, 0x00000000, 0x42c80000, 0xbdc7dd49, 0x3e714217, 0x3dd7c87a, 0x3f760fdb,
+				0x42600372, 0x40964c31, 0x42ab975b, 0x3ee296ec, 0xbf33776c, 0xbf065192, 0x3e460371,
+				0x421ffe54, 0xc1a00be2, 0x429ffe93, 0x3ee296ec, 0xbf33776c, 0xbf065192, 0x3e460371 },
+			{ 0x0000000c, 0x36800000,
+				0x00000000, 0x00000000, 0x42c80000, 0x00000000, 0x00000000, 0x00000000, 0x3f800000,
+				0x41f00000, 0x00000000, 0x42c80000, 0xbdc7ce2d, 0x3e712fba, 0x3dd7f852, 0x3f761083,
+				0x4260044c, 0x40967e82, 0x42ab992c, 0xbef23810, 0x3f601356, 0x3cc7deb0, 0x3dc723c6,
+				0x42200000, 0xc19ffffe, 0x42a00000, 0xbef23810, 0x3f601356, 0x3cc7deb0, 0x3dc723c6 },
+			{ 0x00000008, 0x38bac30b,
+				0x00000000, 0x00000000, 0x42c80000, 0x00000000, 0x00000000, 0x00000000, 0x3f800000,
+				0x41f00000, 0x00000000, 0x42c80000, 0xbbb9cde8, 0xb9b03e9e, 0xbf5280c2, 0x3f11adda,
+				0x419b73f5, 0xc1e09a3e, 0x42c8951c, 0xbe5eda91, 0x3ea5704e, 0x3e6b4424, 0x3f6451fb,
+				0x421ffff2, 0xc19ffff6, 0x42a00009, 0xbe5eda91, 0x3ea5704e, 0x3e6b4424, 0x3f6451fb },
+		},
+		// Leg with rotation limits
+		{
+			{ 0x0000000c, 0x402040ae,
+				0x00000000, 0x00000000, 0x42b40000, 0x00000000, 0x3f3504f4, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42340000, 0x3e1b5d0e, 0x3f0c2737, 0x3c8c540c, 0x3f52a16d,
+				0x418f1a7c, 0x4151f590, 0x40fa77b8, 0xbe171023, 0xbddf2a6b, 0xbe888bae, 0x3f723840,
+				0x41b26768, 0x41bc8aee, 0x4143bfa4, 0xbf0fb538, 0x3cc595a2, 0xbe92fc88, 0x3f469b59,
+				0x41c0cb19, 0x41ded44f, 0x41613c53, 0xbf0fb538, 0x3cc595a2, 0xbe92fc88, 0x3f469b59 },
+			{ 0x0000000c, 0x401d89de,
+				0x00000000, 0x00000000, 0x42b40000, 0x00000000, 0x3f3504f4, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42340000, 0x3e0fe228, 0x3f134643, 0x3dead424, 0x3f4c2ed9,
+				0x4154cf49, 0x419be735, 0x410b4850, 0xbe2d8b73, 0xbd11a180, 0xbe997d2d, 0x3f702b3b,
+				0x4199e164, 0x41eb8265, 0x4146a4aa, 0xbedcfb51, 0x3e8ee60c, 0xbed13d7c, 0x3f4112d6,
+				0x41b8d4ae, 0x41fc6cf6, 0x416c5fe6, 0xbedcfb51, 0x3e8ee60c, 0xbed13d7c, 0x3f4112d6 },
+			{ 0x00000005, 0x40dfb33a,
+				0x00000000, 0x00000000, 0x42b40000, 0x00000000, 0x3f3504f4, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42340000, 0x3e06897d, 0x3f0a93e6, 0xbbae5529, 0x3f5499ce,
+				0x41946bdf, 0x41290417, 0x40eae850, 0xbd30eb42, 0xbe2affca, 0xbe3754fc, 0x3f77f677,
+				0x419f9b3a, 0x41a6727f, 0x415c1396, 0xbee7b64a, 0xbd3eb20a, 0xbe777905, 0x3f5b6aaa,
+				0x41a529f3, 0x41c660e7, 0x41857ad4, 0xbee7b64a, 0xbd3eb20a, 0xbe777905, 0x3f5b6aaa },
+		},
+		// Spine with joint limits
+		{
+			{ 0x00000003, 0x41a6a412,
+				0x00000000, 0x00000000, 0x42c80000, 0xbf3504f4, 0x00000000, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42e60000, 0xbf50600c, 0x3d45ba56, 0x3e036159, 0x3f108390,
+				0x40568084, 0x40abd749, 0x43009951, 0xbf6b7852, 0x3e31c536, 0x3e8c6cef, 0x3e61bd65,
+				0x411f4b65, 0x41901045, 0x430540ea, 0xbf4d5523, 0x3ef3b8ca, 0x3eaf0c35, 0x3deb2809,
+				0x41b4b3c4, 0x41ce8449, 0x43032253, 0xbf4d5523, 0x3ef3b8ca, 0x3eaf0c35, 0x3deb2809 },
+			{ 0x0000000c, 0x4188969e,
+				0x00000000, 0x00000000, 0x42c80000, 0xbf3504f4, 0x00000000, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42e60000, 0xbf49f86a, 0x3e862973, 0x3e344f8b, 0x3f06f3c8,
+				0x410fc96f, 0x40934e18, 0x42fc2f7f, 0xbf61d83c, 0x3e7f8e08, 0x3e7f6a31, 0x3e9fa385,
+				0x418f6608, 0x416d17d9, 0x43047a30, 0xbf61d805, 0x3e7f9062, 0x3e7f6b9e, 0x3e9fa33c,
+				0x41d6e7df, 0x41c84426, 0x430adc95, 0xbf61d805, 0x3e7f9062, 0x3e7f6b9e, 0x3e9fa33c },
+			{ 0x00000003, 0x419a262e,
+				0x00000000, 0x00000000, 0x42c80000, 0xbf3504f4, 0x00000000, 0x00000000, 0x3f3504f4,
+				0x00000000, 0x00000000, 0x42e60000, 0xbf45c9c3, 0x3e86a727, 0x3e84ed02, 0x3f042866,
+				0x4121dd72, 0x409dc177, 0x42f9d5a0, 0xbf65d16b, 0x3e4f5f6d, 0x3eb6fae0, 0x3e230c50,
+				0x418a38ca, 0x418f82ec, 0x42fe118a, 0xbf418706, 0x3eb24bfa, 0x3e8b5a20, 0x3ef73b7e,
+				0x41e8f1ef, 0x41b27252, 0x4307245a, 0xbf418706, 0x3eb24bfa, 0x3e8b5a20, 0x3ef73b7e },
+		},
+	};
+
+	void PrintDeterministicSolves()
+	{
+		std::printf("\t{\n");
+		for (int32_t CaseIndex = 0; CaseIndex < NumDeterministicCases; CaseIndex++)
+		{
+			std::printf("\t\t// %s\n\t\t{\n", DeterministicCases[CaseIndex].Name);
+			for (int32_t Backend = 0; Backend < (int32_t)ESolverBackend::Num; Backend++)
+			{
+				const std::vector<uint32_t> Bits = SolveDeterministic(DeterministicCases[CaseIndex], (ESolverBackend)Backend);
+				std::printf("\t\t\t{ ");
+				for (size_t Index = 0; Index < Bits.size(); Index++)
+				{
+					std::printf("%s0x%08x", Index == 0 ? "" : Index % 7 == 2 ? ",\n\t\t\t\t" : ", ", Bits[Index]);
+				}
+				std::printf(" },\n");
+			}
+			std::printf("\t\t},\n");
+		}
+		std::printf("\t};\n");
+	}
+
+	void TestDeterministicSolves()
+	{
+		for (int32_t CaseIndex = 0; CaseIndex < NumDeterministicCases; CaseIndex++)
+		{
+			for (int32_t Backend = 0; Backend < (int32_t)ESolverBackend::Num; Backend++)
+			{
+				const std::vector<uint32_t> Bits = SolveDeterministic(DeterministicCases[CaseIndex], (ESolverBackend)Backend);
+				const bool bMatches = Bits == ExpectedDeterministicBits[CaseIndex][Backend];
+				if (!bMatches)
+				{
+					std::printf("%s, %s: deterministic output differs from the expected bits\n", DeterministicCases[CaseIndex].Name, BackendNames[Backend]);
+				}
+				Check(bMatches, "Deterministic solve gives the expected bits", CaseIndex);
+
+				// Same input twice, same bits, whatever ran in between
+				Check(SolveDeterministic(DeterministicCases[CaseIndex], (ESolverBackend)Backend) == Bits, "Deterministic solve repeats", CaseIndex);
+			}
+		}
+	}
+}
+
+int main(int ArgC, char** ArgV)
+{
+	if (ArgC > 1 && std::strcmp(ArgV[1], "--print-deterministic") == 0)
+	{
+		PrintDeterministicSolves();
+		return 0;
+	}
+
+	std::mt19937 Random(0x43434449);
+	TestRotateLinks(Random);
+	TestSolveChainPaths(Random);
+	TestSpecializedSolvers(Random);
+	TestSolveChainGroup(Random);
+	TestDeterministicSolves();
+
+	std::printf("%d checks, %d failed\n", NumChecks, NumFailures);
+	return NumFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/**
+*	Cost of the specialized CCD kernels against the generic SolveChain, per chain length and flag combination.
+*
+*	Every solve starts from a fresh copy of a random chain, so both paths do the same iterations on the same inputs.
+*	The copy is timed on its own and taken out of the reported ns/solve. Pass --quick for a short smoke run.
+*/
+
+#include "BoneControllers/CCDIKSolverCore.h"
+#include "CCDIKTestChains.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace CCDIKSolverCore;
+using namespace CCDIKTest;
+
+namespace
+{
+	struct FBenchCase
+	{
+		std::vector<FTestChain> Inputs;
+		std::vector<float> Targets;
+	};
+
+	/** Solves run by the current measurement, so the work is not optimized out */
+	int64_t TotalIterations = 0;
+
+	/** Seconds for NumRounds passes over every input with Solve, including the copy into the working chain */
+	template<typename SolveType>
+	double Measure(const FBenchCase& Case, FTestChain& Working, int32_t NumRounds, SolveType&& Solve)
+	{
+		const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		for (int32_t Round = 0; Round < NumRounds; Round++)
+		{
+			for (size_t Index = 0; Index < Case.Inputs.size(); Index++)
+			{
+				const FTestChain& Input = Case.Inputs[Index];
+				for (int32_t Link = 0; Link < Input.Num(); Link++)
+				{
+					Working.PosX[Link] = Input.PosX[Link];
+					Working.PosY[Link] = Input.PosY[Link];
+					Working.PosZ[Link] = Input.PosZ[Link];
+					Working.RotX[Link] = Input.RotX[Link];
+					Working.RotY[Link] = Input.RotY[Link];
+					Working.RotZ[Link] = Input.RotZ[Link];
+					Working.RotW[Link] = Input.RotW[Link];
+					Working.AngleDelta[Link] = 0.f;
+				}
+				TotalIterations += Solve(Working.GetView(), &Case.Targets[Index * 3]).Iterations;
+			}
+		}
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	}
+}
+
+int main(int ArgC, char** ArgV)
+{
+	const bool bQuick = ArgC > 1 && std::strcmp(ArgV[1], "--quick") == 0;
+	const int32_t NumChains = bQuick ? 64 : 1024;
+	const int32_t NumRounds = bQuick ? 2 : 200;
+
+	std::printf("%d random chains per case, %d rounds, ns per solve\n", NumChains, NumRounds);
+	std::printf("Links  Direction  Limits   Generic  Specialized  Speedup  Iterations/solve\n");
+
+	std::mt19937 Random(0x43434449);
+	for (int32_t NumLinks = MinSpecializedLinks; NumLinks <= MaxSpecializedLinks; NumLinks++)
+	{
+		for (const bool bStartFromTail : { true, false })
+		{
+			for (const bool bEnableRotationLimit : { false, true })
+			{
+				FSolveSettings Settings;
+				Settings.Precision = 0.1f;
+				Settings.MaxIterations = 10;
+				Settings.bStartFromTail = bStartFromTail;
+				Settings.bEnableRotationLimit = bEnableRotationLimit;
+
+				FBenchCase Case;
+				Case.Inputs.resize(NumChains);
+				Case.Targets.resize(size_t(NumChains) * 3);
+				for (int32_t Index = 0; Index < NumChains; Index++)
+				{
+					MakeRandomChain(Random, NumLinks, false, Case.Inputs[Index]);
+					MakeRandomTarget(Random, Case.Inputs[Index], &Case.Targets[size_t(Index) * 3]);
+				}
+
+				FTestChain Working = Case.Inputs[0];
+				const FSolveChainFunction Specialized = GetSpecializedSolver(NumLinks, bStartFromTail, bEnableRotationLimit);
+				auto SolveGeneric = [&Settings](const FChainView& Chain, const float* Target) { return SolveChain(Chain, Target, Settings); };
+				auto SolveSpecialized = [&Settings, Specialized](const FChainView& Chain, const float* Target) { return Specialized(Chain, Target, Settings); };
+				auto CopyOnly = [](const FChainView&, const float*) { return FSolveResult(); };
+
+				// Warm up both paths once, then take the copy cost out of each measurement
+				Measure(Case, Working, 1, SolveGeneric);
+				Measure(Case, Working, 1, SolveSpecialized);
+				TotalIterations = 0;
+				const double CopySeconds = Measure(Case, Working, NumRounds, CopyOnly);
+				const double GenericSeconds = Measure(Case, Working, NumRounds, SolveGeneric) - CopySeconds;
+				const int64_t GenericIterations = TotalIterations;
+				const double SpecializedSeconds = Measure(Case, Working, NumRounds, SolveSpecialized) - CopySeconds;
+
+				const double NumSolves = double(NumChains) * double(NumRounds);
+				std::printf("%5d  %-9s  %-6s  %8.1f  %11.1f  %6.2fx  %16.2f\n", NumLinks, bStartFromTail ? "Tail" : "Root", bEnableRotationLimit ? "On" : "Off",
+					GenericSeconds * 1.e9 / NumSolves, SpecializedSeconds * 1.e9 / NumSolves, GenericSeconds / SpecializedSeconds, double(GenericIterations) / NumSolves);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+*	Random chains for the engine independent tests and benchmarks of CCDIKSolverCore. The same seed gives the same
+*	chains, up to the last bits of the C runtime's sin and cos, so do not check exact outputs against them.
+*/
+
+#include "BoneControllers/CCDIKSolverCore.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace CCDIKTest
+{
+	/** SoA storage behind one CCDIKSolverCore::FChainView */
+	struct FTestChain
+	{
+		std::vector<float> PosX, PosY, PosZ;
+		std::vector<float> RotX, RotY, RotZ, RotW;
+		std::vector<float> AngleDelta;
+		std::vector<float> RotationLimits;
+		std::vector<CCDIKSolverCore::FJointLimit> JointLimits;
+
+		explicit FTestChain(int32_t NumLinks = 0)
+		{
+			Resize(NumLinks);
+		}
+
+		void Resize(int32_t NumLinks)
+		{
+			for (std::vector<float>* Plane : { &PosX, &PosY, &PosZ, &RotX, &RotY, &RotZ, &RotW, &AngleDelta, &RotationLimits })
+			{
+				Plane->assign(NumLinks, 0.f);
+			}
+		}
+
+		int32_t Num() const { return (int32_t)PosX.size(); }
+
+		CCDIKSolverCore::FChainView GetView()
+		{
+			CCDIKSolverCore::FChainView View;
+			View.PosX = PosX.data();
+			View.PosY = PosY.data();
+			View.PosZ = PosZ.data();
+			View.RotX = RotX.data();
+			View.RotY = RotY.data();
+			View.RotZ = RotZ.data();
+			View.RotW = RotW.data();
+			View.AngleDelta = AngleDelta.data();
+			View.RotationLimits = RotationLimits.data();
+			View.JointLimits = JointLimits.empty() ? nullptr : JointLimits.data();
+			View.NumLinks = Num();
+			return View;
+		}
+	};
+
+	/** Uniform float in [Min, Max) from 24 random bits, so no library distribution is involved */
+	inline float RandRange(std::mt19937& Random, float Min, float Max)
+	{
+		return Min + (Max - Min) * float(Random() >> 8) * (1.f / 16777216.f);
+	}
+
+	/** Unit quaternion rotating by at most MaxAngle radians */
+	inline void RandRotation(std::mt19937& Random, float MaxAngle, float Out[4])
+	{
+		float Axis[3] = { RandRange(Random, -1.f, 1.f), RandRange(Random, -1.f, 1.f), RandRange(Random, -1.f, 1.f) };
+		float Length = std::sqrt(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+		if (Length < 1.e-3f)
+		{
+			Axis[0] = 1.f;
+			Length = 1.f;
+		}
+
+		const float HalfAngle = 0.5f * RandRange(Random, -MaxAngle, MaxAngle);
+		const float Sin = std::sin(HalfAngle) / Length;
+		Out[0] = Axis[0] * Sin;
+		Out[1] = Axis[1] * Sin;
+		Out[2] = Axis[2] * Sin;
+		Out[3] = std::cos(HalfAngle);
+	}
+
+	inline void MultiplyRotations(const float A[4], const float B[4], float Out[4])
+	{
+		const float X = A[3] * B[0] + A[0] * B[3] + A[1] * B[2] - A[2] * B[1];
+		const float Y = A[3] * B[1] - A[0] * B[2] + A[1] * B[3] + A[2] * B[0];
+		const float Z = A[3] * B[2] + A[0] * B[1] - A[1] * B[0] + A[2] * B[3];
+		const float W = A[3] * B[3] - A[0] * B[0] - A[1] * B[1] - A[2] * B[2];
+		Out[0] = X;
+		Out[1] = Y;
+		Out[2] = Z;
+		Out[3] = W;
+	}
+
+	inline void RotateVector(const float Q[4], const float V[3], float Out[3])
+	{
+		// v + 2w(q x v) + 2q x (q x v)
+		const float TX = 2.f * (Q[1] * V[2] - Q[2] * V[1]);
+		const float TY = 2.f * (Q[2] * V[0] - Q[0] * V[2]);
+		const float TZ = 2.f * (Q[0] * V[1] - Q[1] * V[0]);
+		Out[0] = V[0] + Q[3] * TX + (Q[1] * TZ - Q[2] * TY);
+		Out[1] = V[1] + Q[3] * TY + (Q[2] * TX - Q[0] * TZ);
+		Out[2] = V[2] + Q[3] * TZ + (Q[0] * TY - Q[1] * TX);
+	}
+
+	/**
+	*	Chain of NumLinks links along a random, bent path, each link offset from its parent along the parent's X axis.
+	*	With bJointLimits every link after the root gets a swing and twist limit around its initial local rotation.
+	*/
+	inline void MakeRandomChain(std::mt19937& Random, int32_t NumLinks, bool bJointLimits, FTestChain& OutChain)
+	{
+		OutChain.Resize(NumLinks);
+		OutChain.JointLimits.clear();
+
+		float Position[3] = { RandRange(Random, -100.f, 100.f), RandRange(Random, -100.f, 100.f), RandRange(Random, 0.f, 200.f) };
+		float Rotation[4];
+		RandRotation(Random, 3.14159265f, Rotation);
+		float ParentRotation[4] = { 0.f, 0.f, 0.f, 1.f };
+		for (int32_t Link = 0; Link < NumLinks; Link++)
+		{
+			if (Link > 0)
+			{
+				const float LocalOffset[3] = { RandRange(Random, 5.f, 40.f), 0.f, 0.f };
+				float Offset[3];
+				RotateVector(ParentRotation, LocalOffset, Offset);
+				Position[0] += Offset[0];
+				Position[1] += Offset[1];
+				Position[2] += Offset[2];
+
+				float Bend[4];
+				RandRotation(Random, 1.2f, Bend);
+				MultiplyRotations(ParentRotation, Bend, Rotation);
+			}
+
+			OutChain.PosX[Link] = Position[0];
+			OutChain.PosY[Link] = Position[1];
+			OutChain.PosZ[Link] = Position[2];
+			OutChain.RotX[Link] = Rotation[0];
+			OutChain.RotY[Link] = Rotation[1];
+			OutChain.RotZ[Link] = Rotation[2];
+			OutChain.RotW[Link] = Rotation[3];
+			OutChain.RotationLimits[Link] = RandRange(Random, 0.1f, 1.5f);
+
+			ParentRotation[0] = Rotation[0];
+			ParentRotation[1] = Rotation[1];
+			ParentRotation[2] = Rotation[2];
+			ParentRotation[3] = Rotation[3];
+		}
+
+		if (!bJointLimits)
+		{
+			return;
+		}
+
+		OutChain.JointLimits.resize(NumLinks);
+		for (int32_t Link = 1; Link < NumLinks; Link++)
+		{
+			// Reference is the local rotation the chain was built with, so the input pose is within its limits
+			const float InvParent[4] = { -OutChain.RotX[Link - 1], -OutChain.RotY[Link - 1], -OutChain.RotZ[Link - 1], OutChain.RotW[Link - 1] };
+			const float Current[4] = { OutChain.RotX[Link], OutChain.RotY[Link], OutChain.RotZ[Link], OutChain.RotW[Link] };
+			CCDIKSolverCore::FJointLimit& Limit = OutChain.JointLimits[Link];
+			MultiplyRotations(InvParent, Current, Limit.RefRotation);
+
+			const float HalfSwing = 0.5f * RandRange(Random, 0.3f, 1.5f);
+			const float HalfTwist = 0.5f * RandRange(Random, 0.1f, 1.f);
+			Limit.CosHalfSwingLimit = std::cos(HalfSwing);
+			Limit.SinHalfSwingLimit = std::sin(HalfSwing);
+			Limit.SinHalfMinTwist = -std::sin(HalfTwist);
+			Limit.SinHalfMaxTwist = std::sin(HalfTwist);
+		}
+	}
+
+	/** Effector within reach of the chain most of the time, sometimes beyond it */
+	inline void MakeRandomTarget(std::mt19937& Random, const FTestChain& Chain, float OutTarget[3])
+	{
+		const int32_t Tip = Chain.Num() - 1;
+		const float Reach = 0.6f * std::sqrt((Chain.PosX[Tip] - Chain.PosX[0]) * (Chain.PosX[Tip] - Chain.PosX[0])
+			+ (Chain.PosY[Tip] - Chain.PosY[0]) * (Chain.PosY[Tip] - Chain.PosY[0])
+			+ (Chain.PosZ[Tip] - Chain.PosZ[0]) * (Chain.PosZ[Tip] - Chain.PosZ[0])) + 1.f;
+		OutTarget[0] = Chain.PosX[Tip] + RandRange(Random, -Reach, Reach);
+		OutTarget[1] = Chain.PosY[Tip] + RandRange(Random, -Reach, Reach);
+		OutTarget[2] = Chain.PosZ[Tip] + RandRange(Random, -Reach, Reach);
+	}
+}